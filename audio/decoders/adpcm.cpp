@@ -46,14 +46,52 @@ ADPCMStream::ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Fl
 		_endpos(_startpos + size),
 		_channels(channels),
 		_blockAlign(blockAlign),
-		_rate(rate) {
+		_rate(rate),
+		_blockData(0),
+		_blockSamples(0) {
 
 	reset();
 }
 
+ADPCMStream::~ADPCMStream() {
+	free(_blockData);
+	free(_blockSamples);
+}
+
 void ADPCMStream::reset() {
 	memset(&_status, 0, sizeof(_status));
 	_blockPos[0] = _blockPos[1] = _blockAlign; // To make sure first header is read
+	_blockSampleCount = _blockSamplePos = 0;
+}
+
+int ADPCMStream::readBufferByBlock(int16 *buffer, const int numSamples) {
+	int samples = 0;
+
+	if (!_blockData) {
+		_blockData = (byte *)malloc(_blockAlign);
+		_blockSamples = (int16 *)malloc(_blockAlign * 2 * sizeof(int16));
+		assert(_blockData && _blockSamples);
+	}
+
+	while (samples < numSamples) {
+		if (_blockSamplePos == _blockSampleCount) {
+			if (_stream->eos() || _stream->pos() >= _endpos)
+				break;
+
+			uint32 size = _stream->read(_blockData, MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+			_blockSampleCount = decodeBlock(_blockData, size, _blockSamples);
+			_blockSamplePos = 0;
+			if (_blockSampleCount == 0)
+				break;
+		}
+
+		uint32 count = MIN<uint32>(numSamples - samples, _blockSampleCount - _blockSamplePos);
+		memcpy(buffer + samples, _blockSamples + _blockSamplePos, count * sizeof(int16));
+		_blockSamplePos += count;
+		samples += count;
+	}
+
+	return samples;
 }
 
 bool ADPCMStream::rewind() {
@@ -209,46 +247,29 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 #pragma mark -
 
 
-int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	// Need to write at least one sample per channel
-	assert((numSamples % _channels) == 0);
-
-	int samples = 0;
-
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			for (int i = 0; i < _channels; i++) {
-				// read block header
-				_status.ima_ch[i].last = _stream->readSint16LE();
-				_status.ima_ch[i].stepIndex = _stream->readSint16LE();
-			}
+uint32 MSIma_ADPCMStream::decodeBlock(const byte *src, uint32 size, int16 *dst) {
+	// Every block starts with a 4 byte header per channel
+	const uint32 headerSize = _channels * 4;
+	if (size < headerSize)
+		return 0;
 
-			_blockPos[0] = _channels * 4;
-		}
+	for (int i = 0; i < _channels; i++) {
+		_status.ima_ch[i].last = (int16)READ_LE_UINT16(src + i * 4);
+		_status.ima_ch[i].stepIndex = CLIP<int32>((int16)READ_LE_UINT16(src + i * 4 + 2), 0, ARRAYSIZE(_imaTable) - 1);
+	}
+	src += headerSize;
 
-		// Decode a set of samples
+	// The data encodes four bytes (eight samples) per channel at a time
+	const uint32 groups = (size - headerSize) / headerSize;
+	for (uint32 group = 0; group < groups; group++) {
 		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
-			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
-			}
-		}
-
-		while (samples < numSamples && _samplesLeft[0] != 0) {
-			for (int i = 0; i < _channels; i++) {
-				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
-				_samplesLeft[i]--;
-			}
-
-			samples += _channels;
+			decodeIMABlock(src, 4, dst + i, _channels, _status.ima_ch[i].last, _status.ima_ch[i].stepIndex);
+			src += 4;
 		}
+		dst += 8 * _channels;
 	}
 
-	return samples;
+	return groups * 8 * _channels;
 }
 
 
@@ -287,43 +308,40 @@ int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
 	return (int16)predictor;
 }
 
-int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-	int i = 0;
+uint32 MS_ADPCMStream::decodeBlock(const byte *src, uint32 size, int16 *dst) {
+	// Every block starts with a 7 byte header per channel
+	const uint32 headerSize = _channels * 7;
+	if (size < headerSize)
+		return 0;
 
-	samples = 0;
+	const byte *end = src + size;
+	uint32 samples = 0;
+	int i;
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			// read block header
-			for (i = 0; i < _channels; i++) {
-				_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
-				_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
-				_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
-			}
-
-			for (i = 0; i < _channels; i++)
-				_status.ch[i].delta = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++) {
+		_status.ch[i].predictor = CLIP(*src++, (byte)0, (byte)6);
+		_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
+		_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
+	}
 
-			for (i = 0; i < _channels; i++)
-				_status.ch[i].sample1 = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++, src += 2)
+		_status.ch[i].delta = (int16)READ_LE_UINT16(src);
 
-			for (i = 0; i < _channels; i++)
-				buffer[samples++] = _status.ch[i].sample2 = _stream->readSint16LE();
+	for (i = 0; i < _channels; i++, src += 2)
+		_status.ch[i].sample1 = (int16)READ_LE_UINT16(src);
 
-			for (i = 0; i < _channels; i++)
-				buffer[samples++] = _status.ch[i].sample1;
+	for (i = 0; i < _channels; i++, src += 2)
+		dst[samples++] = _status.ch[i].sample2 = (int16)READ_LE_UINT16(src);
 
-			_blockPos[0] = _channels * 7;
-		}
+	for (i = 0; i < _channels; i++)
+		dst[samples++] = _status.ch[i].sample1;
 
-		for (; samples < numSamples && _blockPos[0] < _blockAlign && !_stream->eos() && _stream->pos() < _endpos; samples += 2) {
-			data = _stream->readByte();
-			_blockPos[0]++;
-			buffer[samples] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
-			buffer[samples + 1] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
-		}
+	ADPCMChannelStatus *left = &_status.ch[0];
+	ADPCMChannelStatus *right = &_status.ch[_channels - 1];
+	while (src < end) {
+		byte data = *src++;
+		dst[samples++] = decodeMS(left, (data >> 4) & 0x0f);
+		dst[samples++] = decodeMS(right, data & 0x0f);
 	}
 
 	return samples;
@@ -421,15 +439,24 @@ const int16 Ima_ADPCMStream::_imaTable[89] = {
 };
 
 int16 Ima_ADPCMStream::decodeIMA(byte code, int channel) {
-	int32 E = (2 * (code & 0x7) + 1) * _imaTable[_status.ima_ch[channel].stepIndex] / 8;
-	int32 diff = (code & 0x08) ? -E : E;
-	int32 samp = CLIP<int32>(_status.ima_ch[channel].last + diff, -32768, 32767);
+	return decodeIMASample(code, _status.ima_ch[channel].last, _status.ima_ch[channel].stepIndex);
+}
 
-	_status.ima_ch[channel].last = samp;
-	_status.ima_ch[channel].stepIndex += _stepAdjustTable[code];
-	_status.ima_ch[channel].stepIndex = CLIP<int32>(_status.ima_ch[channel].stepIndex, 0, ARRAYSIZE(_imaTable) - 1);
+void Ima_ADPCMStream::decodeIMABlock(const byte *src, uint32 numBytes, int16 *dst, int dstStride, int32 &last, int32 &stepIndex) {
+	// Keep the decoder state in locals, so that it can stay in registers
+	int32 curLast = last;
+	int32 curStepIndex = stepIndex;
+
+	while (numBytes--) {
+		byte data = *src++;
+		*dst = decodeIMASample(data & 0x0f, curLast, curStepIndex);
+		dst += dstStride;
+		*dst = decodeIMASample((data >> 4) & 0x0f, curLast, curStepIndex);
+		dst += dstStride;
+	}
 
-	return samp;
+	last = curLast;
+	stepIndex = curStepIndex;
 }
 
 RewindableAudioStream *makeADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, typesADPCM type, int rate, int channels, uint32 blockAlign) {
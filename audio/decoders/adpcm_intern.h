@@ -36,6 +36,7 @@
 #include "common/ptr.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
+#include "common/util.h"
 
 namespace Audio {
 
@@ -57,10 +58,32 @@ protected:
 		} ima_ch[2];
 	} _status;
 
+	// Whole block decoding, used by the block based variants (MS and MS IMA)
+	byte *_blockData;
+	int16 *_blockSamples;
+	uint32 _blockSampleCount;
+	uint32 _blockSamplePos;
+
 	virtual void reset();
 
+	/**
+	 * Decode a complete block of the stream into dst, which has room for
+	 * 2 * _blockAlign samples. Returns the number of samples decoded.
+	 */
+	virtual uint32 decodeBlock(const byte *src, uint32 size, int16 *dst) { return 0; }
+
+	/**
+	 * readBuffer() implementation for the block based variants: reads and
+	 * decodes a whole block at a time with decodeBlock(), and hands out the
+	 * decoded samples from there.
+	 */
+	int readBufferByBlock(int16 *buffer, const int numSamples);
+
+	bool blockEndOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_blockSamplePos == _blockSampleCount); }
+
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
+	virtual ~ADPCMStream();
 
 	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos); }
 	virtual bool isStereo() const { return _channels == 2; }
@@ -103,6 +126,23 @@ public:
 	Ima_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
 		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {}
 
+	/**
+	 * Decode a single IMA ADPCM nibble, updating the given decoder state.
+	 */
+	static inline int16 decodeIMASample(byte code, int32 &last, int32 &stepIndex) {
+		int32 E = (2 * (code & 0x7) + 1) * _imaTable[stepIndex] / 8;
+		int32 diff = (code & 0x08) ? -E : E;
+		last = CLIP<int32>(last + diff, -32768, 32767);
+		stepIndex = CLIP<int32>(stepIndex + _stepAdjustTable[code], 0, ARRAYSIZE(_imaTable) - 1);
+		return last;
+	}
+
+	/**
+	 * Decode numBytes bytes of IMA ADPCM data of one channel, low nibble
+	 * first, writing every decoded sample dstStride samples apart.
+	 */
+	static void decodeIMABlock(const byte *src, uint32 numBytes, int16 *dst, int dstStride, int32 &last, int32 &stepIndex);
+
 	/**
 	 * This table is used by decodeIMA.
 	 */
@@ -162,21 +202,14 @@ public:
 		if (blockAlign % (_channels * 4))
 			error("MSIma_ADPCMStream(): invalid blockAlign");
 
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
 	}
 
-	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool endOfData() const { return blockEndOfData(); }
 
-	void reset() {
-		Ima_ADPCMStream::reset();
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
-	}
+	virtual int readBuffer(int16 *buffer, const int numSamples) { return readBufferByBlock(buffer, numSamples); }
 
-private:
-	int16 _buffer[2][8];
-	int _samplesLeft[2];
+protected:
+	virtual uint32 decodeBlock(const byte *src, uint32 size, int16 *dst);
 };
 
 class MS_ADPCMStream : public ADPCMStream {
@@ -208,10 +241,13 @@ public:
 		memset(&_status, 0, sizeof(_status));
 	}
 
-	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool endOfData() const { return blockEndOfData(); }
+
+	virtual int readBuffer(int16 *buffer, const int numSamples) { return readBufferByBlock(buffer, numSamples); }
 
 protected:
 	int16 decodeMS(ADPCMChannelStatus *c, byte);
+	virtual uint32 decodeBlock(const byte *src, uint32 size, int16 *dst);
 };
 
 // Duck DK3 IMA ADPCM Decoder
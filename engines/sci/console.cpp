@@ -109,6 +109,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	DCmd_Register("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	DCmd_Register("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	DCmd_Register("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
+	DCmd_Register("resource_prefetch",	WRAP_METHOD(Console, cmdResourcePrefetch));
 	DCmd_Register("list",				WRAP_METHOD(Console, cmdList));
 	DCmd_Register("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	DCmd_Register("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
@@ -138,6 +140,10 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("pi",                 WRAP_METHOD(Console, cmdPlaneItemList));	// alias
 	DCmd_Register("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	DCmd_Register("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	DCmd_Register("view_cache",         WRAP_METHOD(Console, cmdViewCache));
+	DCmd_Register("view_prefetch",      WRAP_METHOD(Console, cmdViewPrefetch));
+	DCmd_Register("picture_cache",      WRAP_METHOD(Console, cmdPictureCache));
+	DCmd_Register("picture_benchmark",  WRAP_METHOD(Console, cmdPictureBenchmark));
 	// Segments
 	DCmd_Register("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	DCmd_Register("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -349,6 +355,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	DebugPrintf(" resource_info - Shows info about a resource\n");
 	DebugPrintf(" resource_types - Shows the valid resource types\n");
+	DebugPrintf(" resource_cache - Shows resource load/cache statistics, or sets the resource memory limit\n");
+	DebugPrintf(" resource_prefetch - Enable/disable loading resources announced by scripts while idle\n");
 	DebugPrintf(" list - Lists all the resources of a given type\n");
 	DebugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	DebugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
@@ -376,6 +384,10 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" plane_items / pi - Shows a list of all items for a plane (SCI2+)\n");
 	DebugPrintf(" saved_bits - List saved bits on the hunk\n");
 	DebugPrintf(" show_saved_bits - Display saved bits\n");
+	DebugPrintf(" view_cache - Shows view/font cache statistics, or sets the view cache memory budget\n");
+	DebugPrintf(" view_prefetch - Enable/disable prefetching of views loaded by scripts\n");
+	DebugPrintf(" picture_cache - Shows picture cache statistics, or sets the picture cache memory budget (SCI0 - SCI1.1)\n");
+	DebugPrintf(" picture_benchmark - Measures drawing all pic resources with and without the picture cache (SCI0 - SCI1.1)\n");
 	DebugPrintf("\n");
 	DebugPrintf("Segments:\n");
 	DebugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -1105,6 +1117,56 @@ bool Console::cmdMapInstrument(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	if (argc > 2) {
+		DebugPrintf("Shows resource load and cache statistics, optionally sets the amount\n");
+		DebugPrintf("of memory unlocked resources may use before they get freed.\n");
+		DebugPrintf("Usage: %s [<memory limit in KB>]\n", argv[0]);
+		return true;
+	}
+
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2) {
+		resMan->setMaxMemory(atoi(argv[1]) * 1024);
+		resMan->resetStatistics();
+	}
+
+	DebugPrintf("Unlocked: %d resources, %d of %d KB used\n", resMan->getLRUCount(),
+			resMan->getMemoryLRU() / 1024, resMan->getMaxMemory() / 1024);
+	DebugPrintf("Locked: %d KB\n", resMan->getMemoryLocked() / 1024);
+	DebugPrintf("Prefetch queue: %d resources (prefetching %s)\n", resMan->getPrefetchQueueSize(),
+			resMan->isPrefetchingEnabled() ? "enabled" : "disabled");
+	DebugPrintf("\n");
+	DebugPrintf("Type          Hits  Misses  Prefetched      KB    ms\n");
+
+	for (int i = 0; i < kResourceTypeInvalid; i++) {
+		const ResourceTypeStatistics &stats = resMan->getStatistics((ResourceType)i);
+		if (!stats.hits && !stats.misses && !stats.prefetches)
+			continue;
+		DebugPrintf("%-12s %5d  %6d  %10d  %6d  %4d\n", getResourceTypeName((ResourceType)i),
+				stats.hits, stats.misses, stats.prefetches, stats.bytesLoaded / 1024, stats.loadTime);
+	}
+
+	return true;
+}
+
+bool Console::cmdResourcePrefetch(int argc, const char **argv) {
+	if (argc != 2) {
+		DebugPrintf("Enable/disable loading resources announced by scripts (via kLoad) while idle.\n");
+		DebugPrintf("Usage: %s <0/1>\n", argv[0]);
+		return true;
+	}
+
+	bool flag = atoi(argv[1]) ? true : false;
+	_engine->getResMan()->enablePrefetching(flag);
+	if (flag)
+		DebugPrintf("resource prefetching ENABLED\n");
+	else
+		DebugPrintf("resource prefetching DISABLED\n");
+	return true;
+}
+
 bool Console::cmdList(int argc, const char **argv) {
 	if (argc < 2) {
 		DebugPrintf("Lists all the resources of a given type\n");
@@ -1842,6 +1904,161 @@ bool Console::cmdShowSavedBits(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdViewCache(int argc, const char **argv) {
+	if (argc > 2) {
+		DebugPrintf("Shows view/font cache statistics, optionally sets the memory budget of the view cache.\n");
+		DebugPrintf("Usage: %s [<budget in KB>]\n", argv[0]);
+		return true;
+	}
+
+	GfxCache *cache = _engine->_gfxCache;
+	if (!cache) {
+		DebugPrintf("The graphics cache has not been initialized yet\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		cache->setViewMemoryBudget(atoi(argv[1]) * 1024);
+		cache->resetStatistics();
+	}
+
+	const CacheStatistics &viewStats = cache->getViewStatistics();
+	const CacheStatistics &fontStats = cache->getFontStatistics();
+
+	DebugPrintf("Views: %d cached, %d of %d KB used\n", cache->getViewCount(),
+			cache->getViewMemoryUsage() / 1024, cache->getViewMemoryBudget() / 1024);
+	DebugPrintf("  hits: %d, misses: %d, evictions: %d, prefetches: %d\n",
+			viewStats.hits, viewStats.misses, viewStats.evictions, viewStats.prefetches);
+	DebugPrintf("Fonts: %d cached, limit %d\n", cache->getFontCount(), MAX_CACHED_FONTS);
+	DebugPrintf("  hits: %d, misses: %d, evictions: %d\n",
+			fontStats.hits, fontStats.misses, fontStats.evictions);
+	return true;
+}
+
+bool Console::cmdViewPrefetch(int argc, const char **argv) {
+	if (argc != 2) {
+		DebugPrintf("Enable/disable prefetching of views which are loaded by the scripts.\n");
+		DebugPrintf("Usage: %s <0/1>\n", argv[0]);
+		return true;
+	}
+
+	GfxCache *cache = _engine->_gfxCache;
+	if (!cache) {
+		DebugPrintf("The graphics cache has not been initialized yet\n");
+		return true;
+	}
+
+	bool flag = atoi(argv[1]) ? true : false;
+	cache->enableViewPrefetching(flag);
+	if (flag)
+		DebugPrintf("view prefetching ENABLED\n");
+	else
+		DebugPrintf("view prefetching DISABLED\n");
+	return true;
+}
+
+bool Console::cmdPictureCache(int argc, const char **argv) {
+	if (argc > 2) {
+		DebugPrintf("Shows picture cache statistics, optionally sets the memory budget of the picture cache.\n");
+		DebugPrintf("Usage: %s [<budget in KB>]\n", argv[0]);
+		DebugPrintf("A budget of 0 disables the picture cache\n");
+		return true;
+	}
+
+	GfxPaint16 *paint16 = _engine->_gfxPaint16;
+	if (!paint16) {
+		DebugPrintf("The picture cache is only used by SCI0 - SCI1.1 games\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		paint16->setPictureCacheMemoryBudget(atoi(argv[1]) * 1024);
+		paint16->resetPictureCacheStatistics();
+	}
+
+	const CacheStatistics &stats = paint16->getPictureCacheStatistics();
+
+	DebugPrintf("Pictures: %d cached, %d of %d KB used\n", paint16->getPictureCacheCount(),
+			paint16->getPictureCacheMemoryUsage() / 1024, paint16->getPictureCacheMemoryBudget() / 1024);
+	DebugPrintf("  hits: %d, misses: %d, evictions: %d\n", stats.hits, stats.misses, stats.evictions);
+	return true;
+}
+
+bool Console::cmdPictureBenchmark(int argc, const char **argv) {
+	if (argc > 2) {
+		DebugPrintf("Draws all pic resources with and without the picture cache and shows the time it took.\n");
+		DebugPrintf("Usage: %s [<repetitions>]\n", argv[0]);
+		DebugPrintf("Note that this changes the current palette\n");
+		return true;
+	}
+
+	GfxPaint16 *paint16 = _engine->_gfxPaint16;
+	if (!paint16) {
+		DebugPrintf("The picture cache is only used by SCI0 - SCI1.1 games\n");
+		return true;
+	}
+
+	int repetitions = (argc == 2) ? atoi(argv[1]) : 3;
+	if (repetitions < 1)
+		repetitions = 1;
+
+	Common::List<ResourceId> resources = _engine->getResMan()->listResources(kResourceTypePic);
+	Common::List<ResourceId>::iterator itr;
+	if (resources.empty()) {
+		DebugPrintf("No pic resources found\n");
+		return true;
+	}
+
+	GfxScreen *screen = _engine->_gfxScreen;
+	GfxPorts *ports = _engine->_gfxPorts;
+	Common::Rect screenRect(screen->getWidth(), screen->getHeight());
+	byte *screenBits = new byte[screen->bitsGetDataSize(screenRect, GFX_SCREEN_MASK_ALL)];
+	screen->bitsSave(screenRect, GFX_SCREEN_MASK_ALL, screenBits);
+	Port *oldPort = ports->setPort((Port *)ports->_picWind);
+	uint32 oldBudget = paint16->getPictureCacheMemoryBudget();
+	uint32 startTime;
+	int i;
+
+	// Without cache
+	paint16->setPictureCacheMemoryBudget(0);
+	startTime = g_system->getMillis();
+	for (i = 0; i < repetitions; i++) {
+		for (itr = resources.begin(); itr != resources.end(); ++itr)
+			paint16->drawPicture(itr->getNumber(), 100, false, false, 0);
+	}
+	uint32 uncachedTime = g_system->getMillis() - startTime;
+
+	// With cache, using a budget that fits all pictures
+	paint16->setPictureCacheMemoryBudget(resources.size() * screen->bitsGetDataSize(screenRect, GFX_SCREEN_MASK_ALL) * 2);
+	paint16->resetPictureCacheStatistics();
+	startTime = g_system->getMillis();
+	for (itr = resources.begin(); itr != resources.end(); ++itr)
+		paint16->drawPicture(itr->getNumber(), 100, false, false, 0);
+	uint32 fillTime = g_system->getMillis() - startTime;
+	startTime = g_system->getMillis();
+	for (i = 0; i < repetitions; i++) {
+		for (itr = resources.begin(); itr != resources.end(); ++itr)
+			paint16->drawPicture(itr->getNumber(), 100, false, false, 0);
+	}
+	uint32 cachedTime = g_system->getMillis() - startTime;
+	const CacheStatistics &stats = paint16->getPictureCacheStatistics();
+	uint32 hits = stats.hits;
+
+	paint16->purgePictureCache();
+	paint16->setPictureCacheMemoryBudget(oldBudget);
+	paint16->resetPictureCacheStatistics();
+	ports->setPort(oldPort);
+	screen->bitsRestore(screenBits);
+	screen->copyToScreen();
+	delete[] screenBits;
+
+	uint32 drawCount = resources.size() * repetitions;
+	DebugPrintf("%d pictures, %d repetitions\n", resources.size(), repetitions);
+	DebugPrintf("  uncached: %d ms (%d us per picture)\n", uncachedTime, uncachedTime * 1000 / drawCount);
+	DebugPrintf("  filling the cache: %d ms (%d us per picture)\n", fillTime, fillTime * 1000 / resources.size());
+	DebugPrintf("  cached: %d ms (%d us per picture), %d hits\n", cachedTime, cachedTime * 1000 / drawCount, hits);
+	return true;
+}
 
 bool Console::cmdParseGrammar(int argc, const char **argv) {
 	DebugPrintf("Parse grammar, in strict GNF:\n");
@@ -27,6 +27,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/graphics/cache.h"
 
 #include "common/file.h"
 
@@ -42,6 +43,15 @@ reg_t kLoad(EngineState *s, int argc, reg_t *argv) {
 	if (restype == kResourceTypeMemory)
 		return s->_segMan->allocateHunkEntry("kLoad()", resnr);
 
+	// Scripts load resources before they get used, so queue them to be
+	// loaded in advance while the engine is idle
+	g_sci->getResMan()->queuePrefetch(ResourceId(restype, resnr));
+
+	// This is also a good place to warm up the view cache (if view
+	// prefetching is enabled)
+	if (restype == kResourceTypeView && g_sci->_gfxCache)
+		g_sci->_gfxCache->prefetchView(resnr);
+
 	return make_reg(0, ((restype << 11) | resnr)); // Return the resource identifier as handle
 }
 
@@ -210,8 +210,11 @@ reg_t kDoAudio(EngineState *s, int argc, reg_t *argv) {
 
 			debugC(kDebugLevelSound, "kDoAudio: set language to %d", language);
 
-			if (language != -1)
+			if (language != -1) {
 				g_sci->getResMan()->setAudioLanguage(language);
+				// The cached samples belong to the previous language
+				g_sci->_audio->purgeAudioCache();
+			}
 
 			kLanguage kLang = g_sci->getSciLanguage();
 			g_sci->setSciLanguage(kLang);
@@ -304,6 +307,8 @@ reg_t kSetLanguage(EngineState *s, int argc, reg_t *argv) {
 	Common::String audioDirectory = s->_segMan->getString(argv[0]);
 	//warning("SetLanguage: set audio resource directory to '%s'", audioDirectory.c_str());
 	g_sci->getResMan()->changeAudioDirectory(audioDirectory);
+	// The cached samples belong to the previous audio directory
+	g_sci->_audio->purgeAudioCache();
 
 	return s->r_acc;
 }
@@ -27,6 +27,7 @@
 #include "sci/sci.h"
 #include "sci/event.h"
 #include "sci/console.h"
+#include "sci/resource.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/graphics/screen.h"
@@ -327,7 +328,9 @@ void SciEngine::sleep(uint32 msecs) {
 		_eventMan->getSciEvent(SCI_EVENT_PEEK);
 		time = g_system->getMillis();
 		if (time + 10 < wakeup_time) {
-			g_system->delayMillis(10);
+			// Use the idle time to load resources the scripts announced
+			if (!_resMan->processPrefetchQueue(wakeup_time - 10))
+				g_system->delayMillis(10);
 		} else {
 			if (time < wakeup_time)
 				g_system->delayMillis(wakeup_time - time);
@@ -35,7 +35,9 @@
 namespace Sci {
 
 GfxCache::GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette)
-	: _resMan(resMan), _screen(screen), _palette(palette) {
+	: _resMan(resMan), _screen(screen), _palette(palette),
+	  _viewMemoryBudget(MAX_CACHED_VIEW_MEMORY), _viewPrefetching(false) {
+	resetStatistics();
 }
 
 GfxCache::~GfxCache() {
@@ -45,45 +47,148 @@ GfxCache::~GfxCache() {
 
 void GfxCache::purgeFontCache() {
 	for (FontCache::iterator iter = _cachedFonts.begin(); iter != _cachedFonts.end(); ++iter) {
-		delete iter->_value;
-		iter->_value = 0;
+		delete iter->_value.font;
+		iter->_value.font = 0;
 	}
 
 	_cachedFonts.clear();
+	_fontLRU.clear();
 }
 
 void GfxCache::purgeViewCache() {
 	for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
-		delete iter->_value;
-		iter->_value = 0;
+		delete iter->_value.view;
+		iter->_value.view = 0;
 	}
 
 	_cachedViews.clear();
+	_viewLRU.clear();
+}
+
+void GfxCache::resetStatistics() {
+	memset(&_fontStats, 0, sizeof(_fontStats));
+	memset(&_viewStats, 0, sizeof(_viewStats));
+}
+
+// Evicts least recently used fonts until at most maxCount are left
+void GfxCache::evictFonts(uint maxCount) {
+	while (_cachedFonts.size() > maxCount) {
+		GuiResourceId fontId = _fontLRU.back();
+		_fontLRU.pop_back();
+		delete _cachedFonts[fontId].font;
+		_cachedFonts.erase(fontId);
+		_fontStats.evictions++;
+	}
+}
+
+uint32 GfxCache::getViewMemoryUsage() const {
+	// Views grow when cels get unpacked, so we sum them up on demand instead
+	// of keeping a running total
+	uint32 usage = 0;
+	for (ViewCache::const_iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter)
+		usage += iter->_value.view->getMemorySize();
+	return usage;
+}
+
+// Evicts least recently used views until they take up at most maxMemory
+// bytes. The most recently used view is never evicted, as the caller may
+// still be holding a pointer to it.
+void GfxCache::evictViews(uint32 maxMemory) {
+	uint32 usage = getViewMemoryUsage();
+
+	while (usage > maxMemory && _cachedViews.size() > 1) {
+		GuiResourceId viewId = _viewLRU.back();
+		_viewLRU.pop_back();
+		GfxView *view = _cachedViews[viewId].view;
+		usage -= view->getMemorySize();
+		delete view;
+		_cachedViews.erase(viewId);
+		_viewStats.evictions++;
+	}
+}
+
+void GfxCache::setViewMemoryBudget(uint32 budget) {
+	_viewMemoryBudget = budget;
+	evictViews(_viewMemoryBudget);
 }
 
 GfxFont *GfxCache::getFont(GuiResourceId fontId) {
-	if (_cachedFonts.size() >= MAX_CACHED_FONTS)
-		purgeFontCache();
-
-	if (!_cachedFonts.contains(fontId)) {
-		// Create special SJIS font in japanese games, when font 900 is selected
-		if ((fontId == 900) && (g_sci->getLanguage() == Common::JA_JPN))
-			_cachedFonts[fontId] = new GfxFontSjis(_screen, fontId);
-		else
-			_cachedFonts[fontId] = new GfxFontFromResource(_resMan, _screen, fontId);
+	FontCache::iterator iter = _cachedFonts.find(fontId);
+	if (iter != _cachedFonts.end()) {
+		_fontStats.hits++;
+		_fontLRU.erase(iter->_value.lruPos);
+		_fontLRU.push_front(fontId);
+		iter->_value.lruPos = _fontLRU.begin();
+		return iter->_value.font;
 	}
 
-	return _cachedFonts[fontId];
+	_fontStats.misses++;
+	evictFonts(MAX_CACHED_FONTS - 1);
+
+	FontCacheEntry entry;
+	// Create special SJIS font in japanese games, when font 900 is selected
+	if ((fontId == 900) && (g_sci->getLanguage() == Common::JA_JPN))
+		entry.font = new GfxFontSjis(_screen, fontId);
+	else
+		entry.font = new GfxFontFromResource(_resMan, _screen, fontId);
+	_fontLRU.push_front(fontId);
+	entry.lruPos = _fontLRU.begin();
+	_cachedFonts[fontId] = entry;
+
+	return entry.font;
 }
 
 GfxView *GfxCache::getView(GuiResourceId viewId) {
-	if (_cachedViews.size() >= MAX_CACHED_VIEWS)
-		purgeViewCache();
+	ViewCache::iterator iter = _cachedViews.find(viewId);
+	if (iter != _cachedViews.end()) {
+		_viewStats.hits++;
+		_viewLRU.erase(iter->_value.lruPos);
+		_viewLRU.push_front(viewId);
+		iter->_value.lruPos = _viewLRU.begin();
+		return iter->_value.view;
+	}
 
-	if (!_cachedViews.contains(viewId))
-		_cachedViews[viewId] = new GfxView(_resMan, _screen, _palette, viewId);
+	_viewStats.misses++;
 
-	return _cachedViews[viewId];
+	ViewCacheEntry entry;
+	entry.view = new GfxView(_resMan, _screen, _palette, viewId);
+	_viewLRU.push_front(viewId);
+	entry.lruPos = _viewLRU.begin();
+	_cachedViews[viewId] = entry;
+
+	evictViews(_viewMemoryBudget);
+
+	return entry.view;
+}
+
+void GfxCache::prefetchView(GuiResourceId viewId) {
+	if (!_viewPrefetching || _cachedViews.contains(viewId))
+		return;
+	if (!_resMan->testResource(ResourceId(kResourceTypeView, viewId)))
+		return;
+
+	_viewStats.prefetches++;
+
+	ViewCacheEntry entry;
+	entry.view = new GfxView(_resMan, _screen, _palette, viewId);
+	_viewLRU.push_front(viewId);
+	entry.lruPos = _viewLRU.begin();
+	_cachedViews[viewId] = entry;
+
+	evictViews(_viewMemoryBudget);
+
+	GfxView *view = entry.view;
+	uint32 usage = getViewMemoryUsage();
+	for (int16 loopNo = 0; loopNo < view->getLoopCount(); loopNo++) {
+		for (int16 celNo = 0; celNo < view->getCelCount(loopNo); celNo++) {
+			// Don't unpack more than what fits into the budget
+			if (usage >= _viewMemoryBudget)
+				return;
+			uint32 oldSize = view->getMemorySize();
+			view->getBitmap(loopNo, celNo);
+			usage += view->getMemorySize() - oldSize;
+		}
+	}
 }
 
 int16 GfxCache::kernelViewGetCelWidth(GuiResourceId viewId, int16 loopNo, int16 celNo) {
@@ -24,17 +24,45 @@
 #define SCI_GRAPHICS_CACHE_H
 
 #include "common/hashmap.h"
+#include "common/list.h"
 
 namespace Sci {
 
 class GfxFont;
 class GfxView;
 
-typedef Common::HashMap<int, GfxFont *> FontCache;
-typedef Common::HashMap<int, GfxView *> ViewCache;
+/**
+ * Least recently used order of the cached objects, most recently used first.
+ * Every cache entry remembers its position inside this list, so that it can
+ * be moved to the front (or removed) without having to search for it.
+ */
+typedef Common::List<GuiResourceId> CacheLRUList;
+
+struct FontCacheEntry {
+	GfxFont *font;
+	CacheLRUList::iterator lruPos;
+};
+
+struct ViewCacheEntry {
+	GfxView *view;
+	CacheLRUList::iterator lruPos;
+};
+
+typedef Common::HashMap<int, FontCacheEntry> FontCache;
+typedef Common::HashMap<int, ViewCacheEntry> ViewCache;
+
+struct CacheStatistics {
+	uint32 hits;
+	uint32 misses;
+	uint32 evictions;
+	uint32 prefetches;
+};
 
 /**
  * Cache class, handles caching of views/fonts
+ *  Fonts are limited by count, views by the amount of memory they use
+ *  (resource data plus unpacked cel bitmaps). When a limit is reached, the
+ *  least recently used entries are evicted one by one.
  */
 class GfxCache {
 public:
@@ -51,9 +79,31 @@ public:
 
 	byte kernelViewGetColorAtCoordinate(GuiResourceId viewId, int16 loopNo, int16 celNo, int16 x, int16 y);
 
+	/**
+	 * Loads a view and unpacks all of its cels ahead of time, so that
+	 * drawing it later on doesn't need to do this. Called when scripts
+	 * announce a view via kLoad, if prefetching is enabled.
+	 */
+	void prefetchView(GuiResourceId viewId);
+
+	void enableViewPrefetching(bool enable) { _viewPrefetching = enable; }
+	bool isViewPrefetchingEnabled() const { return _viewPrefetching; }
+
+	void setViewMemoryBudget(uint32 budget);
+	uint32 getViewMemoryBudget() const { return _viewMemoryBudget; }
+	uint32 getViewMemoryUsage() const;
+	uint getViewCount() const { return _cachedViews.size(); }
+	uint getFontCount() const { return _cachedFonts.size(); }
+
+	const CacheStatistics &getViewStatistics() const { return _viewStats; }
+	const CacheStatistics &getFontStatistics() const { return _fontStats; }
+	void resetStatistics();
+
 private:
 	void purgeFontCache();
 	void purgeViewCache();
+	void evictFonts(uint maxCount);
+	void evictViews(uint32 maxMemory);
 
 	ResourceManager *_resMan;
 	GfxScreen *_screen;
@@ -61,6 +111,14 @@ private:
 
 	FontCache _cachedFonts;
 	ViewCache _cachedViews;
+	CacheLRUList _fontLRU;
+	CacheLRUList _viewLRU;
+
+	uint32 _viewMemoryBudget;
+	bool _viewPrefetching;
+
+	CacheStatistics _fontStats;
+	CacheStatistics _viewStats;
 };
 
 } // End of namespace Sci
@@ -22,6 +22,7 @@
 
 #include "common/algorithm.h"
 #include "common/events.h"
+#include "common/hashmap.h"
 #include "common/keyboard.h"
 #include "common/list_intern.h"
 #include "common/str.h"
@@ -65,10 +66,13 @@ GfxFrameout::GfxFrameout(SegManager *segMan, ResourceManager *resMan, GfxCoordAd
 	_curScrollText = -1;
 	_showScrollText = false;
 	_maxScrollTexts = 0;
+	_lastScreen = new byte[_screen->getDisplayWidth() * _screen->getDisplayHeight()];
+	_fullRedraw = true;
 }
 
 GfxFrameout::~GfxFrameout() {
 	clear();
+	delete[] _lastScreen;
 }
 
 void GfxFrameout::clear() {
@@ -76,6 +80,8 @@ void GfxFrameout::clear() {
 	_planes.clear();
 	deletePlanePictures(NULL_REG);
 	clearScrollTexts();
+	_lastDrawList.clear();
+	_fullRedraw = true;
 }
 
 void GfxFrameout::clearScrollTexts() {
@@ -511,6 +517,9 @@ void GfxFrameout::showVideo() {
 
 		g_system->delayMillis(10);
 	}
+
+	// The video has overwritten the screen
+	_fullRedraw = true;
 }
 
 void GfxFrameout::createPlaneItemList(reg_t planeObject, FrameoutList &itemList) {
@@ -578,31 +587,207 @@ bool GfxFrameout::isPictureOutOfView(FrameoutEntry *itemEntry, Common::Rect plan
 	return false;
 }
 
-void GfxFrameout::drawPicture(FrameoutEntry *itemEntry, int16 planeOffsetX, int16 planeOffsetY, bool planePictureMirrored) {
-	int16 pictureOffsetX = planeOffsetX;
+void GfxFrameout::addPictureDrawEntry(FrameoutDrawList &drawList, FrameoutEntry *itemEntry, const PlaneEntry &plane) {
+	int16 pictureOffsetX = plane.planeOffsetX;
 	int16 pictureX = itemEntry->x;
-	if ((planeOffsetX) || (itemEntry->picStartX)) {
-		if (planeOffsetX <= itemEntry->picStartX) {
-			pictureX += itemEntry->picStartX - planeOffsetX;
+	if ((plane.planeOffsetX) || (itemEntry->picStartX)) {
+		if (plane.planeOffsetX <= itemEntry->picStartX) {
+			pictureX += itemEntry->picStartX - plane.planeOffsetX;
 			pictureOffsetX = 0;
 		} else {
-			pictureOffsetX = planeOffsetX - itemEntry->picStartX;
+			pictureOffsetX = plane.planeOffsetX - itemEntry->picStartX;
 		}
 	}
 
-	int16 pictureOffsetY = planeOffsetY;
-	int16 pictureY = itemEntry->y;
-	if ((planeOffsetY) || (itemEntry->picStartY)) {
-		if (planeOffsetY <= itemEntry->picStartY) {
-			pictureY += itemEntry->picStartY - planeOffsetY;
+	int16 pictureOffsetY = plane.planeOffsetY;
+	if ((plane.planeOffsetY) || (itemEntry->picStartY)) {
+		if (plane.planeOffsetY <= itemEntry->picStartY) {
 			pictureOffsetY = 0;
 		} else {
-			pictureOffsetY = planeOffsetY - itemEntry->picStartY;
+			pictureOffsetY = plane.planeOffsetY - itemEntry->picStartY;
+		}
+	}
+
+	FrameoutDrawEntry entry = FrameoutDrawEntry();
+	entry.type = kFrameoutDrawPicture;
+	entry.object = plane.object;
+	entry.planePriority = plane.priority;
+	// Picture cels are only drawn within the plane
+	entry.rect = plane.planeRect;
+	entry.picture = itemEntry->picture;
+	entry.pictureId = itemEntry->picture->getResourceId();
+	entry.celNo = itemEntry->celNo;
+	entry.drawX = pictureX;
+	entry.drawY = itemEntry->y;
+	entry.pictureX = pictureOffsetX;
+	entry.pictureY = pictureOffsetY;
+	entry.mirrored = plane.planePictureMirrored;
+	entry.planeRect = plane.planeRect;
+	drawList.push_back(entry);
+}
+
+static void addDamage(Common::Rect &damagedRect, const Common::Rect &rect) {
+	if (rect.isEmpty())
+		return;
+	if (damagedRect.isEmpty())
+		damagedRect = rect;
+	else
+		damagedRect.extend(rect);
+}
+
+static uint32 getDrawEntryKey(const FrameoutDrawEntry &entry) {
+	uint32 key = ((uint32)entry.object.getSegment() << 16) | entry.object.getOffset();
+	key = key * 31 + entry.type;
+	key = key * 31 + (uint16)entry.pictureId;
+	key = key * 31 + (uint16)entry.celNo;
+	return key;
+}
+
+static bool isSameDrawing(const FrameoutDrawEntry &entry1, const FrameoutDrawEntry &entry2) {
+	if (entry1.type != entry2.type || entry1.object != entry2.object ||
+		entry1.planePriority != entry2.planePriority || entry1.rect != entry2.rect)
+		return false;
+
+	switch (entry1.type) {
+	case kFrameoutDrawLine:
+		return entry1.startPoint == entry2.startPoint && entry1.endPoint == entry2.endPoint &&
+			entry1.color == entry2.color && entry1.priority == entry2.priority && entry1.control == entry2.control;
+	case kFrameoutDrawFill:
+		return entry1.color == entry2.color;
+	case kFrameoutDrawPicture:
+		return entry1.pictureId == entry2.pictureId && entry1.celNo == entry2.celNo &&
+			entry1.drawX == entry2.drawX && entry1.drawY == entry2.drawY &&
+			entry1.pictureX == entry2.pictureX && entry1.pictureY == entry2.pictureY &&
+			entry1.mirrored == entry2.mirrored;
+	case kFrameoutDrawView:
+		return entry1.viewId == entry2.viewId && entry1.loopNo == entry2.loopNo && entry1.celNo == entry2.celNo &&
+			entry1.scaleX == entry2.scaleX && entry1.scaleY == entry2.scaleY &&
+			entry1.itemPriority == entry2.itemPriority && entry1.givenOrderNr == entry2.givenOrderNr &&
+			entry1.celRect == entry2.celRect && entry1.clipRect == entry2.clipRect &&
+			entry1.translatedClipRect == entry2.translatedClipRect && entry1.hires == entry2.hires;
+	case kFrameoutDrawText:
+		return entry1.x == entry2.x && entry1.y == entry2.y && entry1.planeRect == entry2.planeRect &&
+			entry1.checksum == entry2.checksum;
+	}
+
+	return false;
+}
+
+// Compares the drawing operations of this frame with the ones of the last
+// frame, and returns the screen area, which is affected by the differences
+Common::Rect GfxFrameout::getDamagedRect(const FrameoutDrawList &drawList) {
+	Common::Rect damagedRect;
+	Common::HashMap<uint32, uint> lastEntries;
+	Common::Array<bool> lastEntryUsed;
+
+	lastEntryUsed.resize(_lastDrawList.size());
+	for (uint i = 0; i < _lastDrawList.size(); i++) {
+		lastEntryUsed[i] = false;
+		lastEntries.setVal(getDrawEntryKey(_lastDrawList[i]), i);
+	}
+
+	for (uint i = 0; i < drawList.size(); i++) {
+		const FrameoutDrawEntry &entry = drawList[i];
+		Common::HashMap<uint32, uint>::const_iterator lastEntry = lastEntries.find(getDrawEntryKey(entry));
+
+		if (lastEntry != lastEntries.end() && !lastEntryUsed[lastEntry->_value]) {
+			lastEntryUsed[lastEntry->_value] = true;
+			if (isSameDrawing(entry, _lastDrawList[lastEntry->_value]))
+				continue;
+			addDamage(damagedRect, _lastDrawList[lastEntry->_value].rect);
 		}
+		addDamage(damagedRect, entry.rect);
+	}
+
+	// Whatever got removed needs to be redrawn as well
+	for (uint i = 0; i < _lastDrawList.size(); i++) {
+		if (!lastEntryUsed[i])
+			addDamage(damagedRect, _lastDrawList[i].rect);
+	}
+
+	return damagedRect;
+}
+
+// Compares the screen with its contents after the last frame, and returns the
+// area that differs. This catches everything that got drawn to the screen
+// outside of kernelFrameout().
+Common::Rect GfxFrameout::getChangedScreenRect() {
+	const byte *screen = _screen->getActiveScreen();
+	const int16 width = _screen->getDisplayWidth();
+	const int16 height = _screen->getDisplayHeight();
+	Common::Rect changedRect;
+
+	for (int16 y = 0; y < height; y++) {
+		const byte *screenLine = screen + y * width;
+		const byte *lastScreenLine = _lastScreen + y * width;
+
+		if (!memcmp(screenLine, lastScreenLine, width))
+			continue;
+
+		int16 left = 0;
+		while (screenLine[left] == lastScreenLine[left])
+			left++;
+		int16 right = width;
+		while (screenLine[right - 1] == lastScreenLine[right - 1])
+			right--;
+
+		addDamage(changedRect, Common::Rect(left, y, right, y + 1));
+	}
+
+	return changedRect;
+}
+
+/**
+ * Merges the embedded palette of a view entry in, like GfxView::draw() does.
+ * Used for views which are not redrawn, so that the picture palette that gets
+ * set every frame does not override their colors.
+ */
+void GfxFrameout::mergeViewPalette(const FrameoutDrawEntry &entry) {
+	Palette *viewPalette = _cache->getView(entry.viewId)->getPalette();
+	if (viewPalette)
+		_palette->set(viewPalette, false);
+}
+
+void GfxFrameout::drawEntry(const FrameoutDrawEntry &entry, const Common::Rect &damagedRect) {
+	switch (entry.type) {
+	case kFrameoutDrawLine:
+		_screen->drawLine(entry.startPoint, entry.endPoint, entry.color, entry.priority, entry.control);
+		break;
+	case kFrameoutDrawFill: {
+		Common::Rect fillRect = entry.rect;
+		fillRect.clip(damagedRect);
+		_paint32->fillRect(fillRect, entry.color);
+		break;
 	}
+	case kFrameoutDrawPicture:
+		_coordAdjuster->pictureSetDisplayArea(entry.planeRect);
+		entry.picture->drawSci32Vga(entry.celNo, entry.drawX, entry.drawY, entry.pictureX, entry.pictureY, entry.mirrored, damagedRect);
+		break;
+	case kFrameoutDrawView: {
+		GfxView *view = _cache->getView(entry.viewId);
+		Common::Rect translatedClipRect = entry.translatedClipRect;
+		translatedClipRect.clip(damagedRect);
+		if (translatedClipRect.isEmpty()) {
+			mergeViewPalette(entry);
+			break;
+		}
 
-	itemEntry->picture->drawSci32Vga(itemEntry->celNo, pictureX, itemEntry->y, pictureOffsetX, pictureOffsetY, planePictureMirrored);
-	//	warning("picture cel %d %d", itemEntry->celNo, itemEntry->priority);
+		// Clip the untranslated rect by the same amount
+		Common::Rect clipRect = translatedClipRect;
+		clipRect.translate(entry.clipRect.left - entry.translatedClipRect.left, entry.clipRect.top - entry.translatedClipRect.top);
+
+		if ((entry.scaleX == 128) && (entry.scaleY == 128))
+			view->draw(entry.celRect, clipRect, translatedClipRect,
+				entry.loopNo, entry.celNo, 255, 0, entry.hires);
+		else
+			view->drawScaled(entry.celRect, clipRect, translatedClipRect,
+				entry.loopNo, entry.celNo, 255, entry.scaleX, entry.scaleY);
+		break;
+	}
+	case kFrameoutDrawText:
+		g_sci->_gfxText32->drawTextBitmap(entry.x, entry.y, entry.planeRect, entry.object);
+		break;
+	}
 }
 
 void GfxFrameout::kernelFrameout() {
@@ -613,9 +798,19 @@ void GfxFrameout::kernelFrameout() {
 
 	_palette->palVaryUpdate();
 
+	const Common::Rect screenRect(_screen->getDisplayWidth(), _screen->getDisplayHeight());
+	FrameoutDrawList drawList;
+
+	// First pass: update all planes and screen items and collect what needs to
+	// be drawn. Nothing gets drawn here, so that we are able to figure out
+	// which parts of the screen actually changed since the last frame.
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
 		reg_t planeObject = it->object;
 
+		FrameoutDrawEntry newEntry = FrameoutDrawEntry();
+		newEntry.object = planeObject;
+		newEntry.planePriority = it->priority;
+
 		// Draw any plane lines, if they exist
 		// These are drawn on invisible planes as well. (e.g. "invisiblePlane" in LSL6 hires)
 		// FIXME: Lines aren't always drawn (e.g. when the narrator speaks in LSL6 hires).
@@ -625,7 +820,17 @@ void GfxFrameout::kernelFrameout() {
 			Common::Point endPoint = it2->endPoint;
 			_coordAdjuster->kernelLocalToGlobal(startPoint.x, startPoint.y, it->object);
 			_coordAdjuster->kernelLocalToGlobal(endPoint.x, endPoint.y, it->object);
-			_screen->drawLine(startPoint, endPoint, it2->color, it2->priority, it2->control);
+
+			newEntry.type = kFrameoutDrawLine;
+			newEntry.startPoint = startPoint;
+			newEntry.endPoint = endPoint;
+			newEntry.color = it2->color;
+			newEntry.priority = it2->priority;
+			newEntry.control = it2->control;
+			newEntry.rect = Common::Rect(MIN(startPoint.x, endPoint.x), MIN(startPoint.y, endPoint.y),
+				MAX(startPoint.x, endPoint.x) + 1, MAX(startPoint.y, endPoint.y) + 1);
+			newEntry.rect.clip(screenRect);
+			drawList.push_back(newEntry);
 		}
 
 		int16 planeLastPriority = it->lastPriority;
@@ -636,17 +841,27 @@ void GfxFrameout::kernelFrameout() {
 		it->lastPriority = planePriority;
 		if (planePriority < 0) { // Plane currently not meant to be shown
 			// If plane was shown before, delete plane rect
-			if (planePriority != planeLastPriority)
-				_paint32->fillRect(it->planeRect, 0);
+			if (planePriority != planeLastPriority) {
+				newEntry.type = kFrameoutDrawFill;
+				newEntry.rect = it->planeRect;
+				newEntry.color = 0;
+				drawList.push_back(newEntry);
+			}
 			continue;
 		}
 
+		newEntry.planePriority = planePriority;
+
 		// There is a race condition lurking in SQ6, which causes the game to hang in the intro, when teleporting to Polysorbate LX.
 		// Since I first wrote the patch, the race has stopped occurring for me though.
 		// I'll leave this for investigation later, when someone can reproduce.
 		//if (it->pictureId == kPlanePlainColored)	// FIXME: This is what SSCI does, and fixes the intro of LSL7, but breaks the dialogs in GK1 (adds black boxes)
-		if (it->pictureId == kPlanePlainColored && (it->planeBack || g_sci->getGameId() != GID_GK1))
-			_paint32->fillRect(it->planeRect, it->planeBack);
+		if (it->pictureId == kPlanePlainColored && (it->planeBack || g_sci->getGameId() != GID_GK1)) {
+			newEntry.type = kFrameoutDrawFill;
+			newEntry.rect = it->planeRect;
+			newEntry.color = it->planeBack;
+			drawList.push_back(newEntry);
+		}
 
 		_coordAdjuster->pictureSetDisplayArea(it->planeRect);
 		_palette->drewPicture(it->pictureId);
@@ -667,7 +882,7 @@ void GfxFrameout::kernelFrameout() {
 				_coordAdjuster->fromScriptToDisplay(itemEntry->picStartY, itemEntry->picStartX);
 
 				if (!isPictureOutOfView(itemEntry, it->planeRect, it->planeOffsetX, it->planeOffsetY))
-					drawPicture(itemEntry, it->planeOffsetX, it->planeOffsetY, it->planePictureMirrored);
+					addPictureDrawEntry(drawList, itemEntry, *it);
 			} else {
 				GfxView *view = (itemEntry->viewId != 0xFFFF) ? _cache->getView(itemEntry->viewId) : NULL;
 				int16 dummyX = 0;
@@ -751,35 +966,117 @@ void GfxFrameout::kernelFrameout() {
 					translatedClipRect.translate(it->planeRect.left, it->planeRect.top);
 				}
 
-				if (view) {
-					if (!clipRect.isEmpty()) {
-						if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
-							view->draw(itemEntry->celRect, clipRect, translatedClipRect, 
-								itemEntry->loopNo, itemEntry->celNo, 255, 0, view->isSci2Hires());
-						else
-							view->drawScaled(itemEntry->celRect, clipRect, translatedClipRect, 
-								itemEntry->loopNo, itemEntry->celNo, 255, itemEntry->scaleX, itemEntry->scaleY);
-					}
+				newEntry.object = itemEntry->object;
+
+				if (view && !clipRect.isEmpty()) {
+					newEntry.type = kFrameoutDrawView;
+					newEntry.rect = translatedClipRect;
+					newEntry.viewId = itemEntry->viewId;
+					newEntry.loopNo = itemEntry->loopNo;
+					newEntry.celNo = itemEntry->celNo;
+					newEntry.scaleX = itemEntry->scaleX;
+					newEntry.scaleY = itemEntry->scaleY;
+					newEntry.itemPriority = itemEntry->priority;
+					newEntry.givenOrderNr = itemEntry->givenOrderNr;
+					newEntry.celRect = itemEntry->celRect;
+					newEntry.clipRect = clipRect;
+					newEntry.translatedClipRect = translatedClipRect;
+					newEntry.hires = view->isSci2Hires();
+					drawList.push_back(newEntry);
 				}
 
 				// Draw text, if it exists
 				if (lookupSelector(_segMan, itemEntry->object, SELECTOR(text), NULL, NULL) == kSelectorVariable) {
-					g_sci->_gfxText32->drawTextBitmap(itemEntry->x, itemEntry->y, it->planeRect, itemEntry->object);
+					newEntry.type = kFrameoutDrawText;
+					newEntry.x = itemEntry->x;
+					newEntry.y = itemEntry->y;
+					newEntry.planeRect = it->planeRect;
+					if (g_sci->_gfxText32->getTextBitmapState(itemEntry->x, itemEntry->y, it->planeRect, itemEntry->object, newEntry.rect, newEntry.checksum)) {
+						newEntry.rect.clip(screenRect);
+						drawList.push_back(newEntry);
+					}
 				}
+
+				newEntry.object = planeObject;
 			}
 		}
+	}
+
+	// Figure out which part of the screen has to be redrawn. Anything that
+	// was drawn outside of kernelFrameout() since the last frame (e.g. by
+	// showVideo() or the text scroller) gets redrawn as well.
+	bool fullRedraw = _fullRedraw || _screen->getUpscaledHires();
+	Common::Rect foreignRect;
+	Common::Rect damagedRect;
 
-		for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
-			if (pictureIt->object == planeObject) {
-				delete[] pictureIt->pictureCels;
-				pictureIt->pictureCels = 0;
+	if (fullRedraw) {
+		damagedRect = screenRect;
+	} else {
+		foreignRect = getChangedScreenRect();
+		damagedRect = getDamagedRect(drawList);
+		addDamage(damagedRect, foreignRect);
+
+		// Lines and texts can't be drawn partially, so they need to be
+		// redrawn completely, if they overlap with the redrawn area
+		bool damageGrown = true;
+		while (damageGrown && !damagedRect.isEmpty()) {
+			damageGrown = false;
+			for (uint i = 0; i < drawList.size(); i++) {
+				const FrameoutDrawEntry &entry = drawList[i];
+				if (entry.type != kFrameoutDrawLine && entry.type != kFrameoutDrawText)
+					continue;
+				if (entry.rect.isEmpty() || !damagedRect.intersects(entry.rect) || damagedRect.contains(entry.rect))
+					continue;
+				damagedRect.extend(entry.rect);
+				damageGrown = true;
 			}
 		}
+		damagedRect.clip(screenRect);
+	}
+
+	// Second pass: draw everything that overlaps with the damaged area
+	for (uint i = 0; i < drawList.size(); i++) {
+		const FrameoutDrawEntry &entry = drawList[i];
+
+		if (damagedRect.isEmpty() || !damagedRect.intersects(entry.rect)) {
+			// Picture cel 0 and views with an embedded palette also set the
+			// palette, which needs to happen even when nothing gets drawn
+			if (entry.type == kFrameoutDrawPicture && entry.celNo == 0)
+				entry.picture->setSci32Palette();
+			else if (entry.type == kFrameoutDrawView)
+				mergeViewPalette(entry);
+			continue;
+		}
+
+		drawEntry(entry, damagedRect);
+	}
+
+	for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
+		delete[] pictureIt->pictureCels;
+		pictureIt->pictureCels = 0;
 	}
 
 	showCurrentScrollText();
 
-	_screen->copyToScreen();
+	if (fullRedraw) {
+		_screen->copyToScreen();
+		memcpy(_lastScreen, _screen->getActiveScreen(), screenRect.width() * screenRect.height());
+	} else {
+		// Only update the parts of the screen that actually changed
+		Common::Rect updateRect = getChangedScreenRect();
+		addDamage(updateRect, foreignRect);
+		if (!updateRect.isEmpty()) {
+			_screen->copyRectToScreen(updateRect);
+			const byte *screen = _screen->getActiveScreen();
+			for (int16 y = updateRect.top; y < updateRect.bottom; y++) {
+				memcpy(_lastScreen + y * screenRect.width() + updateRect.left,
+					screen + y * screenRect.width() + updateRect.left, updateRect.width());
+			}
+		}
+	}
+
+	_lastDrawList = drawList;
+	_fullRedraw = false;
 
 	g_sci->getEngineState()->_throttleTrigger = true;
 }
@@ -88,6 +88,62 @@ struct PlanePictureEntry {
 
 typedef Common::List<PlanePictureEntry> PlanePictureList;
 
+enum FrameoutDrawType {
+	kFrameoutDrawLine,
+	kFrameoutDrawFill,
+	kFrameoutDrawPicture,
+	kFrameoutDrawView,
+	kFrameoutDrawText
+};
+
+/**
+ * A single drawing operation of a frame. The operations of the previous frame
+ * are kept, so that kernelFrameout() can find out which parts of the screen
+ * actually changed and only redraw and update those.
+ */
+struct FrameoutDrawEntry {
+	FrameoutDrawType type;
+	reg_t object;		// plane for lines/fills/pictures, screen item otherwise
+	int16 planePriority;
+	Common::Rect rect;	// screen area that may get changed by this operation
+
+	// Lines
+	Common::Point startPoint;
+	Common::Point endPoint;
+	byte color;			// also used for fills
+	byte priority;
+	byte control;
+
+	// Pictures
+	GfxPicture *picture;
+	GuiResourceId pictureId;
+	int16 celNo;		// also used for views
+	int16 drawX;
+	int16 drawY;
+	int16 pictureX;
+	int16 pictureY;
+	bool mirrored;
+	Common::Rect planeRect;	// also used for text
+
+	// Views
+	GuiResourceId viewId;
+	int16 loopNo;
+	int16 scaleX;
+	int16 scaleY;
+	int16 itemPriority;
+	uint16 givenOrderNr;
+	Common::Rect celRect;
+	Common::Rect clipRect;
+	Common::Rect translatedClipRect;
+	bool hires;
+
+	// Text
+	int16 x, y;
+	uint32 checksum;
+};
+
+typedef Common::Array<FrameoutDrawEntry> FrameoutDrawList;
+
 struct ScrollTextEntry {
 	reg_t bitmapHandle;
 	reg_t kWindow;
@@ -143,11 +199,23 @@ public:
 	void printPlaneList(Console *con);
 	void printPlaneItemList(Console *con, reg_t planeObject);
 
+	/**
+	 * Makes the next kernelFrameout() redraw and update the whole screen.
+	 * Needs to be called, when something got drawn directly to the screen,
+	 * bypassing GfxScreen (e.g. videos).
+	 */
+	void forceFullRedraw() { _fullRedraw = true; }
+
 private:
 	void showVideo();
 	void createPlaneItemList(reg_t planeObject, FrameoutList &itemList);
 	bool isPictureOutOfView(FrameoutEntry *itemEntry, Common::Rect planeRect, int16 planeOffsetX, int16 planeOffsetY);
-	void drawPicture(FrameoutEntry *itemEntry, int16 planeOffsetX, int16 planeOffsetY, bool planePictureMirrored);
+	void addPictureDrawEntry(FrameoutDrawList &drawList, FrameoutEntry *itemEntry, const PlaneEntry &plane);
+
+	Common::Rect getDamagedRect(const FrameoutDrawList &drawList);
+	Common::Rect getChangedScreenRect();
+	void mergeViewPalette(const FrameoutDrawEntry &entry);
+	void drawEntry(const FrameoutDrawEntry &entry, const Common::Rect &damagedRect);
 
 	SegManager *_segMan;
 	ResourceManager *_resMan;
@@ -165,6 +233,11 @@ private:
 	bool _showScrollText;
 	uint16 _maxScrollTexts;
 
+	// Drawing operations and screen contents of the last frame
+	FrameoutDrawList _lastDrawList;
+	byte *_lastScreen;
+	bool _fullRedraw;
+
 	void sortPlanes();
 };
 
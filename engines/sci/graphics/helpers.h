@@ -33,7 +33,8 @@ namespace Sci {
 // Cache limits
 #define MAX_CACHED_CURSORS 10
 #define MAX_CACHED_FONTS 20
-#define MAX_CACHED_VIEWS 50
+#define MAX_CACHED_VIEW_MEMORY (4 * 1024 * 1024)
+#define MAX_CACHED_PICTURE_MEMORY (4 * 1024 * 1024)
 
 #define SCI_SHAKE_DIRECTION_VERTICAL 1
 #define SCI_SHAKE_DIRECTION_HORIZONTAL 2
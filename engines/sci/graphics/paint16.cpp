@@ -43,9 +43,14 @@ namespace Sci {
 
 GfxPaint16::GfxPaint16(ResourceManager *resMan, SegManager *segMan, Kernel *kernel, GfxCache *cache, GfxPorts *ports, GfxCoordAdjuster *coordAdjuster, GfxScreen *screen, GfxPalette *palette, GfxTransitions *transitions, AudioPlayer *audio)
 	: _resMan(resMan), _segMan(segMan), _kernel(kernel), _cache(cache), _ports(ports), _coordAdjuster(coordAdjuster), _screen(screen), _palette(palette), _transitions(transitions), _audio(audio) {
+
+	_pictureCacheMemory = 0;
+	_pictureCacheMaxMemory = MAX_CACHED_PICTURE_MEMORY;
+	resetPictureCacheStatistics();
 }
 
 GfxPaint16::~GfxPaint16() {
+	purgePictureCache();
 }
 
 void GfxPaint16::init(GfxAnimate *animate, GfxText16 *text16) {
@@ -66,7 +71,56 @@ void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mi
 	if (!addToFlag)
 		clearScreen(_screen->getColorWhite());
 
-	picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	if (_pictureCacheMaxMemory && !_EGAdrawingVisualize) {
+		Common::Rect screenRect(_screen->getWidth(), _screen->getHeight());
+		Port *curPort = _ports->getPort();
+		PictureCacheEntry key;
+
+		key.pictureId = pictureId;
+		key.mirroredFlag = mirroredFlag;
+		key.addToFlag = addToFlag;
+		key.paletteId = paletteId;
+		key.undithering = _screen->isUnditheringEnabled();
+		key.portRect = curPort->rect;
+		key.portTop = curPort->top;
+		key.portLeft = curPort->left;
+		key.screenChecksum = _screen->bitsGetChecksum(screenRect, GFX_SCREEN_MASK_ALL);
+		key.ditheredPicColors = _screen->unditherGetDitheredBgColors();
+		key.prevDitheredPicColors = NULL;
+		if (key.ditheredPicColors && addToFlag) {
+			// Dithering information gets added up for pictures added to the current one
+			key.prevDitheredPicColors = key.ditheredPicColors;
+			for (int i = 0; i < DITHERED_BG_COLORS_SIZE; i++)
+				key.screenChecksum = key.screenChecksum * 31 + key.ditheredPicColors[i];
+		}
+
+		// Different screen contents may have the same checksum, so the cache
+		// entries also get compared against the full screen
+		byte *prevScreenBits = new byte[_screen->bitsGetDataSize(screenRect, GFX_SCREEN_MASK_ALL)];
+		_screen->bitsSave(screenRect, GFX_SCREEN_MASK_ALL, prevScreenBits);
+
+		PictureCacheEntry *cachedPicture = findCachedPicture(key, prevScreenBits);
+		if (cachedPicture) {
+			// Apply palette and priority band changes of the picture, but take
+			// the rendered picture from the cache
+			picture->draw(animationNr, mirroredFlag, addToFlag, paletteId, true);
+			_screen->bitsRestore(cachedPicture->screenBits);
+			if (cachedPicture->ditheredPicColors)
+				memcpy(key.ditheredPicColors, cachedPicture->ditheredPicColors, DITHERED_BG_COLORS_SIZE * sizeof(int16));
+			delete[] prevScreenBits;
+		} else {
+			key.prevScreenBits = prevScreenBits;
+			if (key.prevDitheredPicColors) {
+				key.prevDitheredPicColors = new int16[DITHERED_BG_COLORS_SIZE];
+				memcpy(key.prevDitheredPicColors, key.ditheredPicColors, DITHERED_BG_COLORS_SIZE * sizeof(int16));
+			}
+			picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+			// cachePicture() takes over the previous screen contents
+			cachePicture(key);
+		}
+	} else {
+		picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	}
 	delete picture;
 
 	// We make a call to SciPalette here, for increasing sys timestamp and also loading targetpalette, if palvary active
@@ -75,6 +129,88 @@ void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mi
 		_palette->drewPicture(pictureId);
 }
 
+PictureCacheEntry *GfxPaint16::findCachedPicture(const PictureCacheEntry &key, const byte *prevScreenBits) {
+	uint32 bitsSize = _screen->bitsGetDataSize(Common::Rect(_screen->getWidth(), _screen->getHeight()), GFX_SCREEN_MASK_ALL);
+
+	for (PictureCacheList::iterator it = _pictureCache.begin(); it != _pictureCache.end(); ++it) {
+		if (it->pictureId == key.pictureId && it->mirroredFlag == key.mirroredFlag &&
+			it->addToFlag == key.addToFlag && it->paletteId == key.paletteId &&
+			it->undithering == key.undithering && it->portRect == key.portRect &&
+			it->portTop == key.portTop && it->portLeft == key.portLeft &&
+			it->screenChecksum == key.screenChecksum &&
+			!memcmp(it->prevScreenBits, prevScreenBits, bitsSize) &&
+			(!it->prevDitheredPicColors || !memcmp(it->prevDitheredPicColors, key.prevDitheredPicColors, DITHERED_BG_COLORS_SIZE * sizeof(int16)))) {
+			// Move it to the front, so that it gets evicted last
+			if (it != _pictureCache.begin()) {
+				_pictureCache.push_front(*it);
+				_pictureCache.erase(it);
+			}
+			_pictureCacheStats.hits++;
+			return &_pictureCache.front();
+		}
+	}
+
+	_pictureCacheStats.misses++;
+	return NULL;
+}
+
+void GfxPaint16::cachePicture(const PictureCacheEntry &key) {
+	Common::Rect screenRect(_screen->getWidth(), _screen->getHeight());
+	PictureCacheEntry entry = key;
+	uint32 bitsSize = _screen->bitsGetDataSize(screenRect, GFX_SCREEN_MASK_ALL);
+
+	entry.size = bitsSize * 2;
+	if (key.ditheredPicColors)
+		entry.size += DITHERED_BG_COLORS_SIZE * sizeof(int16);
+	if (key.prevDitheredPicColors)
+		entry.size += DITHERED_BG_COLORS_SIZE * sizeof(int16);
+	if (entry.size > _pictureCacheMaxMemory) {
+		delete[] key.prevScreenBits;
+		delete[] key.prevDitheredPicColors;
+		return;
+	}
+
+	evictPictures(_pictureCacheMaxMemory - entry.size);
+
+	entry.screenBits = new byte[bitsSize];
+	_screen->bitsSave(screenRect, GFX_SCREEN_MASK_ALL, entry.screenBits);
+	if (key.ditheredPicColors) {
+		entry.ditheredPicColors = new int16[DITHERED_BG_COLORS_SIZE];
+		memcpy(entry.ditheredPicColors, key.ditheredPicColors, DITHERED_BG_COLORS_SIZE * sizeof(int16));
+	} else {
+		entry.ditheredPicColors = NULL;
+	}
+
+	_pictureCache.push_front(entry);
+	_pictureCacheMemory += entry.size;
+}
+
+void GfxPaint16::evictPictures(uint32 maxMemory) {
+	while (_pictureCacheMemory > maxMemory && !_pictureCache.empty()) {
+		PictureCacheEntry &entry = _pictureCache.back();
+		_pictureCacheMemory -= entry.size;
+		delete[] entry.prevScreenBits;
+		delete[] entry.screenBits;
+		delete[] entry.prevDitheredPicColors;
+		delete[] entry.ditheredPicColors;
+		_pictureCache.pop_back();
+		_pictureCacheStats.evictions++;
+	}
+}
+
+void GfxPaint16::purgePictureCache() {
+	evictPictures(0);
+}
+
+void GfxPaint16::setPictureCacheMemoryBudget(uint32 budget) {
+	_pictureCacheMaxMemory = budget;
+	evictPictures(budget);
+}
+
+void GfxPaint16::resetPictureCacheStatistics() {
+	memset(&_pictureCacheStats, 0, sizeof(_pictureCacheStats));
+}
+
 // This one is the only one that updates screen!
 void GfxPaint16::drawCelAndShow(GuiResourceId viewId, int16 loopNo, int16 celNo, uint16 leftPos, uint16 topPos, byte priority, uint16 paletteNo, uint16 scaleX, uint16 scaleY) {
 	GfxView *view = _cache->getView(viewId);
@@ -23,6 +23,9 @@
 #ifndef SCI_GRAPHICS_PAINT16_H
 #define SCI_GRAPHICS_PAINT16_H
 
+#include "common/list.h"
+
+#include "sci/graphics/cache.h"
 #include "sci/graphics/paint.h"
 
 namespace Sci {
@@ -33,6 +36,34 @@ class GfxPalette;
 class Font;
 class GfxView;
 
+/**
+ * A rendered picture. The screen contents after drawing a picture only depend
+ * on the picture parameters, the picture port and the screen contents before
+ * drawing it (those matter for pictures that are added to the current one and
+ * for EGA dithering, which works on the whole screen). The screen before
+ * drawing is kept and compared in full, the checksum only serves to skip
+ * entries quickly.
+ */
+struct PictureCacheEntry {
+	GuiResourceId pictureId;
+	bool mirroredFlag;
+	bool addToFlag;
+	GuiResourceId paletteId;
+	bool undithering;
+	Common::Rect portRect;
+	int16 portTop;
+	int16 portLeft;
+	uint32 screenChecksum;	// checksum of the screen before drawing the picture
+	byte *prevScreenBits;	// screen before drawing the picture, see GfxScreen::bitsSave()
+	byte *screenBits;		// screen after drawing the picture
+	int16 *prevDitheredPicColors;	// only set, when undithering EGA pictures that are added to
+	int16 *ditheredPicColors;	// only set, when undithering EGA pictures
+	uint32 size;
+};
+
+/** Cached pictures, most recently used first */
+typedef Common::List<PictureCacheEntry> PictureCacheList;
+
 /**
  * Paint16 class, handles painting/drawing for SCI16 (SCI0-SCI1.1) games
  */
@@ -45,6 +76,14 @@ public:
 
 	void debugSetEGAdrawingVisualize(bool state);
 
+	void setPictureCacheMemoryBudget(uint32 budget);
+	uint32 getPictureCacheMemoryBudget() const { return _pictureCacheMaxMemory; }
+	uint32 getPictureCacheMemoryUsage() const { return _pictureCacheMemory; }
+	uint getPictureCacheCount() const { return _pictureCache.size(); }
+	const CacheStatistics &getPictureCacheStatistics() const { return _pictureCacheStats; }
+	void resetPictureCacheStatistics();
+	void purgePictureCache();
+
 	void drawPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, bool addToFlag, GuiResourceId paletteId);
 	void drawCelAndShow(GuiResourceId viewId, int16 loopNo, int16 celNo, uint16 leftPos, uint16 topPos, byte priority, uint16 paletteNo, uint16 scaleX = 128, uint16 scaleY = 128);
 	void drawCel(GuiResourceId viewId, int16 loopNo, int16 celNo, const Common::Rect &celRect, byte priority, uint16 paletteNo, uint16 scaleX = 128, uint16 scaleY = 128);
@@ -102,6 +141,15 @@ private:
 
 	// true means make EGA picture drawing visible
 	bool _EGAdrawingVisualize;
+
+	PictureCacheEntry *findCachedPicture(const PictureCacheEntry &key, const byte *prevScreenBits);
+	void cachePicture(const PictureCacheEntry &key);
+	void evictPictures(uint32 maxMemory);
+
+	PictureCacheList _pictureCache;
+	uint32 _pictureCacheMemory;
+	uint32 _pictureCacheMaxMemory;
+	CacheStatistics _pictureCacheStats;
 };
 
 } // End of namespace Sci
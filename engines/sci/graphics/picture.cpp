@@ -38,6 +38,7 @@ namespace Sci {
 GfxPicture::GfxPicture(ResourceManager *resMan, GfxCoordAdjuster *coordAdjuster, GfxPorts *ports, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, bool EGAdrawingVisualize)
 	: _resMan(resMan), _coordAdjuster(coordAdjuster), _ports(ports), _screen(screen), _palette(palette), _resourceId(resourceId), _EGAdrawingVisualize(EGAdrawingVisualize) {
 	assert(resourceId != -1);
+	_stateOnly = false;
 	initData(resourceId);
 }
 
@@ -59,7 +60,7 @@ GuiResourceId GfxPicture::getResourceId() {
 // differentiation between various picture formats can NOT get done using sci-version checks.
 //  Games like PQ1 use the "old" vector data picture format, but are actually SCI1.1
 //  We should leave this that way to decide the format on-the-fly instead of hardcoding it in any way
-void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo) {
+void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo, bool stateOnly) {
 	uint16 headerSize;
 
 	_animationNr = animationNr;
@@ -67,6 +68,7 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 	_addToFlag = addToFlag;
 	_EGApaletteNo = EGApaletteNo;
 	_priority = 0;
+	_stateOnly = stateOnly;
 
 	headerSize = READ_LE_UINT16(_resource->data);
 	switch (headerSize) {
@@ -184,26 +186,33 @@ int16 GfxPicture::getSci32celPriority(int16 celNo) {
 	return READ_SCI11ENDIAN_UINT16(inbuffer + cel_headerPos + 36);
 }
 
-void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictureX, int16 pictureY, bool mirrored) {
+void GfxPicture::setSci32Palette() {
 	byte *inbuffer = _resource->data;
 	int size = _resource->size;
-	int header_size = READ_SCI11ENDIAN_UINT16(inbuffer);
 	int palette_data_ptr = READ_SCI11ENDIAN_UINT32(inbuffer + 6);
+	Palette palette;
+
+	// Create palette and set it
+	_palette->createFromData(inbuffer + palette_data_ptr, size - palette_data_ptr, &palette);
+	_palette->set(&palette, true);
+}
+
+void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictureX, int16 pictureY, bool mirrored, const Common::Rect &clipRect) {
+	byte *inbuffer = _resource->data;
+	int size = _resource->size;
+	int header_size = READ_SCI11ENDIAN_UINT16(inbuffer);
 //	int celCount = inbuffer[2];
 	int cel_headerPos = header_size;
 	int cel_RlePos, cel_LiteralPos;
-	Palette palette;
 
 	// HACK
 	_mirroredFlag = mirrored;
 	_addToFlag = false;
 	_resourceType = SCI_PICTURE_TYPE_SCI32;
+	_clipRect = clipRect;
 
-	if (celNo == 0) {
-		// Create palette and set it
-		_palette->createFromData(inbuffer + palette_data_ptr, size - palette_data_ptr, &palette);
-		_palette->set(&palette, true);
-	}
+	if (celNo == 0)
+		setSci32Palette();
 
 	// Header
 	// [headerSize:WORD] [celCount:BYTE] [Unknown:BYTE] [Unknown:WORD] [paletteOffset:DWORD] [Unknown:DWORD]
@@ -226,6 +235,7 @@ void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictu
 
 	drawCelData(inbuffer, size, cel_headerPos, cel_RlePos, cel_LiteralPos, drawX, drawY, pictureX, pictureY);
 	cel_headerPos += 42;
+	_clipRect = Common::Rect();
 }
 #endif
 
@@ -273,6 +283,13 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 	if (displaceX || displaceY)
 		error("unsupported embedded cel-data in picture");
 
+	if (_stateOnly)
+		return;
+
+	// Nothing to do, if none of the area we may draw to is inside the clip rect
+	if (!_clipRect.isEmpty() && !_clipRect.intersects(_coordAdjuster->pictureGetDisplayArea()))
+		return;
+
 	// We will unpack cel-data into a temporary buffer and then plot it to screen
 	//  That needs to be done cause a mirrored picture may be requested
 	pixelCount = width * height;
@@ -345,6 +362,29 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 		if (width > rightX - leftX)
 			sourcePixelSkipPerRow = width - (rightX - leftX);
 
+		// Restrict drawing to the clip rect, if one is set
+		uint16 skipClippedPixels = 0;
+		if (!_clipRect.isEmpty()) {
+			int16 clipTop = MAX<int16>(y, _clipRect.top);
+			int16 clipBottom = MIN<int16>(lastY, _clipRect.bottom);
+			int16 clipLeft = MAX<int16>(leftX, _clipRect.left);
+			int16 clipRight = MIN<int16>(rightX, _clipRect.right);
+
+			if (clipTop >= clipBottom || clipLeft >= clipRight) {
+				delete[] celBitmap;
+				return;
+			}
+
+			skipCelBitmapLines += clipTop - y;
+			// The first pixel of a row is the leftmost one, or the rightmost one when mirrored
+			skipClippedPixels = _mirroredFlag ? (rightX - clipRight) : (clipLeft - leftX);
+			sourcePixelSkipPerRow += (rightX - leftX) - (clipRight - clipLeft);
+			y = clipTop;
+			lastY = clipBottom;
+			leftX = clipLeft;
+			rightX = clipRight;
+		}
+
 		// Change clearcolor to white, if we dont add to an existing picture. That way we will paint everything on screen
 		// but white and that won't matter because the screen is supposed to be already white. It seems that most (if not all)
 		// SCI1.1 games use color 0 as transparency and SCI1 games use color 255 as transparency. Sierra SCI seems to paint
@@ -356,7 +396,7 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 		byte drawMask = priority > 15 ? GFX_SCREEN_MASK_VISUAL : GFX_SCREEN_MASK_VISUAL | GFX_SCREEN_MASK_PRIORITY;
 
 		ptr = celBitmap;
-		ptr += skipCelBitmapPixels;
+		ptr += skipCelBitmapPixels + skipClippedPixels;
 		ptr += skipCelBitmapLines * width;
 		if (!_mirroredFlag) {
 			// Draw bitmap to screen
@@ -599,7 +639,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (!_stateOnly)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 		case PIC_OP_MEDIUM_LINES: // medium line
@@ -619,7 +660,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (!_stateOnly)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 		case PIC_OP_LONG_LINES: // long line
@@ -630,7 +672,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (!_stateOnly)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 
@@ -800,7 +843,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 		case PIC_OP_TERMINATE:
 			_priority = pic_priority;
 			// Dithering EGA pictures
-			if (isEGA) {
+			if (isEGA && !_stateOnly) {
 				_screen->dither(_addToFlag);
 				switch (g_sci->getGameId()) {
 				case GID_SQ3:
@@ -820,7 +863,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 		default:
 			error("Unsupported pic-operation %X", pic_op);
 		}
-		if ((_EGAdrawingVisualize) && (isEGA)) {
+		if ((_EGAdrawingVisualize) && (isEGA) && (!_stateOnly)) {
 			_screen->copyToScreen();
 			g_system->updateScreen();
 			g_system->delayMillis(10);
@@ -890,11 +933,14 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 	Common::Stack<Common::Point> stack;
 	Common::Point p, p1;
 	byte screenMask = _screen->getDrawingMask(color, priority, control);
-	byte matchedMask, matchMask;
+	byte matchMask;
 	int16 w, e, a_set, b_set;
 
 	bool isEGA = (_resMan->getViewType() == kViewEga);
 
+	if (_stateOnly)
+		return;
+
 	p.x = x + curPort->left;
 	p.y = y + curPort->top;
 	stack.push(p);
@@ -954,20 +1000,22 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 	int b = curPort->rect.bottom + curPort->top - 1;
 	while (stack.size()) {
 		p = stack.pop();
-		if ((matchedMask = _screen->isFillMatch(p.x, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)) == 0) // already filled
+		if (!_screen->isFillMatch(p.x, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)) // already filled
 			continue;
-		_screen->putPixel(p.x, p.y, screenMask, color, priority, control);
 		w = p.x;
 		e = p.x;
 		// moving west and east pointers as long as there is a matching color to fill
-		while (w > l && (matchedMask = _screen->isFillMatch(w - 1, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)))
-			_screen->putPixel(--w, p.y, screenMask, color, priority, control);
-		while (e < r && (matchedMask = _screen->isFillMatch(e + 1, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)))
-			_screen->putPixel(++e, p.y, screenMask, color, priority, control);
+		while (w > l && _screen->isFillMatch(w - 1, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA))
+			w--;
+		while (e < r && _screen->isFillMatch(e + 1, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA))
+			e++;
+		// the matching of a pixel doesn't depend on its neighbours, so we may
+		// fill the whole span at once
+		_screen->putPixelSpan(w, e, p.y, screenMask, color, priority, control);
 		// checking lines above and below for possible flood targets
 		a_set = b_set = 0;
 		while (w <= e) {
-			if (p.y > t && (matchedMask = _screen->isFillMatch(w, p.y - 1, matchMask, searchColor, searchPriority, searchControl, isEGA))) { // one line above
+			if (p.y > t && _screen->isFillMatch(w, p.y - 1, matchMask, searchColor, searchPriority, searchControl, isEGA)) { // one line above
 				if (a_set == 0) {
 					p1.x = w;
 					p1.y = p.y - 1;
@@ -977,7 +1025,7 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 			} else
 				a_set = 0;
 
-			if (p.y < b && (matchedMask = _screen->isFillMatch(w, p.y + 1, matchMask, searchColor, searchPriority, searchControl, isEGA))) { // one line below
+			if (p.y < b && _screen->isFillMatch(w, p.y + 1, matchMask, searchColor, searchPriority, searchControl, isEGA)) { // one line below
 				if (b_set == 0) {
 					p1.x = w;
 					p1.y = p.y + 1;
@@ -1196,6 +1244,9 @@ void GfxPicture::vectorPattern(int16 x, int16 y, byte color, byte priority, byte
 	byte size = code & SCI_PATTERN_CODE_PENSIZE;
 	Common::Rect rect;
 
+	if (_stateOnly)
+		return;
+
 	// We need to adjust the given coordinates, because the ones given us do not define upper left but somewhat middle
 	y -= size; if (y < 0) y = 0;
 	x -= size; if (x < 0) x = 0;
@@ -49,7 +49,12 @@ public:
 	~GfxPicture();
 
 	GuiResourceId getResourceId();
-	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo);
+	/**
+	 * Draws the picture. If stateOnly is set, nothing gets drawn at all, only
+	 * the palette and priority band changes of the picture are applied. This
+	 * is used when the rendered picture got taken from the picture cache.
+	 */
+	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo, bool stateOnly = false);
 
 #ifdef ENABLE_SCI32
 	int16 getSci32celCount();
@@ -58,7 +63,12 @@ public:
 	int16 getSci32celWidth(int16 celNo);
 	int16 getSci32celHeight(int16 celNo);
 	int16 getSci32celPriority(int16 celNo);
-	void drawSci32Vga(int16 celNo, int16 callerX, int16 callerY, int16 pictureX, int16 pictureY, bool mirrored);
+	void setSci32Palette();
+	/**
+	 * Draws one cel of a SCI32 picture. If clipRect is not empty, only the
+	 * part of the cel that lies within it (in screen coordinates) is drawn.
+	 */
+	void drawSci32Vga(int16 celNo, int16 callerX, int16 callerY, int16 pictureX, int16 pictureY, bool mirrored, const Common::Rect &clipRect = Common::Rect());
 #endif
 
 private:
@@ -95,6 +105,10 @@ private:
 	bool _addToFlag;
 	int16 _EGApaletteNo;
 	byte _priority;
+	bool _stateOnly;
+
+	// Only draw within this rect (screen coordinates), used by SCI32
+	Common::Rect _clipRect;
 
 	// If true, we will show the whole EGA drawing process...
 	bool _EGAdrawingVisualize;
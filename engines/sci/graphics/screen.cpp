@@ -242,6 +242,37 @@ void GfxScreen::putPixel(int x, int y, byte drawMask, byte color, byte priority,
 		_controlScreen[offset] = control;
 }
 
+/**
+ * Puts the pixels from left to right (inclusive) of one line onto the screen,
+ *  same as calling putPixel() for each of them.
+ */
+void GfxScreen::putPixelSpan(int left, int right, int y, byte drawMask, byte color, byte priority, byte control) {
+	int offset = y * _pitch + left;
+	int count = right - left + 1;
+
+	if (count <= 0)
+		return;
+
+	if (drawMask & GFX_SCREEN_MASK_VISUAL) {
+		memset(_visualScreen + offset, color, count);
+		if (!_upscaledHires) {
+			memset(_displayScreen + offset, color, count);
+		} else {
+			int displayOffset = _upscaledMapping[y] * _displayWidth + left * 2;
+			int heightOffsetBreak = (_upscaledMapping[y + 1] - _upscaledMapping[y]) * _displayWidth;
+			int heightOffset = 0;
+			do {
+				memset(_displayScreen + displayOffset + heightOffset, color, count * 2);
+				heightOffset += _displayWidth;
+			} while (heightOffset != heightOffsetBreak);
+		}
+	}
+	if (drawMask & GFX_SCREEN_MASK_PRIORITY)
+		memset(_priorityScreen + offset, priority, count);
+	if (drawMask & GFX_SCREEN_MASK_CONTROL)
+		memset(_controlScreen + offset, control, count);
+}
+
 /**
  * This is used to put font pixels onto the screen - we adjust differently, so that we won't
  *  do triple pixel lines in any case on upscaled hires. That way the font will not get distorted
@@ -296,8 +327,7 @@ void GfxScreen::drawLine(Common::Point startPoint, Common::Point endPoint, byte
 	if (top == bottom) {
 		if (right < left)
 			SWAP(right, left);
-		for (int i = left; i <= right; i++)
-			putPixel(i, top, drawMask, color, priority, control);
+		putPixelSpan(left, right, top, drawMask, color, priority, control);
 		return;
 	}
 	// vertical line
@@ -365,36 +395,6 @@ byte GfxScreen::getControl(int x, int y) {
 	return _controlScreen[y * _pitch + x];
 }
 
-byte GfxScreen::isFillMatch(int16 x, int16 y, byte screenMask, byte t_color, byte t_pri, byte t_con, bool isEGA) {
-	int offset = y * _pitch + x;
-	byte match = 0;
-
-	if (screenMask & GFX_SCREEN_MASK_VISUAL) {
-		if (!isEGA) {
-			if (*(_visualScreen + offset) == t_color)
-				match |= GFX_SCREEN_MASK_VISUAL;
-		} else {
-			// In EGA games a pixel in the framebuffer is only 4 bits. We store
-			// a full byte per pixel to allow undithering, but when comparing
-			// pixels for flood-fill purposes, we should only compare the
-			// visible color of a pixel.
-
-			byte c = *(_visualScreen + offset);
-			if ((x ^ y) & 1)
-				c = (c ^ (c >> 4)) & 0x0F;
-			else
-				c = c & 0x0F;
-			if (c == t_color)
-				match |= GFX_SCREEN_MASK_VISUAL;
-		}
-	}
-	if ((screenMask & GFX_SCREEN_MASK_PRIORITY) && *(_priorityScreen + offset) == t_pri)
-		match |= GFX_SCREEN_MASK_PRIORITY;
-	if ((screenMask & GFX_SCREEN_MASK_CONTROL) && *(_controlScreen + offset) == t_con)
-		match |= GFX_SCREEN_MASK_CONTROL;
-	return match;
-}
-
 int GfxScreen::bitsGetDataSize(Common::Rect rect, byte mask) {
 	int byteCount = sizeof(rect) + sizeof(mask);
 	int pixels = rect.width() * rect.height();
@@ -443,6 +443,43 @@ void GfxScreen::bitsSave(Common::Rect rect, byte mask, byte *memoryPtr) {
 	}
 }
 
+/**
+ * Returns a checksum over the same data that bitsSave() would save, which is
+ *  used to find out if the screen contents changed.
+ */
+uint32 GfxScreen::bitsGetChecksum(Common::Rect rect, byte mask) {
+	uint32 checksum = 0;
+	int width = rect.width();
+	int y, x;
+
+	for (y = rect.top; y < rect.bottom; y++) {
+		const byte *visualPtr = _visualScreen + y * _pitch + rect.left;
+		const byte *priorityPtr = _priorityScreen + y * _pitch + rect.left;
+		const byte *controlPtr = _controlScreen + y * _pitch + rect.left;
+		for (x = 0; x < width; x++) {
+			if (mask & GFX_SCREEN_MASK_VISUAL)
+				checksum = checksum * 31 + visualPtr[x];
+			if (mask & GFX_SCREEN_MASK_PRIORITY)
+				checksum = checksum * 31 + priorityPtr[x];
+			if (mask & GFX_SCREEN_MASK_CONTROL)
+				checksum = checksum * 31 + controlPtr[x];
+		}
+	}
+
+	if ((mask & GFX_SCREEN_MASK_VISUAL) && _upscaledHires) {
+		// The display screen may contain hires graphics, that are not part
+		// of the visual screen
+		const byte *displayPtr = _displayScreen + _upscaledMapping[rect.top] * _displayWidth + rect.left * 2;
+		for (y = _upscaledMapping[rect.top]; y < _upscaledMapping[rect.bottom]; y++) {
+			for (x = 0; x < width * 2; x++)
+				checksum = checksum * 31 + displayPtr[x];
+			displayPtr += _displayWidth;
+		}
+	}
+
+	return checksum;
+}
+
 void GfxScreen::bitsSaveScreen(Common::Rect rect, byte *screen, uint16 screenWidth, byte *&memoryPtr) {
 	int width = rect.width();
 	int y;
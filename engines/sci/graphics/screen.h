@@ -74,6 +74,7 @@ public:
 
 	void copyToScreen();
 	void copyFromScreen(byte *buffer);
+	const byte *getActiveScreen() const { return _activeScreen; }
 	void kernelSyncWithFramebuffer();
 	void copyRectToScreen(const Common::Rect &rect);
 	void copyDisplayRectToScreen(const Common::Rect &rect);
@@ -81,6 +82,7 @@ public:
 
 	byte getDrawingMask(byte color, byte prio, byte control);
 	void putPixel(int x, int y, byte drawMask, byte color, byte prio, byte control);
+	void putPixelSpan(int left, int right, int y, byte drawMask, byte color, byte prio, byte control);
 	void putFontPixel(int startingY, int x, int y, byte color);
 	void putPixelOnDisplay(int x, int y, byte color);
 	void drawLine(Common::Point startPoint, Common::Point endPoint, byte color, byte prio, byte control);
@@ -101,12 +103,37 @@ public:
 	byte getVisual(int x, int y);
 	byte getPriority(int x, int y);
 	byte getControl(int x, int y);
-	byte isFillMatch(int16 x, int16 y, byte drawMask, byte t_color, byte t_pri, byte t_con, bool isEGA);
+	byte isFillMatch(int16 x, int16 y, byte screenMask, byte t_color, byte t_pri, byte t_con, bool isEGA) {
+		int offset = y * _pitch + x;
+		byte match = 0;
+
+		if (screenMask & GFX_SCREEN_MASK_VISUAL) {
+			byte c = _visualScreen[offset];
+			if (isEGA) {
+				// In EGA games a pixel in the framebuffer is only 4 bits. We store
+				// a full byte per pixel to allow undithering, but when comparing
+				// pixels for flood-fill purposes, we should only compare the
+				// visible color of a pixel.
+				if ((x ^ y) & 1)
+					c = (c ^ (c >> 4)) & 0x0F;
+				else
+					c = c & 0x0F;
+			}
+			if (c == t_color)
+				match |= GFX_SCREEN_MASK_VISUAL;
+		}
+		if ((screenMask & GFX_SCREEN_MASK_PRIORITY) && _priorityScreen[offset] == t_pri)
+			match |= GFX_SCREEN_MASK_PRIORITY;
+		if ((screenMask & GFX_SCREEN_MASK_CONTROL) && _controlScreen[offset] == t_con)
+			match |= GFX_SCREEN_MASK_CONTROL;
+		return match;
+	}
 
 	int bitsGetDataSize(Common::Rect rect, byte mask);
 	void bitsSave(Common::Rect rect, byte mask, byte *memoryPtr);
 	void bitsGetRect(byte *memoryPtr, Common::Rect *destRect);
 	void bitsRestore(byte *memoryPtr);
+	uint32 bitsGetChecksum(Common::Rect rect, byte mask);
 
 	void scale2x(const byte *src, byte *dst, int16 srcWidth, int16 srcHeight, byte bytesPerPixel = 1);
 
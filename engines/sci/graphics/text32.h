@@ -35,6 +35,12 @@ public:
 	reg_t createTextBitmap(reg_t textObject, uint16 maxWidth = 0, uint16 maxHeight = 0, reg_t prevHunk = NULL_REG);
 	reg_t createScrollTextBitmap(Common::String text, reg_t textObject, uint16 maxWidth = 0, uint16 maxHeight = 0, reg_t prevHunk = NULL_REG);
 	void drawTextBitmap(int16 x, int16 y, Common::Rect planeRect, reg_t textObject);
+	/**
+	 * Returns the screen area drawTextBitmap() would draw to, and a checksum
+	 * over the text bitmap, so that callers can find out if it changed.
+	 * @return false if drawTextBitmap() wouldn't draw anything
+	 */
+	bool getTextBitmapState(int16 x, int16 y, Common::Rect planeRect, reg_t textObject, Common::Rect &rect, uint32 &checksum);
 	void drawScrollTextBitmap(reg_t textObject, reg_t hunkId, uint16 x, uint16 y);
 	void disposeTextBitmap(reg_t hunkId);
 	int16 GetLongest(const char *text, int16 maxWidth, GfxFont *font);
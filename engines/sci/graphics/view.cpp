@@ -31,7 +31,7 @@
 namespace Sci {
 
 GfxView::GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId)
-	: _resMan(resMan), _screen(screen), _palette(palette), _resourceId(resourceId) {
+	: _resMan(resMan), _screen(screen), _palette(palette), _resourceId(resourceId), _bitmapMemorySize(0) {
 	assert(resourceId != -1);
 	_coordAdjuster = g_sci->_gfxCoordAdjuster;
 	initData(resourceId);
@@ -590,6 +590,7 @@ const byte *GfxView::getBitmap(int16 loopNo, int16 celNo) {
 	// allocating memory to store cel's bitmap
 	int pixelCount = width * height;
 	_loop[loopNo].cel[celNo].rawBitmap = new byte[pixelCount];
+	_bitmapMemorySize += pixelCount;
 	byte *pBitmap = _loop[loopNo].cel[celNo].rawBitmap;
 
 	// unpack the actual cel bitmap data
@@ -77,6 +77,7 @@ public:
 	void drawScaled(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated, int16 loopNo, int16 celNo, byte priority, int16 scaleX, int16 scaleY);
 	uint16 getLoopCount() const { return _loopCount; }
 	uint16 getCelCount(int16 loopNo) const;
+	uint32 getMemorySize() const { return _resourceSize + _bitmapMemorySize; }
 	Palette *getPalette();
 
 	bool isScaleable();
@@ -104,6 +105,8 @@ private:
 
 	uint16 _loopCount;
 	LoopInfo *_loop;
+	// amount of memory used by unpacked cel bitmaps (see getBitmap())
+	uint32 _bitmapMemorySize;
 	bool _embeddedPal;
 	Palette _viewPalette;
 
@@ -22,9 +22,11 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 
 #include "sci/resource.h"
@@ -370,6 +372,20 @@ void ResourceManager::loadResource(Resource *res) {
 	res->_source->loadResource(this, res);
 }
 
+void ResourceManager::loadResourceTimed(Resource *res, bool prefetch) {
+	ResourceTypeStatistics &stats = _statistics[res->getType()];
+	uint32 startTime = g_system->getMillis();
+
+	loadResource(res);
+
+	stats.loadTime += g_system->getMillis() - startTime;
+	stats.bytesLoaded += res->size;
+	if (prefetch)
+		stats.prefetches++;
+	else
+		stats.misses++;
+}
+
 
 void PatchResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
 	bool result = res->loadFromPatchFile();
@@ -889,7 +905,13 @@ ResourceManager::ResourceManager() {
 void ResourceManager::init(bool initFromFallbackDetector) {
 	_memoryLocked = 0;
 	_memoryLRU = 0;
+	_maxMemoryLRU = MAX_MEMORY;
+	if (ConfMan.hasKey("sci_resource_memory"))
+		_maxMemoryLRU = ConfMan.getInt("sci_resource_memory") * 1024;
 	_LRU.clear();
+	_prefetchQueue.clear();
+	_prefetching = true;
+	resetStatistics();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 
@@ -992,7 +1014,7 @@ void ResourceManager::removeFromLRU(Resource *res) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+	_LRU.erase(res->_lruPosition);
 	_memoryLRU -= res->size;
 	res->_status = kResStatusAllocated;
 }
@@ -1003,6 +1025,7 @@ void ResourceManager::addToLRU(Resource *res) {
 		return;
 	}
 	_LRU.push_front(res);
+	res->_lruPosition = _LRU.begin();
 	_memoryLRU += res->size;
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s.%03d (%d bytes) to lru control: %d bytes total",
@@ -1030,9 +1053,9 @@ void ResourceManager::printLRU() {
 }
 
 void ResourceManager::freeOldResources() {
-	while (MAX_MEMORY < _memoryLRU) {
+	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
-		Resource *goner = *_LRU.legacy_reverse_begin();
+		Resource *goner = _LRU.back();
 		removeFromLRU(goner);
 		goner->unalloc();
 #ifdef SCI_VERBOSE_RESMAN
@@ -1041,6 +1064,59 @@ void ResourceManager::freeOldResources() {
 	}
 }
 
+void ResourceManager::setMaxMemory(uint32 maxMemory) {
+	_maxMemoryLRU = maxMemory;
+	freeOldResources();
+}
+
+void ResourceManager::resetStatistics() {
+	memset(_statistics, 0, sizeof(_statistics));
+}
+
+void ResourceManager::enablePrefetching(bool enable) {
+	_prefetching = enable;
+	if (!_prefetching)
+		_prefetchQueue.clear();
+}
+
+void ResourceManager::queuePrefetch(ResourceId id) {
+	if (!_prefetching)
+		return;
+
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc)
+		return;
+
+	for (Common::List<ResourceId>::const_iterator it = _prefetchQueue.begin(); it != _prefetchQueue.end(); ++it) {
+		if (*it == id)
+			return;
+	}
+
+	_prefetchQueue.push_back(id);
+}
+
+bool ResourceManager::processPrefetchQueue(uint32 deadline) {
+	bool loaded = false;
+
+	while (!_prefetchQueue.empty() && g_system->getMillis() < deadline) {
+		Resource *res = testResource(_prefetchQueue.front());
+		_prefetchQueue.pop_front();
+
+		// Skip resources which got requested in the meantime
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		loadResourceTimed(res, true);
+		if (res->_status == kResStatusAllocated) {
+			addToLRU(res);
+			freeOldResources();
+		}
+		loaded = true;
+	}
+
+	return loaded;
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1060,10 +1136,13 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
-		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		removeFromLRU(retval);
+	if (retval->_status == kResStatusNoMalloc) {
+		loadResourceTimed(retval, false);
+	} else {
+		_statistics[retval->getType()].hits++;
+		if (retval->_status == kResStatusEnqueued)
+			removeFromLRU(retval);
+	}
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
 
@@ -239,6 +239,7 @@ protected:
 	ResourceId _id;	// TODO: _id could almost be made const, only readResourceInfo() modifies it...
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
+	Common::List<Resource *>::iterator _lruPosition; /**< Position inside the LRU list, valid while enqueued */
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
@@ -254,6 +255,15 @@ protected:
 
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
+/** Load and cache statistics for one resource type, shown by the debugger */
+struct ResourceTypeStatistics {
+	uint32 hits;		///< Resource was already in memory when requested
+	uint32 misses;		///< Resource had to be loaded when requested
+	uint32 prefetches;	///< Resource was loaded in advance, while idle
+	uint32 bytesLoaded;
+	uint32 loadTime;	///< Total time spent loading and decompressing, in ms
+};
+
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
 	// ease transition to the ResourceSource class system.
@@ -324,10 +334,58 @@ public:
 	 */
 	Common::List<ResourceId> listResources(ResourceType type, int mapNumber = -1);
 
+	/**
+	 * Opens a stream on the data of an audio resource, which reads directly
+	 * from its audio volume instead of loading the whole resource into memory.
+	 * This only works for resources inside of audio volumes, that aren't
+	 * loaded already.
+	 * @param id				The audio resource
+	 * @param header			Receives the SOL header of SCI1.1+ audio (at most 12 bytes)
+	 * @param headerSize		Receives the size of the SOL header, 0 if there is none
+	 * @param compressionType	Receives the compression type of compressed audio volumes
+	 * @return The stream, or NULL if the resource can't be streamed
+	 */
+	Common::SeekableReadStream *getAudioResourceStream(ResourceId id, byte *header, byte &headerSize, uint32 &compressionType);
+
 	void setAudioLanguage(int language);
 	int getAudioLanguage() const;
 	void changeAudioDirectory(Common::String path);
 	bool isGMTrackIncluded();
+
+	/**
+	 * Queues a resource to be loaded in advance. Scripts announce most of
+	 * the resources they are going to use via kLoad, so these get loaded
+	 * while the engine is idle (see processPrefetchQueue) instead of
+	 * blocking when they are actually needed.
+	 * @param id	The resource to load
+	 */
+	void queuePrefetch(ResourceId id);
+
+	/**
+	 * Loads queued resources until the queue is empty or the given time
+	 * has been reached.
+	 * @param deadline	Time (as returned by OSystem::getMillis()) after which
+	 *					no further resources are loaded
+	 * @return true if at least one resource got loaded
+	 */
+	bool processPrefetchQueue(uint32 deadline);
+
+	uint getPrefetchQueueSize() const { return _prefetchQueue.size(); }
+	void enablePrefetching(bool enable);
+	bool isPrefetchingEnabled() const { return _prefetching; }
+
+	/**
+	 * Sets the amount of memory that unlocked resources may use, before
+	 * the least recently used ones get freed.
+	 */
+	void setMaxMemory(uint32 maxMemory);
+	uint32 getMaxMemory() const { return _maxMemoryLRU; }
+	uint32 getMemoryLRU() const { return _memoryLRU; }
+	uint32 getMemoryLocked() const { return _memoryLocked; }
+	uint getLRUCount() const { return _LRU.size(); }
+
+	const ResourceTypeStatistics &getStatistics(ResourceType type) const { return _statistics[type]; }
+	void resetStatistics();
 	bool isSci11Mac() const { return _volVersion == kResVersionSci11Mac; }
 	ViewType getViewType() const { return _viewType; }
 	const char *getMapVersionDesc() const { return versionDescription(_mapVersion); }
@@ -379,19 +437,23 @@ public:
 	ResourceType convertResType(byte type);
 
 protected:
-	// Maximum number of bytes to allow being allocated for resources
+	// Default maximum number of bytes to allow being allocated for resources,
+	// can be overridden with the "sci_resource_memory" config key (in KB).
 	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
-	// for resources which are not explicitly locked. However, a warning will be
-	// issued whenever this limit is exceeded.
+	// for resources which are not explicitly locked.
 	enum {
-		MAX_MEMORY = 256 * 1024	// 256KB
+		MAX_MEMORY = 4 * 1024 * 1024	// 4MB
 	};
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	Common::List<ResourceSource *> _sources;
-	int _memoryLocked;	///< Amount of resource bytes in locked memory
-	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	uint32 _memoryLocked;	///< Amount of resource bytes in locked memory
+	uint32 _memoryLRU;		///< Amount of resource bytes under LRU control
+	uint32 _maxMemoryLRU;	///< Amount of resource bytes allowed under LRU control
+	Common::List<Resource *> _LRU; ///< Last Resource Used list, most recently used first
+	Common::List<ResourceId> _prefetchQueue; ///< Resources to load while idle
+	bool _prefetching;
+	ResourceTypeStatistics _statistics[kResourceTypeInvalid + 1];
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -445,6 +507,7 @@ protected:
 
 	Common::SeekableReadStream *getVolumeFile(ResourceSource *source);
 	void loadResource(Resource *res);
+	void loadResourceTimed(Resource *res, bool prefetch);
 	void freeOldResources();
 	void addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0);
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size);
@@ -23,7 +23,9 @@
 // Resource library
 
 #include "common/archive.h"
+#include "common/bufferedstream.h"
 #include "common/file.h"
+#include "common/substream.h"
 #include "common/textconsole.h"
 
 #include "sci/resource.h"
@@ -841,27 +843,19 @@ void AudioVolumeResourceSource::loadResource(ResourceManager *resMan, Resource *
 	if (_audioCompressionType) {
 		// this file is compressed, so lookup our offset in the offset-translation table and get the new offset
 		//  also calculate the compressed size by using the next offset
-		int32 *mappingTable = _audioCompressionOffsetMapping;
 		int32 compressedOffset = 0;
+		int32 compressedSize = 0;
 
-		do {
-			if (*mappingTable == res->_fileOffset) {
-				mappingTable++;
-				compressedOffset = *mappingTable;
-				// Go to next compressed offset and use that to calculate size of compressed sample
-				switch (res->getType()) {
-				case kResourceTypeSync:
-				case kResourceTypeSync36:
-					// we should already have a (valid) size
-					break;
-				default:
-					mappingTable += 2;
-					res->size = *mappingTable - compressedOffset;
-				}
+		if (getCompressedOffset(res->_fileOffset, compressedOffset, compressedSize)) {
+			switch (res->getType()) {
+			case kResourceTypeSync:
+			case kResourceTypeSync36:
+				// we should already have a (valid) size
 				break;
+			default:
+				res->size = compressedSize;
 			}
-			mappingTable += 2;
-		} while (*mappingTable);
+		}
 
 		if (!compressedOffset)
 			error("could not translate offset to compressed offset in audio volume");
@@ -891,6 +885,95 @@ void AudioVolumeResourceSource::loadResource(ResourceManager *resMan, Resource *
 		delete fileStream;
 }
 
+bool AudioVolumeResourceSource::getCompressedOffset(int32 fileOffset, int32 &compressedOffset, int32 &compressedSize) const {
+	int32 *mappingTable = _audioCompressionOffsetMapping;
+
+	do {
+		if (*mappingTable == fileOffset) {
+			// Go to next compressed offset and use that to calculate size of compressed sample
+			compressedOffset = mappingTable[1];
+			compressedSize = mappingTable[3] - compressedOffset;
+			return true;
+		}
+		mappingTable += 2;
+	} while (*mappingTable);
+
+	return false;
+}
+
+Common::SeekableReadStream *AudioVolumeResourceSource::createAudioStream(ResourceManager *resMan, Resource *res, byte *header, byte &headerSize) {
+	// We need our own file handle here, as the stream is read by the mixer
+	// while the volume files of the resource manager are used for loading
+	// other resources
+	Common::SeekableReadStream *fileStream = 0;
+	if (_resourceFile) {
+		fileStream = _resourceFile->createReadStream();
+	} else {
+		Common::File *file = new Common::File();
+		if (file->open(getLocationName()))
+			fileStream = file;
+		else
+			delete file;
+	}
+
+	if (!fileStream)
+		return NULL;
+
+	int32 dataOffset = res->_fileOffset;
+	int32 dataSize = res->size;
+	headerSize = 0;
+
+	if (_audioCompressionType) {
+		// Compressed audio won't have resource type id and header size for SCI1.1
+		if (!getCompressedOffset(res->_fileOffset, dataOffset, dataSize) || !dataOffset)
+			error("could not translate offset to compressed offset in audio volume");
+	} else if (getSciVersion() >= SCI_VERSION_1_1) {
+		fileStream->seek(res->_fileOffset, SEEK_SET);
+
+		if (fileStream->readUint32BE() == MKTAG('R','I','F','F')) {
+			// WAVE file
+			dataSize = fileStream->readUint32LE() + 8;
+		} else {
+			// Same checks as in Resource::loadFromAudioVolumeSCI11()
+			fileStream->seek(res->_fileOffset, SEEK_SET);
+			ResourceType type = resMan->convertResType(fileStream->readByte());
+			headerSize = fileStream->readByte();
+
+			if (type != kResourceTypeAudio || (headerSize != 7 && headerSize != 11 && headerSize != 12)) {
+				warning("Unsupported audio header in %s", res->_id.toString().c_str());
+				delete fileStream;
+				headerSize = 0;
+				return NULL;
+			}
+
+			fileStream->read(header, headerSize);
+			// The size is defined already from the map for 7 byte headers
+			if (headerSize != 7)
+				dataSize = READ_LE_UINT32(header + 7);
+			dataOffset += 2 + headerSize;
+		}
+	}
+
+	// Read ahead a bit, the decoders tend to read small amounts at a time
+	Common::SeekableReadStream *dataStream = new Common::SeekableSubReadStream(fileStream, dataOffset, dataOffset + dataSize, DisposeAfterUse::YES);
+	return Common::wrapBufferedSeekableReadStream(dataStream, 4096, DisposeAfterUse::YES);
+}
+
+Common::SeekableReadStream *ResourceManager::getAudioResourceStream(ResourceId id, byte *header, byte &headerSize, uint32 &compressionType) {
+	Resource *res = testResource(id);
+
+	headerSize = 0;
+	compressionType = 0;
+
+	// Resources that are loaded already are played from memory
+	if (!res || res->_status != kResStatusNoMalloc || res->_source->getSourceType() != kSourceAudioVolume)
+		return NULL;
+
+	AudioVolumeResourceSource *source = (AudioVolumeResourceSource *)res->_source;
+	compressionType = source->getAudioCompressionType();
+	return source->createAudioStream(this, res, header, headerSize);
+}
+
 bool ResourceManager::addAudioSources() {
 	Common::List<ResourceId> resources = listResources(kResourceTypeMap);
 	Common::List<ResourceId>::iterator itr;
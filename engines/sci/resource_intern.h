@@ -152,6 +152,15 @@ public:
 	virtual void loadResource(ResourceManager *resMan, Resource *res);
 
 	virtual uint32 getAudioCompressionType() const;
+
+	/**
+	 * Opens a new stream on the audio data of a resource inside this volume.
+	 * See ResourceManager::getAudioResourceStream().
+	 */
+	Common::SeekableReadStream *createAudioStream(ResourceManager *resMan, Resource *res, byte *header, byte &headerSize);
+
+protected:
+	bool getCompressedOffset(int32 fileOffset, int32 &compressedOffset, int32 &compressedSize) const;
 };
 
 class ExtAudioMapResourceSource : public ResourceSource {
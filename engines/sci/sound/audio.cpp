@@ -30,6 +30,7 @@
 
 #include "common/file.h"
 #include "common/memstream.h"
+#include "common/substream.h"
 #include "common/system.h"
 
 #include "audio/audiostream.h"
@@ -48,10 +49,12 @@ AudioPlayer::AudioPlayer(ResourceManager *resMan) : _resMan(resMan), _audioRate(
 
 	_mixer = g_system->getMixer();
 	_wPlayFlag = false;
+	_audioCacheMemory = 0;
 }
 
 AudioPlayer::~AudioPlayer() {
 	stopAllAudio();
+	purgeAudioCache();
 }
 
 void AudioPlayer::stopAllAudio() {
@@ -241,66 +244,257 @@ static byte *readSOLAudio(Common::SeekableReadStream *audioStream, uint32 &size,
 	return buffer;
 }
 
+/**
+ * Plays DPCM compressed SOL audio, decoding it while reading it from the
+ * given stream. Uncompressed SOL audio is played with a raw stream instead.
+ */
+class SOLStream : public Audio::SeekableAudioStream {
+public:
+	SOLStream(Common::SeekableReadStream *stream, uint16 rate, byte audioFlags, uint32 size);
+	~SOLStream();
+
+	int readBuffer(int16 *buffer, const int numSamples);
+	bool isStereo() const { return false; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return _curSample >= _sampleCount; }
+	bool seek(const Audio::Timestamp &where);
+	Audio::Timestamp getLength() const { return Audio::Timestamp(0, _sampleCount, _rate); }
+
+private:
+	void reset();
+
+	Common::SeekableReadStream *_stream;
+	uint16 _rate;
+	bool _is16Bit;
+	bool _isUnsigned;
+	uint32 _sampleCount;
+	uint32 _curSample;
+	int32 _dpcmSample;	// current state of the DPCM decoder
+	byte _dpcmByte;		// 8-bit audio contains two samples per byte
+};
+
+SOLStream::SOLStream(Common::SeekableReadStream *stream, uint16 rate, byte audioFlags, uint32 size)
+	: _stream(stream), _rate(rate) {
+
+	_is16Bit = (audioFlags & kSolFlag16Bit) != 0;
+	_isUnsigned = !(audioFlags & kSolFlagIsSigned);
+	// Every byte is decoded into a 16-bit sample or two 8-bit samples
+	_sampleCount = _is16Bit ? size : size * 2;
+	reset();
+}
+
+SOLStream::~SOLStream() {
+	delete _stream;
+}
+
+void SOLStream::reset() {
+	_stream->seek(0, SEEK_SET);
+	_curSample = 0;
+	_dpcmSample = _is16Bit ? 0 : 0x80;
+	_dpcmByte = 0;
+}
+
+int SOLStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = MIN<uint32>(numSamples, _sampleCount - _curSample);
+
+	// Same decoding as done by deDPCM16() and deDPCM8() plus the conversion
+	// done by the raw audio stream for the respective flags
+	for (int i = 0; i < samples; i++) {
+		if (_is16Bit) {
+			byte b = _stream->readByte();
+			if (b & 0x80)
+				_dpcmSample -= tableDPCM16[b & 0x7f];
+			else
+				_dpcmSample += tableDPCM16[b];
+			_dpcmSample = CLIP<int32>(_dpcmSample, -32768, 32767);
+			buffer[i] = _isUnsigned ? (int16)(_dpcmSample ^ 0x8000) : (int16)_dpcmSample;
+		} else {
+			byte sample;
+			if (!(_curSample & 1)) {
+				_dpcmByte = _stream->readByte();
+				deDPCM8Nibble(&sample, _dpcmSample, _dpcmByte >> 4);
+			} else {
+				deDPCM8Nibble(&sample, _dpcmSample, _dpcmByte & 0xf);
+			}
+			buffer[i] = _isUnsigned ? (int16)((sample ^ 0x80) << 8) : (int16)(sample << 8);
+		}
+		_curSample++;
+	}
+
+	return samples;
+}
+
+bool SOLStream::seek(const Audio::Timestamp &where) {
+	uint32 targetSample = Audio::convertTimeToStreamPos(where, _rate, false).totalNumberOfFrames();
+	if (targetSample > _sampleCount)
+		return false;
+
+	// DPCM can only be decoded from the start
+	if (targetSample < _curSample)
+		reset();
+
+	int16 buffer[512];
+	while (_curSample < targetSample)
+		readBuffer(buffer, MIN<uint32>(ARRAYSIZE(buffer), targetSample - _curSample));
+
+	return true;
+}
+
 byte *AudioPlayer::getDecodedRobotAudioFrame(Common::SeekableReadStream *str, uint32 encodedSize) {
 	byte flags = 0;
 	return readSOLAudio(str, encodedSize, kSolFlagCompressed | kSolFlag16Bit, flags);
 }
 
+Audio::SeekableAudioStream *AudioPlayer::getCachedAudioStream(ResourceId id) {
+	for (AudioCacheList::iterator it = _audioCache.begin(); it != _audioCache.end(); ++it) {
+		if (it->id == id) {
+			// Move it to the front, so that it gets evicted last
+			if (it != _audioCache.begin()) {
+				_audioCache.push_front(*it);
+				_audioCache.erase(it);
+			}
+
+			// The cached data can't be handed out directly, it may get
+			// evicted while the stream is still playing
+			AudioCacheEntry &entry = _audioCache.front();
+			byte *data = (byte *)malloc(entry.size);
+			assert(data);
+			memcpy(data, entry.data, entry.size);
+			_audioRate = entry.rate;
+			return Audio::makeRawStream(data, entry.size, entry.rate, entry.flags);
+		}
+	}
+
+	return NULL;
+}
+
+void AudioPlayer::cacheAudio(ResourceId id, const byte *data, uint32 size, byte flags) {
+	if (size > MAX_CACHED_AUDIO_SAMPLE_SIZE)
+		return;
+
+	while (_audioCacheMemory + size > MAX_CACHED_AUDIO_MEMORY) {
+		AudioCacheEntry &oldEntry = _audioCache.back();
+		_audioCacheMemory -= oldEntry.size;
+		free(oldEntry.data);
+		_audioCache.pop_back();
+	}
+
+	AudioCacheEntry entry;
+	entry.id = id;
+	entry.data = (byte *)malloc(size);
+	assert(entry.data);
+	memcpy(entry.data, data, size);
+	entry.size = size;
+	entry.rate = _audioRate;
+	entry.flags = flags;
+	_audioCache.push_front(entry);
+	_audioCacheMemory += size;
+}
+
+void AudioPlayer::purgeAudioCache() {
+	for (AudioCacheList::iterator it = _audioCache.begin(); it != _audioCache.end(); ++it)
+		free(it->data);
+	_audioCache.clear();
+	_audioCacheMemory = 0;
+}
+
+Audio::SeekableAudioStream *AudioPlayer::makeSOLStream(ResourceId id, Common::SeekableReadStream *dataStream, uint32 size, byte audioFlags) {
+	uint32 decodedSize = (audioFlags & kSolFlagCompressed) ? size * 2 : size;
+	byte flags = 0;
+
+	if (decodedSize <= MAX_CACHED_AUDIO_SAMPLE_SIZE) {
+		// Short sample, decode it completely and keep it around
+		byte *data = readSOLAudio(dataStream, size, audioFlags, flags);
+		delete dataStream;
+		cacheAudio(id, data, size, flags);
+		return Audio::makeRawStream(data, size, _audioRate, flags);
+	}
+
+	if (audioFlags & kSolFlagCompressed)
+		return new SOLStream(dataStream, _audioRate, audioFlags, size);
+
+	// Convert the SOL stream flags to our own format, see readSOLAudio()
+	if (audioFlags & kSolFlag16Bit)
+		flags |= Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN;
+	if (!(audioFlags & kSolFlagIsSigned))
+		flags |= Audio::FLAG_UNSIGNED;
+
+	return Audio::makeRawStream(new Common::SeekableSubReadStream(dataStream, 0, size, DisposeAfterUse::YES), _audioRate, flags);
+}
+
 Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32 volume, int *sampleLen) {
 	Audio::SeekableAudioStream *audioSeekStream = 0;
 	Audio::RewindableAudioStream *audioStream = 0;
 	uint32 size = 0;
-	byte *data = 0;
 	byte flags = 0;
-	Sci::Resource *audioRes;
 
 	*sampleLen = 0;
 
-	if (volume == 65535) {
-		audioRes = _resMan->findResource(ResourceId(kResourceTypeAudio, number), false);
-		if (!audioRes) {
-			warning("Failed to find audio entry %i", number);
-			return NULL;
-		}
-	} else {
-		audioRes = _resMan->findResource(ResourceId(kResourceTypeAudio36, volume, number), false);
+	ResourceId id = (volume == 65535) ? ResourceId(kResourceTypeAudio, number) : ResourceId(kResourceTypeAudio36, volume, number);
+
+	// Short samples, which got played before, are kept decoded in memory
+	audioSeekStream = getCachedAudioStream(id);
+	if (audioSeekStream) {
+		*sampleLen = (audioSeekStream->getLength().msecs() * 60) / 1000; // we translate msecs to ticks
+		return audioSeekStream;
+	}
+
+	// Audio resources are read directly from the audio volume while playing,
+	// instead of loading the whole resource first. Only resources, that
+	// can't be streamed (e.g. patches) or that are loaded already, are
+	// played from memory.
+	byte streamHeader[12];
+	const byte *header = streamHeader;
+	byte headerSize = 0;
+	uint32 audioCompressionType = 0;
+	Common::SeekableReadStream *dataStream = _resMan->getAudioResourceStream(id, streamHeader, headerSize, audioCompressionType);
+
+	if (!dataStream) {
+		Sci::Resource *audioRes = _resMan->findResource(id, false);
 		if (!audioRes) {
-			warning("Failed to find audio entry (%i, %i, %i, %i, %i)", volume, (number >> 24) & 0xff,
-					(number >> 16) & 0xff, (number >> 8) & 0xff, number & 0xff);
+			if (volume == 65535)
+				warning("Failed to find audio entry %i", number);
+			else
+				warning("Failed to find audio entry (%i, %i, %i, %i, %i)", volume, (number >> 24) & 0xff,
+						(number >> 16) & 0xff, (number >> 8) & 0xff, number & 0xff);
 			return NULL;
 		}
+
+		audioCompressionType = audioRes->getAudioCompressionType();
+		header = audioRes->_header;
+		headerSize = audioRes->_headerSize;
+
+		// We copy over the data in our own buffer. We have to do this,
+		// because ResourceManager may free the original data at any time.
+		byte *data = (byte *)malloc(audioRes->size);
+		assert(data);
+		memcpy(data, audioRes->data, audioRes->size);
+		dataStream = new Common::MemoryReadStream(data, audioRes->size, DisposeAfterUse::YES);
 	}
 
 	byte audioFlags;
-	uint32 audioCompressionType = audioRes->getAudioCompressionType();
 
 	if (audioCompressionType) {
 #if (defined(USE_MAD) || defined(USE_VORBIS) || defined(USE_FLAC))
 		// Compressed audio made by our tool
-		byte *compressedData = (byte *)malloc(audioRes->size);
-		assert(compressedData);
-		// We copy over the compressed data in our own buffer. We have to do
-		// this, because ResourceManager may free the original data late. All
-		// other compression types already decompress completely into an
-		// additional buffer here. MP3/OGG/FLAC decompression works on-the-fly
-		// instead.
-		memcpy(compressedData, audioRes->data, audioRes->size);
-		Common::SeekableReadStream *compressedStream = new Common::MemoryReadStream(compressedData, audioRes->size, DisposeAfterUse::YES);
-
+		// MP3/OGG/FLAC decompression works on-the-fly
 		switch (audioCompressionType) {
 		case MKTAG('M','P','3',' '):
 #ifdef USE_MAD
-			audioSeekStream = Audio::makeMP3Stream(compressedStream, DisposeAfterUse::YES);
+			audioSeekStream = Audio::makeMP3Stream(dataStream, DisposeAfterUse::YES);
+			dataStream = 0;
 #endif
 			break;
 		case MKTAG('O','G','G',' '):
 #ifdef USE_VORBIS
-			audioSeekStream = Audio::makeVorbisStream(compressedStream, DisposeAfterUse::YES);
+			audioSeekStream = Audio::makeVorbisStream(dataStream, DisposeAfterUse::YES);
+			dataStream = 0;
 #endif
 			break;
 		case MKTAG('F','L','A','C'):
 #ifdef USE_FLAC
-			audioSeekStream = Audio::makeFLACStream(compressedStream, DisposeAfterUse::YES);
+			audioSeekStream = Audio::makeFLACStream(dataStream, DisposeAfterUse::YES);
+			dataStream = 0;
 #endif
 			break;
 		}
@@ -309,58 +503,69 @@ Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32
 #endif
 	} else {
 		// Original source file
-		if (audioRes->_headerSize > 0) {
+		byte signature[15];
+		uint32 signatureSize = dataStream->read(signature, sizeof(signature));
+		dataStream->seek(0, SEEK_SET);
+
+		if (headerSize > 0) {
 			// SCI1.1
-			Common::MemoryReadStream headerStream(audioRes->_header, audioRes->_headerSize, DisposeAfterUse::NO);
+			Common::MemoryReadStream headerStream(header, headerSize, DisposeAfterUse::NO);
 
-			if (readSOLHeader(&headerStream, audioRes->_headerSize, size, _audioRate, audioFlags, audioRes->size)) {
-				Common::MemoryReadStream dataStream(audioRes->data, audioRes->size, DisposeAfterUse::NO);
-				data = readSOLAudio(&dataStream, size, audioFlags, flags);
+			if (readSOLHeader(&headerStream, headerSize, size, _audioRate, audioFlags, dataStream->size())) {
+				audioSeekStream = makeSOLStream(id, dataStream, size, audioFlags);
+				dataStream = 0;
 			}
-		} else if (audioRes->size > 4 && READ_BE_UINT32(audioRes->data) == MKTAG('R','I','F','F')) {
+		} else if (signatureSize > 4 && READ_BE_UINT32(signature) == MKTAG('R','I','F','F')) {
 			// WAVE detected
-			Common::SeekableReadStream *waveStream = new Common::MemoryReadStream(audioRes->data, audioRes->size, DisposeAfterUse::NO);
 
 			// Calculate samplelen from WAVE header
 			int waveSize = 0, waveRate = 0;
 			byte waveFlags = 0;
-			Audio::loadWAVFromStream(*waveStream, waveSize, waveRate, waveFlags);
+			Audio::loadWAVFromStream(*dataStream, waveSize, waveRate, waveFlags);
 			*sampleLen = (waveFlags & Audio::FLAG_16BITS ? waveSize >> 1 : waveSize) * 60 / waveRate;
 
-			waveStream->seek(0, SEEK_SET);
-			audioStream = Audio::makeWAVStream(waveStream, DisposeAfterUse::YES);
-		} else if (audioRes->size > 4 && READ_BE_UINT32(audioRes->data) == MKTAG('F','O','R','M')) {
+			dataStream->seek(0, SEEK_SET);
+			audioStream = Audio::makeWAVStream(dataStream, DisposeAfterUse::YES);
+			dataStream = 0;
+		} else if (signatureSize > 4 && READ_BE_UINT32(signature) == MKTAG('F','O','R','M')) {
 			// AIFF detected
-			Common::SeekableReadStream *waveStream = new Common::MemoryReadStream(audioRes->data, audioRes->size, DisposeAfterUse::NO);
 
 			// Calculate samplelen from AIFF header
 			int waveSize = 0, waveRate = 0;
 			byte waveFlags = 0;
-			Audio::loadAIFFFromStream(*waveStream, waveSize, waveRate, waveFlags);
+			Audio::loadAIFFFromStream(*dataStream, waveSize, waveRate, waveFlags);
 			*sampleLen = (waveFlags & Audio::FLAG_16BITS ? waveSize >> 1 : waveSize) * 60 / waveRate;
 
-			waveStream->seek(0, SEEK_SET);
-			audioStream = Audio::makeAIFFStream(waveStream, DisposeAfterUse::YES);
-		} else if (audioRes->size > 14 && READ_BE_UINT16(audioRes->data) == 1 && READ_BE_UINT16(audioRes->data + 2) == 1
-				&& READ_BE_UINT16(audioRes->data + 4) == 5 && READ_BE_UINT32(audioRes->data + 10) == 0x00018051) {
+			dataStream->seek(0, SEEK_SET);
+			audioStream = Audio::makeAIFFStream(dataStream, DisposeAfterUse::YES);
+			dataStream = 0;
+		} else if (signatureSize > 14 && READ_BE_UINT16(signature) == 1 && READ_BE_UINT16(signature + 2) == 1
+				&& READ_BE_UINT16(signature + 4) == 5 && READ_BE_UINT32(signature + 10) == 0x00018051) {
 			// Mac snd detected
-			Common::SeekableReadStream *sndStream = new Common::MemoryReadStream(audioRes->data, audioRes->size, DisposeAfterUse::NO);
-
-			audioSeekStream = Audio::makeMacSndStream(sndStream, DisposeAfterUse::YES);
+			audioSeekStream = Audio::makeMacSndStream(dataStream, DisposeAfterUse::YES);
+			dataStream = 0;
 		} else {
 			// SCI1 raw audio
-			size = audioRes->size;
-			data = (byte *)malloc(size);
-			assert(data);
-			memcpy(data, audioRes->data, size);
+			size = dataStream->size();
 			flags = Audio::FLAG_UNSIGNED;
 			_audioRate = 11025;
-		}
 
-		if (data)
-			audioSeekStream = Audio::makeRawStream(data, size, _audioRate, flags);
+			if (size <= MAX_CACHED_AUDIO_SAMPLE_SIZE) {
+				byte *data = (byte *)malloc(size);
+				assert(data);
+				dataStream->read(data, size);
+				cacheAudio(id, data, size, flags);
+				audioSeekStream = Audio::makeRawStream(data, size, _audioRate, flags);
+			} else {
+				audioSeekStream = Audio::makeRawStream(dataStream, _audioRate, flags);
+				dataStream = 0;
+			}
+		}
 	}
 
+	// Whoever took over the data stream has set dataStream to 0
+	delete dataStream;
+
 	if (audioSeekStream) {
 		*sampleLen = (audioSeekStream->getLength().msecs() * 60) / 1000; // we translate msecs to ticks
 		audioStream = audioSeekStream;
@@ -24,11 +24,14 @@
 #ifndef SCI_AUDIO_H
 #define SCI_AUDIO_H
 
+#include "common/list.h"
+#include "sci/resource.h"
 #include "sci/engine/vm_types.h"
 #include "audio/mixer.h"
 
 namespace Audio {
 class RewindableAudioStream;
+class SeekableAudioStream;
 } // End of namespace Audio
 
 namespace Sci {
@@ -54,11 +57,26 @@ enum AudioSyncCommands {
 
 #define AUDIO_VOLUME_MAX 127
 
+// Short samples (up to this size after decoding) are kept in memory, so that
+// frequently repeated sound effects don't need to be read and decoded again
+#define MAX_CACHED_AUDIO_SAMPLE_SIZE (64 * 1024)
+#define MAX_CACHED_AUDIO_MEMORY (1024 * 1024)
+
 class Resource;
-class ResourceId;
 class ResourceManager;
 class SegManager;
 
+struct AudioCacheEntry {
+	ResourceId id;
+	byte *data;		// decoded sample data, see Audio::makeRawStream()
+	uint32 size;
+	uint16 rate;
+	byte flags;
+};
+
+/** Cached samples, most recently used first */
+typedef Common::List<AudioCacheEntry> AudioCacheList;
+
 class AudioPlayer {
 public:
 	AudioPlayer(ResourceManager *resMan);
@@ -86,7 +104,13 @@ public:
 
 	void stopAllAudio();
 
+	void purgeAudioCache();
+
 private:
+	Audio::SeekableAudioStream *getCachedAudioStream(ResourceId id);
+	void cacheAudio(ResourceId id, const byte *data, uint32 size, byte flags);
+	Audio::SeekableAudioStream *makeSOLStream(ResourceId id, Common::SeekableReadStream *dataStream, uint32 size, byte audioFlags);
+
 	ResourceManager *_resMan;
 	uint16 _audioRate;
 	Audio::SoundHandle _audioHandle;
@@ -95,6 +119,9 @@ private:
 	uint _syncOffset;
 	uint32 _audioCdStart;
 	bool _wPlayFlag;
+
+	AudioCacheList _audioCache;
+	uint32 _audioCacheMemory;
 };
 
 } // End of namespace Sci
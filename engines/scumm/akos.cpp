@@ -338,6 +338,7 @@ void AkosRenderer::setPalette(uint16 *new_palette) {
 void AkosRenderer::setCostume(int costume, int shadow) {
 	const byte *akos = _vm->getResourceAddress(rtCostume, costume);
 	assert(akos);
+	_costumeId = costume;
 
 	akhd = (const AkosHeader *) _vm->findResourceData(MKTAG('A','K','H','D'), akos);
 	akof = (const AkosOffset *) _vm->findResourceData(MKTAG('A','K','O','F'), akos);
@@ -637,6 +638,73 @@ void AkosRenderer::codec1_genericDecode(Codec1 &v1) {
 	} while (1);
 }
 
+void AkosRenderer::codec1_drawCachedCel(Codec1 &v1, const CostumeCelCache::Cel &cel) {
+	// Same as codec1_genericDecode() without scaling, but only visits the
+	// opaque pixels of every column
+	const int xstart = _vm->_virtscr[kMainVirtScreen].xstart & 7;
+	int column = v1.celColumn;
+
+	while (column < cel.width) {
+		if (v1.x >= 0 && v1.x < v1.boundsRect.right) {
+			const byte maskbit = revBitMask(v1.x & 7);
+			const byte *mask = _vm->getMaskBuffer(v1.x - xstart, v1.y, _zbuf);
+
+			for (uint32 r = cel.columnRuns[column]; r < cel.columnRuns[column + 1]; r++) {
+				const CostumeCelCache::Run &run = cel.runs[r];
+				const byte *color = &cel.colors[run.colorOffset];
+				int row = run.row;
+				int rowEnd = run.row + run.length;
+
+				// Clip the run vertically
+				if (v1.y + row < v1.boundsRect.top) {
+					color += v1.boundsRect.top - v1.y - row;
+					row = v1.boundsRect.top - v1.y;
+				}
+				if (v1.y + rowEnd > v1.boundsRect.bottom)
+					rowEnd = v1.boundsRect.bottom - v1.y;
+
+				for (; row < rowEnd; row++, color++) {
+					if (mask[row * _numStrips] & maskbit)
+						continue;
+
+					byte *dst = v1.destptr + row * _out.pitch;
+					uint16 pcolor = _palette[*color];
+					if (_shadow_mode == 1) {
+						if (pcolor == 13)
+							pcolor = _shadow_table[*dst];
+					} else if (_shadow_mode == 3) {
+						if (_vm->_game.features & GF_16BIT_COLOR) {
+							uint16 srcColor = (pcolor >> 1) & 0x7DEF;
+							uint16 dstColor = (READ_UINT16(dst) >> 1) & 0x7DEF;
+							pcolor = srcColor + dstColor;
+						} else if (_vm->_game.heversion >= 90) {
+							pcolor = (pcolor << 8) + *dst;
+							pcolor = xmap[pcolor];
+						} else if (pcolor < 8) {
+							pcolor = (pcolor << 8) + *dst;
+							pcolor = _shadow_table[pcolor];
+						}
+					}
+					if (_vm->_bytesPerPixel == 2) {
+						WRITE_UINT16(dst, pcolor);
+					} else {
+						*dst = pcolor;
+					}
+				}
+			}
+		}
+
+		if (!--v1.skip_width)
+			return;
+		column++;
+
+		v1.x += v1.scaleXstep;
+		if (v1.x < 0 || v1.x >= v1.boundsRect.right)
+			return;
+		v1.destptr += v1.scaleXstep * _vm->_bytesPerPixel;
+	}
+}
+
 // This is exact duplicate of smallCostumeScaleTable[] in costume.cpp
 // See FIXME below for explanation
 const byte smallCostumeScaleTableAKOS[256] = {
@@ -940,6 +1008,13 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 		return 0;
 
 	v1.replen = 0;
+	v1.celColumn = 0;
+
+	// Unscaled limbs are drawn from the decoded cel cache. Shadow mode 2 is
+	// left to the generic decoder.
+	const CostumeCelCache::Cel *cel = 0;
+	if (!use_scaling && !_actorHitMode && _shadow_mode != 2)
+		cel = _celCache.getCel(_costumeId, _srcptr - akcd, _srcptr, _width, _height, v1.mask, v1.shr);
 
 	if (_mirror) {
 		if (!use_scaling)
@@ -947,7 +1022,10 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 
 		if (skip > 0) {
 			v1.skip_width -= skip;
-			codec1_ignorePakCols(v1, skip);
+			if (cel)
+				v1.celColumn = skip;
+			else
+				codec1_ignorePakCols(v1, skip);
 			v1.x = v1.boundsRect.left;
 		} else {
 			skip = rect.right - v1.boundsRect.right;
@@ -962,7 +1040,10 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 			skip = rect.right - v1.boundsRect.right + 1;
 		if (skip > 0) {
 			v1.skip_width -= skip;
-			codec1_ignorePakCols(v1, skip)	;
+			if (cel)
+				v1.celColumn = skip;
+			else
+				codec1_ignorePakCols(v1, skip);
 			v1.x = v1.boundsRect.right - 1;
 		} else {
 			skip = (v1.boundsRect.left -1) - rect.left;
@@ -996,7 +1077,10 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 
 	v1.destptr = (byte *)_out.pixels + v1.y * _out.pitch + v1.x * _vm->_bytesPerPixel;
 
-	codec1_genericDecode(v1);
+	if (cel)
+		codec1_drawCachedCel(v1, *cel);
+	else
+		codec1_genericDecode(v1);
 
 	return drawFlag;
 }
@@ -55,6 +55,7 @@ protected:
 class AkosRenderer : public BaseCostumeRenderer {
 protected:
 	uint16 _codec;
+	int _costumeId;
 
 	// actor _palette
 	uint16 _palette[256];
@@ -97,6 +98,7 @@ public:
 		akct = 0;
 		rgbs = 0;
 		xmap = 0;
+		_costumeId = 0;
 		_actorHitMode = false;
 	}
 
@@ -113,6 +115,7 @@ protected:
 
 	byte codec1(int xmoveCur, int ymoveCur);
 	void codec1_genericDecode(Codec1 &v1);
+	void codec1_drawCachedCel(Codec1 &v1, const CostumeCelCache::Cel &cel);
 	byte codec5(int xmoveCur, int ymoveCur);
 	byte codec16(int xmoveCur, int ymoveCur);
 	byte codec32(int xmoveCur, int ymoveCur);
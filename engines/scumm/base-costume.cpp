@@ -74,6 +74,148 @@ void BaseCostumeRenderer::codec1_ignorePakCols(Codec1 &v1, int num) {
 	} while (1);
 }
 
+CostumeCelCache::CostumeCelCache() {
+	_memoryUsage = 0;
+	_memoryBudget = MAX_COSTUME_CEL_CACHE_MEMORY;
+	_enabled = true;
+	resetStatistics();
+}
+
+CostumeCelCache::~CostumeCelCache() {
+	clear();
+}
+
+const CostumeCelCache::Cel *CostumeCelCache::getCel(int costume, uint32 offset, const byte *src, int width, int height, byte mask, byte shr) {
+	if (!_enabled || width <= 0 || height <= 0)
+		return 0;
+
+	Key key;
+	key.costume = costume;
+	key.offset = offset;
+	key.shr = shr;
+
+	CelMap::iterator it = _cels.find(key);
+	if (it != _cels.end()) {
+		Entry *entry = it->_value;
+		if (entry->cel.width == width && entry->cel.height == height) {
+			_stats.hits++;
+			_lru.erase(entry->lruPos);
+			_lru.push_front(entry);
+			entry->lruPos = _lru.begin();
+			return &entry->cel;
+		}
+
+		// Same data decoded with different dimensions, replace it
+		_memoryUsage -= entry->cel.memorySize;
+		_lru.erase(entry->lruPos);
+		_cels.erase(it);
+		delete entry;
+	}
+
+	_stats.misses++;
+
+	Entry *entry = new Entry();
+	entry->key = key;
+	decodeCel(entry->cel, src, width, height, mask, shr);
+
+	_memoryUsage += entry->cel.memorySize;
+	_lru.push_front(entry);
+	entry->lruPos = _lru.begin();
+	_cels[key] = entry;
+
+	// Keep the new cel, even if it alone is larger than the budget
+	evictCels(MAX(_memoryBudget, entry->cel.memorySize));
+
+	return &entry->cel;
+}
+
+void CostumeCelCache::decodeCel(Cel &cel, const byte *src, int width, int height, byte mask, byte shr) {
+	const uint32 numPixels = width * height;
+	byte *pixels = new byte[numPixels];
+
+	// Unpack the RLE data, which is stored column by column. A run length
+	// of 0 means 256, just like in the renderers.
+	uint32 pos = 0;
+	while (pos < numPixels) {
+		byte len = *src++;
+		byte color = len >> shr;
+		len &= mask;
+		if (!len)
+			len = *src++;
+
+		uint32 count = len ? len : 256;
+		if (count > numPixels - pos)
+			count = numPixels - pos;
+		memset(pixels + pos, color, count);
+		pos += count;
+	}
+
+	cel.width = width;
+	cel.height = height;
+	cel.columnRuns.resize(width + 1);
+
+	const byte *column = pixels;
+	for (int x = 0; x < width; x++, column += height) {
+		cel.columnRuns[x] = cel.runs.size();
+		int y = 0;
+		while (y < height) {
+			if (!column[y]) {
+				y++;
+				continue;
+			}
+
+			Run run;
+			run.row = y;
+			run.colorOffset = cel.colors.size();
+			while (y < height && column[y])
+				cel.colors.push_back(column[y++]);
+			run.length = y - run.row;
+			cel.runs.push_back(run);
+		}
+	}
+	cel.columnRuns[width] = cel.runs.size();
+
+	delete[] pixels;
+
+	cel.memorySize = sizeof(Entry) + cel.columnRuns.size() * sizeof(uint32) + cel.runs.size() * sizeof(Run) + cel.colors.size();
+}
+
+void CostumeCelCache::evictCels(uint32 maxMemory) {
+	while (_memoryUsage > maxMemory && !_lru.empty()) {
+		Entry *entry = _lru.back();
+		_lru.pop_back();
+		_cels.erase(entry->key);
+		_memoryUsage -= entry->cel.memorySize;
+		delete entry;
+		_stats.evictions++;
+	}
+}
+
+void CostumeCelCache::clear() {
+	for (LRUList::iterator it = _lru.begin(); it != _lru.end(); ++it)
+		delete *it;
+	_lru.clear();
+	_cels.clear();
+	_memoryUsage = 0;
+}
+
+void CostumeCelCache::enable(bool enable) {
+	_enabled = enable;
+	if (!enable)
+		clear();
+}
+
+void CostumeCelCache::setMemoryBudget(uint32 budget) {
+	_memoryBudget = budget;
+	evictCels(budget);
+}
+
+void CostumeCelCache::resetStatistics() {
+	_stats.hits = 0;
+	_stats.misses = 0;
+	_stats.evictions = 0;
+}
+
 bool ScummEngine::isCostumeInUse(int cost) const {
 	int i;
 	Actor *a;
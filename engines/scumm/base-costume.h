@@ -24,6 +24,9 @@
 #define SCUMM_BASE_COSTUME_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
 #include "scumm/actor.h"		// for CostumeData
 
 namespace Scumm {
@@ -63,6 +66,102 @@ public:
 };
 
 
+// Default memory limit of the costume cel cache
+#define MAX_COSTUME_CEL_CACHE_MEMORY (1024 * 1024)
+
+/**
+ * Cache of decoded costume cels. A cel is kept as the runs of opaque pixels
+ * of each of its columns, so that unscaled limbs can be drawn without
+ * decoding their RLE data again, and without visiting transparent pixels.
+ * Cels are identified by costume and data offset, and the least recently
+ * used ones are evicted once the memory limit is exceeded.
+ */
+class CostumeCelCache {
+public:
+	struct Run {
+		uint16 row;
+		uint16 length;
+		uint32 colorOffset;
+	};
+
+	struct Cel {
+		int width, height;
+		Common::Array<uint32> columnRuns;	// first run of each column, plus the end of the last one
+		Common::Array<Run> runs;
+		Common::Array<byte> colors;
+		uint32 memorySize;
+	};
+
+	struct Statistics {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+	};
+
+	CostumeCelCache();
+	~CostumeCelCache();
+
+	/**
+	 * Returns the decoded cel for the RLE data at src, decoding it if it
+	 * isn't cached yet. The cel is identified by its costume and the offset
+	 * of its data inside the costume resource. Returns 0 if the cache is
+	 * disabled.
+	 */
+	const Cel *getCel(int costume, uint32 offset, const byte *src, int width, int height, byte mask, byte shr);
+
+	void clear();
+
+	void enable(bool enable);
+	bool isEnabled() const { return _enabled; }
+
+	void setMemoryBudget(uint32 budget);
+	uint32 getMemoryBudget() const { return _memoryBudget; }
+	uint32 getMemoryUsage() const { return _memoryUsage; }
+	uint getCelCount() const { return _cels.size(); }
+
+	const Statistics &getStatistics() const { return _stats; }
+	void resetStatistics();
+
+private:
+	struct Key {
+		int costume;
+		uint32 offset;
+		byte shr;
+
+		bool operator==(const Key &other) const {
+			return costume == other.costume && offset == other.offset && shr == other.shr;
+		}
+	};
+
+	struct Key_Hash {
+		uint operator()(const Key &key) const {
+			return (key.costume << 20) ^ key.offset ^ (key.shr << 28);
+		}
+	};
+
+	struct Entry;
+	typedef Common::List<Entry *> LRUList;
+
+	struct Entry {
+		Key key;
+		Cel cel;
+		LRUList::iterator lruPos;
+	};
+
+	typedef Common::HashMap<Key, Entry *, Key_Hash> CelMap;
+
+	void decodeCel(Cel &cel, const byte *src, int width, int height, byte mask, byte shr);
+	void evictCels(uint32 maxMemory);
+
+	CelMap _cels;
+	LRUList _lru;	// most recently used first
+	uint32 _memoryUsage;
+	uint32 _memoryBudget;
+	bool _enabled;
+	Statistics _stats;
+};
+
+
 /**
  * Base class for both ClassicCostumeRenderer and AkosRenderer.
  */
@@ -122,8 +221,11 @@ public:
 		// These ones aren't accessed from ARM code.
 		Common::Rect boundsRect;
 		int scaleXindex, scaleYindex;
+		int celColumn;
 	};
 
+	CostumeCelCache _celCache;
+
 	BaseCostumeRenderer(ScummEngine *scumm) {
 		_actorID = 0;
 		_shadow_mode = 0;
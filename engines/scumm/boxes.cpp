@@ -700,9 +700,7 @@ byte *ScummEngine::getBoxMatrixBaseAddr() {
  */
 int ScummEngine::getNextBox(byte from, byte to) {
 	const byte *boxm;
-	byte i;
 	const int numOfBoxes = getNumBoxes();
-	int dest = -1;
 
 	if (from == to)
 		return to;
@@ -716,31 +714,70 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	assert(from < numOfBoxes);
 	assert(to < numOfBoxes);
 
-	boxm = getBoxMatrixBaseAddr();
+	if (_game.version != 0 && _game.version <= 2) {
+		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
+		// The first numOfBoxes bytes contain indices to the start of the corresponding
+		// row (although that seems unnecessary to me - the value is easily computable.
+		boxm = getBoxMatrixBaseAddr();
+		boxm += numOfBoxes + boxm[from];
+		return (int8)boxm[to];
+	}
+
+	// WORKAROUND #2: In addition to the truncated box matrix handled in
+	// unpackBoxMatrix(), we have to add this special case to fix the scene
+	// in Indy3 where Indy meets Hitler in Berlin.
+	// See bug #770690 and also bug #774783.
+	if ((_game.id == GID_INDY3) && _roomResource == 46 && from == 1 && to == 0)
+		return 0;
+
+	if (!_boxRoutes->nextBoxValid || _boxRoutes->nextBoxCount != numOfBoxes)
+		unpackBoxMatrix(numOfBoxes);
+
+	return (int8)_boxRoutes->nextBox[numOfBoxes * from + to];
+}
+
+/**
+ * Fill the next box table used by getNextBox() from the box matrix of the
+ * current room. It stays valid until the box matrix is replaced.
+ */
+void ScummEngine::unpackBoxMatrix(int numOfBoxes) {
+	BoxRoutes &routes = *_boxRoutes;
+	int from, to;
+
+	routes.nextBox.resize(numOfBoxes * numOfBoxes);
+	routes.nextBoxCount = numOfBoxes;
+	routes.nextBoxValid = true;
+
+	if (!numOfBoxes)
+		return;
+
+	memset(&routes.nextBox[0], Actor::kInvalidBox, numOfBoxes * numOfBoxes);
 
 	if (_game.version == 0) {
 		// calculate shortest paths
 		byte *itineraryMatrix = (byte *)malloc(numOfBoxes * numOfBoxes);
 		calcItineraryMatrix(itineraryMatrix, numOfBoxes);
 
-		dest = to;
-		do {
-			dest = itineraryMatrix[numOfBoxes * from + dest];
-		} while (dest != Actor::kInvalidBox && !areBoxesNeighbors(from, dest));
+		for (from = 0; from < numOfBoxes; from++) {
+			for (to = 0; to < numOfBoxes; to++) {
+				if (from == to)
+					continue;
 
-		if (dest == Actor::kInvalidBox)
-			dest = -1;
+				int dest = to;
+				do {
+					dest = itineraryMatrix[numOfBoxes * from + dest];
+				} while (dest != Actor::kInvalidBox && !areBoxesNeighbors(from, dest));
+
+				routes.nextBox[numOfBoxes * from + to] = dest;
+			}
+		}
 
 		free(itineraryMatrix);
-		return dest;
-	} else if (_game.version <= 2) {
-		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
-		// The first numOfBoxes bytes contain indices to the start of the corresponding
-		// row (although that seems unnecessary to me - the value is easily computable.
-		boxm += numOfBoxes + boxm[from];
-		return (int8)boxm[to];
+		return;
 	}
 
+	const byte *boxm = getBoxMatrixBaseAddr();
+
 	// WORKAROUND #1: It seems that in some cases, the box matrix is corrupt
 	// (more precisely, is too short) in the datafiles already. In
 	// particular this seems to be the case in room 46 of Indy3 EGA (see
@@ -751,33 +788,25 @@ int ScummEngine::getNextBox(byte from, byte to) {
 	// since random data may follow after the resource in ScummVM.
 	//
 	// As a workaround, we add a check for the end of the box matrix
-	// resource, and abort the search once we reach the end.
+	// resource, and leave the remaining entries unconnected.
 	const byte *end = boxm + getResourceSize(rtMatrix, 1);
 
-	// WORKAROUND #2: In addition to the above, we have to add this special
-	// case to fix the scene in Indy3 where Indy meets Hitler in Berlin.
-	// See bug #770690 and also bug #774783.
-	if ((_game.id == GID_INDY3) && _roomResource == 46 && from == 1 && to == 0)
-		return 0;
-
-	// Skip up to the matrix data for box 'from'
-	for (i = 0; i < from && boxm < end; i++) {
-		while (boxm < end && *boxm != 0xFF)
+	// Each row holds triples of a range of destination boxes and the box
+	// to go to next for them; later triples override earlier ones.
+	for (from = 0; from < numOfBoxes; from++) {
+		byte *row = &routes.nextBox[numOfBoxes * from];
+		while (boxm < end && boxm[0] != 0xFF) {
+			for (to = boxm[0]; to <= boxm[1] && to < numOfBoxes; to++)
+				row[to] = boxm[2];
 			boxm += 3;
-		boxm++;
-	}
+		}
 
-	// Now search for the entry for box 'to'
-	while (boxm < end && boxm[0] != 0xFF) {
-		if (boxm[0] <= to && to <= boxm[1])
-			dest = (int8)boxm[2];
-		boxm += 3;
+		if (boxm >= end) {
+			debug(0, "The box matrix apparently is truncated (room %d)", _roomResource);
+			break;
+		}
+		boxm++;
 	}
-
-	if (boxm >= end)
-		debug(0, "The box matrix apparently is truncated (room %d)", _roomResource);
-
-	return dest;
 }
 
 /*
@@ -788,131 +817,209 @@ bool Actor::findPathTowards(byte box1nr, byte box2nr, byte box3nr, Common::Point
 	assert(_vm->_game.version >= 3);
 	BoxCoords box1 = _vm->getBoxCoordinates(box1nr);
 	BoxCoords box2 = _vm->getBoxCoordinates(box2nr);
-	Common::Point tmp;
-	int i, j;
-	int flag;
 	int q, pos;
 
-	for (i = 0; i < 4; i++) {
-		for (j = 0; j < 4; j++) {
-			if (box1.ul.x == box1.ur.x && box1.ul.x == box2.ul.x && box1.ul.x == box2.ur.x) {
-				flag = 0;
-				if (box1.ul.y > box1.ur.y) {
-					SWAP(box1.ul.y, box1.ur.y);
-					flag |= 1;
-				}
+	// Rotate the boxes so that their "upper" sides are the ones touching
+	// each other, and walk towards the part they have in common.
+	const int edge = _vm->getSharedBoxEdge(box1nr, box2nr, box1, box2);
+
+	if (edge == BoxRoutes::kEdgeVertical) {
+		if (box1.ul.y > box1.ur.y)
+			SWAP(box1.ul.y, box1.ur.y);
+		if (box2.ul.y > box2.ur.y)
+			SWAP(box2.ul.y, box2.ur.y);
+
+		pos = _pos.y;
+		if (box2nr == box3nr) {
+			int diffX = _walkdata.dest.x - _pos.x;
+			int diffY = _walkdata.dest.y - _pos.y;
+			int boxDiffX = box1.ul.x - _pos.x;
+
+			if (diffX != 0) {
+				int t;
+
+				diffY *= boxDiffX;
+				t = diffY / diffX;
+				if (t == 0 && (diffY <= 0 || diffX <= 0)
+						&& (diffY >= 0 || diffX >= 0))
+					t = -1;
+				pos = _pos.y + t;
+			}
+		}
 
-				if (box2.ul.y > box2.ur.y) {
-					SWAP(box2.ul.y, box2.ur.y);
-					flag |= 2;
-				}
+		q = pos;
+		if (q < box2.ul.y)
+			q = box2.ul.y;
+		if (q > box2.ur.y)
+			q = box2.ur.y;
+		if (q < box1.ul.y)
+			q = box1.ul.y;
+		if (q > box1.ur.y)
+			q = box1.ur.y;
+		if (q == pos && box2nr == box3nr)
+			return true;
+		foundPath.y = q;
+		foundPath.x = box1.ul.x;
+		return false;
+	}
 
-				if (box1.ul.y > box2.ur.y || box2.ul.y > box1.ur.y ||
-						((box1.ur.y == box2.ul.y || box2.ur.y == box1.ul.y) &&
-						box1.ul.y != box1.ur.y && box2.ul.y != box2.ur.y)) {
-					if (flag & 1)
-						SWAP(box1.ul.y, box1.ur.y);
-					if (flag & 2)
-						SWAP(box2.ul.y, box2.ur.y);
-				} else {
-					pos = _pos.y;
-					if (box2nr == box3nr) {
-						int diffX = _walkdata.dest.x - _pos.x;
-						int diffY = _walkdata.dest.y - _pos.y;
-						int boxDiffX = box1.ul.x - _pos.x;
-
-						if (diffX != 0) {
-							int t;
-
-							diffY *= boxDiffX;
-							t = diffY / diffX;
-							if (t == 0 && (diffY <= 0 || diffX <= 0)
-									&& (diffY >= 0 || diffX >= 0))
-								t = -1;
-							pos = _pos.y + t;
-						}
-					}
+	if (edge == BoxRoutes::kEdgeHorizontal) {
+		if (box1.ul.x > box1.ur.x)
+			SWAP(box1.ul.x, box1.ur.x);
+		if (box2.ul.x > box2.ur.x)
+			SWAP(box2.ul.x, box2.ur.x);
 
-					q = pos;
-					if (q < box2.ul.y)
-						q = box2.ul.y;
-					if (q > box2.ur.y)
-						q = box2.ur.y;
-					if (q < box1.ul.y)
-						q = box1.ul.y;
-					if (q > box1.ur.y)
-						q = box1.ur.y;
-					if (q == pos && box2nr == box3nr)
-						return true;
-					foundPath.y = q;
-					foundPath.x = box1.ul.x;
-					return false;
-				}
+		if (box2nr == box3nr) {
+			int diffX = _walkdata.dest.x - _pos.x;
+			int diffY = _walkdata.dest.y - _pos.y;
+			int boxDiffY = box1.ul.y - _pos.y;
+
+			pos = _pos.x;
+			if (diffY != 0) {
+				pos += diffX * boxDiffY / diffY;
 			}
+		} else {
+			pos = _pos.x;
+		}
 
-			if (box1.ul.y == box1.ur.y && box1.ul.y == box2.ul.y && box1.ul.y == box2.ur.y) {
-				flag = 0;
-				if (box1.ul.x > box1.ur.x) {
-					SWAP(box1.ul.x, box1.ur.x);
-					flag |= 1;
-				}
+		q = pos;
+		if (q < box2.ul.x)
+			q = box2.ul.x;
+		if (q > box2.ur.x)
+			q = box2.ur.x;
+		if (q < box1.ul.x)
+			q = box1.ul.x;
+		if (q > box1.ur.x)
+			q = box1.ur.x;
+		if (q == pos && box2nr == box3nr)
+			return true;
+		foundPath.x = q;
+		foundPath.y = box1.ul.y;
+		return false;
+	}
 
-				if (box2.ul.x > box2.ur.x) {
-					SWAP(box2.ul.x, box2.ur.x);
-					flag |= 2;
-				}
+	return false;
+}
 
-				if (box1.ul.x > box2.ur.x || box2.ul.x > box1.ur.x ||
-						((box1.ur.x == box2.ul.x || box2.ur.x == box1.ul.x) &&
-						box1.ul.x != box1.ur.x && box2.ul.x != box2.ur.x)) {
-					if (flag & 1)
-						SWAP(box1.ul.x, box1.ur.x);
-					if (flag & 2)
-						SWAP(box2.ul.x, box2.ur.x);
-				} else {
+static void rotateBox(BoxCoords &box) {
+	Common::Point tmp = box.ul;
+	box.ul = box.ur;
+	box.ur = box.lr;
+	box.lr = box.ll;
+	box.ll = tmp;
+}
 
-					if (box2nr == box3nr) {
-						int diffX = _walkdata.dest.x - _pos.x;
-						int diffY = _walkdata.dest.y - _pos.y;
-						int boxDiffY = box1.ul.y - _pos.y;
-
-						pos = _pos.x;
-						if (diffY != 0) {
-							pos += diffX * boxDiffY / diffY;
-						}
-					} else {
-						pos = _pos.x;
-					}
+/** Check if the sides [a1, a2] and [b1, b2] on one line share more than a corner. */
+static bool sidesOverlap(int a1, int a2, int b1, int b2) {
+	if (a1 > a2)
+		SWAP(a1, a2);
+	if (b1 > b2)
+		SWAP(b1, b2);
 
-					q = pos;
-					if (q < box2.ul.x)
-						q = box2.ul.x;
-					if (q > box2.ur.x)
-						q = box2.ur.x;
-					if (q < box1.ul.x)
-						q = box1.ul.x;
-					if (q > box1.ur.x)
-						q = box1.ur.x;
-					if (q == pos && box2nr == box3nr)
-						return true;
-					foundPath.x = q;
-					foundPath.y = box1.ul.y;
-					return false;
-				}
-			}
-			tmp = box1.ul;
-			box1.ul = box1.ur;
-			box1.ur = box1.lr;
-			box1.lr = box1.ll;
-			box1.ll = tmp;
+	return !(a1 > b2 || b1 > a2 ||
+			((a2 == b1 || b2 == a1) && a1 != a2 && b1 != b2));
+}
+
+/**
+ * Search the sides of box1 and box2 that touch each other. Box2 is rotated
+ * in the outer and box1 in the inner loop, and the first match wins.
+ * Returns the number of rotations of each box and the orientation of the
+ * sides, encoded as used by the shared edge cache, or kEdgeNone.
+ */
+static byte findSharedEdge(BoxCoords box1, BoxCoords box2) {
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			if (box1.ul.x == box1.ur.x && box1.ul.x == box2.ul.x && box1.ul.x == box2.ur.x &&
+					sidesOverlap(box1.ul.y, box1.ur.y, box2.ul.y, box2.ur.y))
+				return (i << 3) | (j << 1) | BoxRoutes::kEdgeVertical;
+
+			if (box1.ul.y == box1.ur.y && box1.ul.y == box2.ul.y && box1.ul.y == box2.ur.y &&
+					sidesOverlap(box1.ul.x, box1.ur.x, box2.ul.x, box2.ur.x))
+				return (i << 3) | (j << 1) | BoxRoutes::kEdgeHorizontal;
+
+			rotateBox(box1);
 		}
-		tmp = box2.ul;
-		box2.ul = box2.ur;
-		box2.ur = box2.lr;
-		box2.lr = box2.ll;
-		box2.ll = tmp;
+		rotateBox(box2);
 	}
-	return false;
+
+	return BoxRoutes::kEdgeNone;
+}
+
+static void prepareBoxGeometry(BoxRoutes &routes, int numOfBoxes) {
+	if (routes.geometryCount == numOfBoxes && !routes.edges.empty())
+		return;
+
+	routes.geometryCount = numOfBoxes;
+	routes.edges.resize(numOfBoxes * numOfBoxes);
+	routes.gates.resize(numOfBoxes * numOfBoxes);
+	for (int i = 0; i < numOfBoxes * numOfBoxes; i++) {
+		routes.edges[i] = BoxRoutes::kEdgeUnknown;
+		routes.gates[i].valid = false;
+	}
+}
+
+/**
+ * Find the sides of two boxes that touch each other. The given coordinates
+ * of both boxes are rotated so that these sides become their "upper" sides.
+ * Returns whether the sides are vertical or horizontal, or -1 if the boxes
+ * don't touch. The result only depends on the box coordinates, so it is
+ * cached per pair of boxes.
+ */
+int ScummEngine::getSharedBoxEdge(byte box1nr, byte box2nr, BoxCoords &box1, BoxCoords &box2) {
+	const int numOfBoxes = getNumBoxes();
+	byte edge;
+
+	if (box1nr < numOfBoxes && box2nr < numOfBoxes) {
+		prepareBoxGeometry(*_boxRoutes, numOfBoxes);
+		byte &cached = _boxRoutes->edges[numOfBoxes * box1nr + box2nr];
+		if (cached == BoxRoutes::kEdgeUnknown)
+			cached = findSharedEdge(box1, box2);
+		edge = cached;
+	} else {
+		edge = findSharedEdge(box1, box2);
+	}
+
+	if (edge == BoxRoutes::kEdgeNone)
+		return -1;
+
+	for (int i = 0; i < (edge >> 3); i++)
+		rotateBox(box2);
+	for (int j = 0; j < ((edge >> 1) & 3); j++)
+		rotateBox(box1);
+
+	return edge & 1;
+}
+
+/**
+ * Get the gates between two boxes (see getGates), cached per pair of boxes.
+ */
+void ScummEngine::getBoxGates(byte box1nr, byte box2nr, Common::Point gateA[2], Common::Point gateB[2]) {
+	const int numOfBoxes = getNumBoxes();
+
+	if (box1nr >= numOfBoxes || box2nr >= numOfBoxes) {
+		getGates(getBoxCoordinates(box1nr), getBoxCoordinates(box2nr), gateA, gateB);
+		return;
+	}
+
+	prepareBoxGeometry(*_boxRoutes, numOfBoxes);
+	BoxRoutes::Gate &gate = _boxRoutes->gates[numOfBoxes * box1nr + box2nr];
+	if (!gate.valid) {
+		getGates(getBoxCoordinates(box1nr), getBoxCoordinates(box2nr), gate.gateA, gate.gateB);
+		gate.valid = true;
+	}
+
+	gateA[0] = gate.gateA[0];
+	gateA[1] = gate.gateA[1];
+	gateB[0] = gate.gateB[0];
+	gateB[1] = gate.gateB[1];
+}
+
+/**
+ * Forget all routing data derived from the boxes, to be called whenever the
+ * box data of the room is replaced.
+ */
+void ScummEngine::resetBoxRoutes() {
+	_boxRoutes->invalidate();
 }
 
 #if BOX_DEBUG
@@ -1005,17 +1112,151 @@ void ScummEngine::calcItineraryMatrix(byte *itineraryMatrix, int num) {
 	free(adjacentMatrix);
 }
 
+/**
+ * Check if two boxes are neighbors, using the visibility recorded by
+ * updateItineraryMatrix() and caching the outcome of the geometric test.
+ */
+bool ScummEngine::areBoxesNeighborsCached(int box1nr, int box2nr) {
+	BoxRoutes &routes = *_boxRoutes;
+	const int boxSize = BoxRoutes::kMaxItineraryBoxes;
+
+	if (!routes.visible[box1nr] || !routes.visible[box2nr])
+		return false;
+
+	byte &neighbors = routes.neighbors[boxSize * box1nr + box2nr];
+	if (neighbors == BoxRoutes::kNeighborUnknown) {
+		// The test is symmetric, so fill in both directions
+		neighbors = areBoxesNeighbors(box1nr, box2nr) ? BoxRoutes::kNeighborYes : BoxRoutes::kNeighborNo;
+		routes.neighbors[boxSize * box2nr + box1nr] = neighbors;
+	}
+
+	return neighbors == BoxRoutes::kNeighborYes;
+}
+
+/**
+ * Bring the itinerary matrix of the current boxes up to date. The first
+ * call after the boxes were loaded computes all rows. Later calls only
+ * recompute the rows of the boxes connected to a box that was hidden or
+ * shown in the meantime, either before or after the change; all other
+ * boxes keep the same set of reachable boxes and thus the same routes.
+ */
+void ScummEngine::updateItineraryMatrix() {
+	BoxRoutes &routes = *_boxRoutes;
+	const int num = getNumBoxes();
+	const int boxSize = BoxRoutes::kMaxItineraryBoxes;
+	bool affected[BoxRoutes::kMaxItineraryBoxes];
+	int affectedBoxes[BoxRoutes::kMaxItineraryBoxes];
+	int numAffected = 0;
+	int i, j, k, b;
+
+	assert(num <= boxSize);
+
+	if (!routes.itineraryValid || routes.itineraryCount != num) {
+		memset(routes.neighbors, BoxRoutes::kNeighborUnknown, sizeof(routes.neighbors));
+		for (i = 0; i < num; i++) {
+			routes.visible[i] = !(getBoxFlags(i) & kBoxInvisible);
+			affected[i] = true;
+		}
+		routes.itineraryCount = num;
+		routes.itineraryValid = true;
+	} else {
+		bool changed[BoxRoutes::kMaxItineraryBoxes];
+		for (b = 0; b < num; b++) {
+			const bool visible = !(getBoxFlags(b) & kBoxInvisible);
+			changed[b] = (visible != routes.visible[b]);
+			routes.visible[b] = visible;
+		}
+
+		memset(affected, 0, sizeof(affected));
+		for (b = 0; b < num; b++) {
+			if (!changed[b])
+				continue;
+
+			// All boxes that could reach b so far...
+			for (i = 0; i < num; i++) {
+				if (routes.distance[boxSize * b + i] != 255)
+					affected[i] = true;
+			}
+
+			// ...and those that can reach it through its new neighbors
+			if (routes.visible[b]) {
+				for (j = 0; j < num; j++) {
+					if (j == b || !areBoxesNeighborsCached(b, j))
+						continue;
+					for (i = 0; i < num; i++) {
+						if (routes.distance[boxSize * j + i] != 255)
+							affected[i] = true;
+					}
+				}
+			}
+		}
+	}
+
+	for (i = 0; i < num; i++) {
+		if (affected[i])
+			affectedBoxes[numAffected++] = i;
+	}
+
+	debugC(DEBUG_ACTORS, "updateItineraryMatrix: updating %d of %d boxes", numAffected, num);
+
+	if (!numAffected)
+		return;
+
+	// Initialize the adjacent matrix of the affected boxes: each box has
+	// distance 0 to itself, and distance 1 to its direct neighbors.
+	// Initially, it has distance 255 (= infinity) to all other boxes.
+	// The affected boxes are never connected to the other ones.
+	for (k = 0; k < numAffected; k++) {
+		i = affectedBoxes[k];
+		for (j = 0; j < num; j++) {
+			if (i == j) {
+				routes.distance[i * boxSize + j] = 0;
+				routes.itinerary[i * boxSize + j] = j;
+			} else if (affected[j] && areBoxesNeighborsCached(i, j)) {
+				routes.distance[i * boxSize + j] = 1;
+				routes.itinerary[i * boxSize + j] = j;
+			} else {
+				routes.distance[i * boxSize + j] = 255;
+				routes.itinerary[i * boxSize + j] = Actor::kInvalidBox;
+			}
+		}
+	}
+
+	// Compute the shortest routes with Kleene's algorithm, as in
+	// calcItineraryMatrix(). Going through the affected boxes in
+	// ascending order gives the same routes as a run over all boxes.
+	byte *adjacentMatrix = routes.distance;
+	byte *itineraryMatrix = routes.itinerary;
+	for (int kk = 0; kk < numAffected; kk++) {
+		k = affectedBoxes[kk];
+		for (int ii = 0; ii < numAffected; ii++) {
+			i = affectedBoxes[ii];
+			for (int jj = 0; jj < numAffected; jj++) {
+				j = affectedBoxes[jj];
+				if (i == j)
+					continue;
+				byte distIK = adjacentMatrix[boxSize * i + k];
+				byte distKJ = adjacentMatrix[boxSize * k + j];
+				if (adjacentMatrix[boxSize * i + j] > distIK + distKJ) {
+					adjacentMatrix[boxSize * i + j] = distIK + distKJ;
+					itineraryMatrix[boxSize * i + j] = itineraryMatrix[boxSize * i + k];
+				}
+			}
+		}
+	}
+}
+
 void ScummEngine::createBoxMatrix() {
 	int num, i, j;
 
 	// The total number of boxes
 	num = getNumBoxes();
 
-	const uint8 boxSize = (_game.version == 0) ? num : 64;
+	const uint8 boxSize = BoxRoutes::kMaxItineraryBoxes;
 
 	// calculate shortest paths
-	byte *itineraryMatrix = (byte *)malloc(boxSize * boxSize);
-	calcItineraryMatrix(itineraryMatrix, num);
+	updateItineraryMatrix();
+	byte *itineraryMatrix = _boxRoutes->itinerary;
 
 	// "Compress" the distance matrix into the box matrix format used
 	// by the engine. The format is like this:
@@ -1057,7 +1298,8 @@ void ScummEngine::createBoxMatrix() {
 	printMatrix(getBoxMatrixBaseAddr(), num);
 #endif
 
-	free(itineraryMatrix);
+	// The box matrix was replaced, unpack it again when needed
+	_boxRoutes->nextBoxValid = false;
 }
 
 /** Check if two boxes are neighbors. */
@@ -1197,7 +1439,7 @@ void Actor_v3::findPathTowardsOld(byte box1, byte box2, byte finalBox, Common::P
 	Common::Point gateA[2];
 	Common::Point gateB[2];
 
-	getGates(_vm->getBoxCoordinates(box1), _vm->getBoxCoordinates(box2), gateA, gateB);
+	_vm->getBoxGates(box1, box2, gateA, gateB);
 
 	p2.x = 32000;
 	p3.x = 32000;
@@ -23,6 +23,7 @@
 #ifndef SCUMM_BOXES_H
 #define SCUMM_BOXES_H
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -51,6 +52,63 @@ struct BoxCoords {			/* Box coordinates */
 
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY);
 
+/**
+ * Routing data derived from the walkboxes of the current room, so that the
+ * path finding doesn't have to walk the box data on every actor step.
+ *
+ * It holds the box matrix unpacked into a table for getNextBox(), the
+ * itinerary computed by the last createBoxMatrix() call together with the
+ * box visibility it was computed for, and the shared edges and gates of the
+ * box pairs looked at by the path finding so far.
+ */
+struct BoxRoutes {
+	enum {
+		kMaxItineraryBoxes = 64,
+		kNeighborUnknown = 0,
+		kNeighborNo,
+		kNeighborYes,
+		kEdgeVertical = 0,
+		kEdgeHorizontal = 1,
+		kEdgeUnknown = 0xFF,
+		kEdgeNone = 0xFE
+	};
+
+	struct Gate {
+		bool valid;
+		Common::Point gateA[2];
+		Common::Point gateB[2];
+	};
+
+	// Next box on the way from one box to another, as stored in the box matrix
+	bool nextBoxValid;
+	int nextBoxCount;
+	Common::Array<byte> nextBox;
+
+	// Distances and itinerary computed by createBoxMatrix()
+	bool itineraryValid;
+	int itineraryCount;
+	bool visible[kMaxItineraryBoxes];
+	byte neighbors[kMaxItineraryBoxes * kMaxItineraryBoxes];
+	byte distance[kMaxItineraryBoxes * kMaxItineraryBoxes];
+	byte itinerary[kMaxItineraryBoxes * kMaxItineraryBoxes];
+
+	// Shared edge and gate geometry of box pairs
+	int geometryCount;
+	Common::Array<byte> edges;
+	Common::Array<Gate> gates;
+
+	BoxRoutes() { invalidate(); }
+
+	/** Forget everything, called whenever the box data is replaced. */
+	void invalidate() {
+		nextBoxValid = false;
+		itineraryValid = false;
+		geometryCount = 0;
+		edges.clear();
+		gates.clear();
+	}
+};
+
 } // End of namespace Scumm
 
 #endif
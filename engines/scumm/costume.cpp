@@ -229,6 +229,12 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		return 0;
 
 	v1.replen = 0;
+	v1.celColumn = 0;
+
+	// Unscaled limbs are drawn from the decoded cel cache
+	const CostumeCelCache::Cel *cel = 0;
+	if (!use_scaling && !newAmiCost && !pcEngCost && _loaded._format != 0x57)
+		cel = _celCache.getCel(_loaded._id, _srcptr - _loaded._baseptr, _srcptr, _width, _height, v1.mask, v1.shr);
 
 	if (_mirror) {
 		if (!use_scaling)
@@ -236,7 +242,10 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		if (skip > 0) {
 			if (!newAmiCost && !pcEngCost && _loaded._format != 0x57) {
 				v1.skip_width -= skip;
-				codec1_ignorePakCols(v1, skip);
+				if (cel)
+					v1.celColumn = skip;
+				else
+					codec1_ignorePakCols(v1, skip);
 				v1.x = 0;
 			}
 		} else {
@@ -253,7 +262,10 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		if (skip > 0) {
 			if (!newAmiCost && !pcEngCost && _loaded._format != 0x57) {
 				v1.skip_width -= skip;
-				codec1_ignorePakCols(v1, skip);
+				if (cel)
+					v1.celColumn = skip;
+				else
+					codec1_ignorePakCols(v1, skip);
 				v1.x = _out.w - 1;
 			}
 		} else {
@@ -305,6 +317,8 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		proc3_ami(v1);
 	else if (pcEngCost)
 		procPCEngine(v1);
+	else if (cel)
+		proc3_cached(v1, *cel);
 	else
 		proc3(v1);
 
@@ -518,6 +532,59 @@ void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 	} while (1);
 }
 
+void ClassicCostumeRenderer::proc3_cached(Codec1 &v1, const CostumeCelCache::Cel &cel) {
+	// Same as proc3() without scaling, but only visits the opaque pixels
+	// of every column
+	int column = v1.celColumn;
+
+	while (column < cel.width) {
+		if (v1.x >= 0 && v1.x < _out.w) {
+			const byte maskbit = revBitMask(v1.x & 7);
+			const byte *mask = v1.mask_ptr ? v1.mask_ptr + v1.x / 8 : 0;
+
+			for (uint32 r = cel.columnRuns[column]; r < cel.columnRuns[column + 1]; r++) {
+				const CostumeCelCache::Run &run = cel.runs[r];
+				const byte *color = &cel.colors[run.colorOffset];
+				int row = run.row;
+				int rowEnd = run.row + run.length;
+
+				// Clip the run vertically
+				if (v1.y + row < 0) {
+					color -= v1.y + row;
+					row = -v1.y;
+				}
+				if (v1.y + rowEnd > _out.h)
+					rowEnd = _out.h - v1.y;
+
+				for (; row < rowEnd; row++, color++) {
+					if (mask && (mask[row * _numStrips] & maskbit))
+						continue;
+
+					byte *dst = v1.destptr + row * _out.pitch;
+					uint pcolor;
+					if (_shadow_mode & 0x20) {
+						pcolor = _shadow_table[*dst];
+					} else {
+						pcolor = _palette[*color];
+						if (pcolor == 13 && _shadow_table)
+							pcolor = _shadow_table[*dst];
+					}
+					*dst = pcolor;
+				}
+			}
+		}
+
+		if (!--v1.skip_width)
+			return;
+		column++;
+
+		v1.x += v1.scaleXstep;
+		if (v1.x < 0 || v1.x >= _out.w)
+			return;
+		v1.destptr += v1.scaleXstep;
+	}
+}
+
 void ClassicCostumeRenderer::proc3_ami(Codec1 &v1) {
 	const byte *mask, *src;
 	byte *dst;
@@ -27,6 +27,7 @@
 #include "common/util.h"
 
 #include "scumm/actor.h"
+#include "scumm/base-costume.h"
 #include "scumm/boxes.h"
 #include "scumm/debugger.h"
 #include "scumm/imuse/imuse.h"
@@ -34,9 +35,15 @@
 #include "scumm/resource.h"
 #include "scumm/scumm.h"
 #include "scumm/sound.h"
+#ifdef ENABLE_SCUMM_7_8
+#include "scumm/scumm_v7.h"
+#include "scumm/smush/smush_player.h"
+#endif
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -96,6 +103,14 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	DCmd_Register("hide",      WRAP_METHOD(ScummDebugger, Cmd_Hide));
 
 	DCmd_Register("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
+	DCmd_Register("costume_cache", WRAP_METHOD(ScummDebugger, Cmd_CostumeCache));
+	DCmd_Register("strip_cache", WRAP_METHOD(ScummDebugger, Cmd_StripCache));
+	DCmd_Register("resources", WRAP_METHOD(ScummDebugger, Cmd_Resources));
+
+#ifdef ENABLE_SCUMM_7_8
+	if (_vm->_game.version >= 7)
+		DCmd_Register("smush_benchmark", WRAP_METHOD(ScummDebugger, Cmd_SmushBenchmark));
+#endif
 
 	DCmd_Register("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
 }
@@ -165,6 +180,124 @@ bool ScummDebugger::Cmd_IMuse(int argc, const char **argv) {
 	return true;
 }
 
+bool ScummDebugger::Cmd_CostumeCache(int argc, const char **argv) {
+	CostumeCelCache &cache = _vm->_costumeRenderer->_celCache;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			cache.enable(true);
+		} else if (!strcmp(argv[1], "off")) {
+			cache.enable(false);
+		} else if (!strcmp(argv[1], "clear")) {
+			cache.clear();
+			cache.resetStatistics();
+		} else if (!strcmp(argv[1], "budget") && argc > 2) {
+			cache.setMemoryBudget(atoi(argv[2]) * 1024);
+		} else {
+			DebugPrintf("Usage: %s [on|off|clear|budget <KB>]\n", argv[0]);
+			return true;
+		}
+	}
+
+	const CostumeCelCache::Statistics &stats = cache.getStatistics();
+	DebugPrintf("Costume cel cache: %s\n", cache.isEnabled() ? "enabled" : "disabled");
+	DebugPrintf("%d cels, %d of %d KB used\n", cache.getCelCount(), cache.getMemoryUsage() / 1024, cache.getMemoryBudget() / 1024);
+	DebugPrintf("%d hits, %d misses, %d evictions\n", stats.hits, stats.misses, stats.evictions);
+	return true;
+}
+
+bool ScummDebugger::Cmd_StripCache(int argc, const char **argv) {
+	BackgroundStripCache &cache = _vm->_gdi->_stripCache;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			cache.enable(true);
+		} else if (!strcmp(argv[1], "off")) {
+			cache.enable(false);
+		} else if (!strcmp(argv[1], "clear")) {
+			cache.clear();
+			cache.resetStatistics();
+		} else if (!strcmp(argv[1], "budget") && argc > 2) {
+			cache.setMemoryBudget(atoi(argv[2]) * 1024);
+		} else {
+			DebugPrintf("Usage: %s [on|off|clear|budget <KB>]\n", argv[0]);
+			return true;
+		}
+	}
+
+	const BackgroundStripCache::Statistics &stats = cache.getStatistics();
+	DebugPrintf("Background strip cache: %s\n", cache.isEnabled() ? "enabled" : "disabled");
+	DebugPrintf("%d strips, %d of %d KB used\n", cache.getStripCount(), cache.getMemoryUsage() / 1024, cache.getMemoryBudget() / 1024);
+	DebugPrintf("%d hits, %d misses, %d evictions\n", stats.hits, stats.misses, stats.evictions);
+	return true;
+}
+
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+
+	if (argc > 1) {
+		if (!strcmp(argv[1], "prefetch") && argc > 2 && (!strcmp(argv[2], "on") || !strcmp(argv[2], "off"))) {
+			res->_prefetchExpired = !strcmp(argv[2], "on");
+		} else if (!strcmp(argv[1], "reset")) {
+			res->resetStatistics();
+		} else {
+			DebugPrintf("Usage: %s [prefetch on|off|reset]\n", argv[0]);
+			return true;
+		}
+	}
+
+	DebugPrintf("%d KB allocated, expiring above %d KB down to %d KB, prefetching %s\n",
+		res->getAllocatedSize() / 1024, res->getMaxHeapThreshold() / 1024, res->getMinHeapThreshold() / 1024,
+		res->_prefetchExpired ? "enabled" : "disabled");
+	DebugPrintf("Type          Resident      KB  Hit rate   Loads  Reloads  Reload ms  Expired  Prefetched\n");
+
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		const ResourceManager::ResTypeStats &stats = res->_stats[type];
+		uint32 resident = 0, residentSize = 0;
+
+		for (ResId idx = 0; idx < res->_types[type].size(); idx++) {
+			if (res->_types[type][idx]._address) {
+				resident++;
+				residentSize += res->_types[type][idx]._size;
+			}
+		}
+
+		if (!resident && !stats.hits && !stats.misses)
+			continue;
+
+		const uint32 lookups = stats.hits + stats.misses;
+		DebugPrintf("%-12s  %8d  %6d  %7d%%  %6d  %7d  %9d  %7d  %5d/%-5d\n",
+			nameOfResType(type), resident, residentSize / 1024,
+			lookups ? stats.hits * 100 / lookups : 100, stats.loads, stats.reloads,
+			stats.reloads ? stats.reloadTime / stats.reloads : 0, stats.expired,
+			stats.prefetchHits, stats.prefetches);
+	}
+
+	return true;
+}
+
+#ifdef ENABLE_SCUMM_7_8
+bool ScummDebugger::Cmd_SmushBenchmark(int argc, const char **argv) {
+	if (argc != 2) {
+		DebugPrintf("Decodes all frames of a SMUSH movie without showing them\n");
+		DebugPrintf("Usage: %s <filename>\n", argv[0]);
+		return true;
+	}
+
+	uint32 frames, time;
+	if (!((ScummEngine_v7 *)_vm)->_splayer->benchmark(argv[1], frames, time)) {
+		DebugPrintf("Can't open %s\n", argv[1]);
+		return true;
+	}
+
+	DebugPrintf("Decoded %d frames in %d ms", frames, time);
+	if (time)
+		DebugPrintf(" (%d frames per second)", frames * 1000 / time);
+	DebugPrintf("\n");
+	return true;
+}
+#endif
+
 bool ScummDebugger::Cmd_Room(int argc, const char **argv) {
 	if (argc > 1) {
 		int room = atoi(argv[1]);
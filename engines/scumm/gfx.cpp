@@ -274,6 +274,7 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	_stripCache.clear();
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -286,6 +287,132 @@ void GdiPCEngine::roomChanged(byte *roomptr) {
 }
 #endif
 
+void Gdi::setTransparentColor(byte transparentColor) {
+	// Which strips are transparent depends on the transparent color
+	if (transparentColor != _transparentColor)
+		_stripCache.clear();
+	_transparentColor = transparentColor;
+}
+
+#pragma mark -
+#pragma mark --- Background strip cache ---
+#pragma mark -
+
+BackgroundStripCache::BackgroundStripCache() {
+	_stripCount = 0;
+	_memoryUsage = 0;
+	_memoryBudget = MAX_BACKGROUND_STRIP_CACHE_MEMORY;
+	_enabled = true;
+	resetStatistics();
+}
+
+BackgroundStripCache::~BackgroundStripCache() {
+	clear();
+}
+
+const byte *BackgroundStripCache::lookup(int stripnr, int height, int rowSize, uint16 planes) {
+	if (!_enabled)
+		return 0;
+
+	if (stripnr >= 0 && stripnr < (int)_strips.size()) {
+		const Strip &strip = _strips[stripnr];
+		if (strip.data && strip.height == height && strip.rowSize == rowSize && strip.planes == planes) {
+			_stats.hits++;
+			return strip.data;
+		}
+	}
+
+	_stats.misses++;
+	return 0;
+}
+
+byte *BackgroundStripCache::store(int stripnr, int height, int rowSize, uint16 planes, int centerStrip) {
+	if (!_enabled || stripnr < 0 || height <= 0)
+		return 0;
+
+	int numPlanes = 0;
+	for (uint16 p = planes; p; p >>= 1)
+		numPlanes += (p & 1);
+	const uint32 size = height * (rowSize + numPlanes);
+	if (size > _memoryBudget)
+		return 0;
+
+	if (stripnr >= (int)_strips.size()) {
+		const uint oldSize = _strips.size();
+		_strips.resize(stripnr + 1);
+		for (uint i = oldSize; i < _strips.size(); i++)
+			_strips[i].data = 0;
+	}
+
+	freeStrip(_strips[stripnr]);
+	if (!evictStrips(_memoryBudget - size, centerStrip))
+		return 0;
+
+	Strip &strip = _strips[stripnr];
+	strip.data = (byte *)malloc(size);
+	if (!strip.data)
+		return 0;
+	strip.size = size;
+	strip.height = height;
+	strip.rowSize = rowSize;
+	strip.planes = planes;
+
+	_stripCount++;
+	_memoryUsage += size;
+	return strip.data;
+}
+
+void BackgroundStripCache::freeStrip(Strip &strip) {
+	if (!strip.data)
+		return;
+
+	free(strip.data);
+	strip.data = 0;
+	_stripCount--;
+	_memoryUsage -= strip.size;
+}
+
+bool BackgroundStripCache::evictStrips(uint32 maxMemory, int centerStrip) {
+	while (_memoryUsage > maxMemory) {
+		// Drop the strip which would take the longest to scroll into view
+		int victim = -1;
+		for (int i = 0; i < (int)_strips.size(); i++) {
+			if (_strips[i].data && (victim < 0 || ABS(i - centerStrip) > ABS(victim - centerStrip)))
+				victim = i;
+		}
+		if (victim < 0)
+			return false;
+
+		freeStrip(_strips[victim]);
+		_stats.evictions++;
+	}
+
+	return true;
+}
+
+void BackgroundStripCache::clear() {
+	for (uint i = 0; i < _strips.size(); i++)
+		freeStrip(_strips[i]);
+	_strips.clear();
+}
+
+void BackgroundStripCache::enable(bool enable) {
+	_enabled = enable;
+	if (!enable)
+		clear();
+}
+
+void BackgroundStripCache::setMemoryBudget(uint32 budget) {
+	_memoryBudget = budget;
+	evictStrips(budget, _strips.size() / 2);
+}
+
+void BackgroundStripCache::resetStatistics() {
+	_stats.hits = 0;
+	_stats.misses = 0;
+	_stats.evictions = 0;
+}
+
 void Gdi::loadTiles(byte *roomptr) {
 }
 
@@ -1007,7 +1134,14 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	// The decoded strips of V5-V7 rooms are cached, so that scrolling back
+	// and forth in rooms wider than the screen doesn't decode them again.
+	byte flag = 0;
+	if (_game.version >= 5 && _game.version <= 7 && _game.heversion == 0 &&
+	    _game.platform != Common::kPlatformFMTowns && _game.platform != Common::kPlatformAmiga)
+		flag |= Gdi::dbBackground;
+
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, flag);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -1815,6 +1949,21 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		limit = numstrip;
 	if (limit > _numStrips - sx)
 		limit = _numStrips - sx;
+
+	// The strips don't depend on each other, so they are all decoded into
+	// the back buffer first and then copied to the front buffer at once.
+	const int firstX = x;
+
+	// Room backgrounds may be restored from the strip cache. A strip is
+	// cached with the mask columns of the Z-planes decodeMask() writes.
+	const bool useStripCache = (flag & dbBackground) && !(flag & dbDrawMaskOnAll) && _stripCache.isEnabled();
+	const int rowSize = 8 * vs->format.bytesPerPixel;
+	uint16 cachedPlanes = 0;
+	for (int i = 1; i < numzbuf; i++) {
+		if (zplane_list[i])
+			cachedPlanes |= 1 << i;
+	}
+
 	for (int k = 0; k < limit; ++k, ++stripnr, ++sx, ++x) {
 		if (y < vs->tdirty[sx])
 			vs->tdirty[sx] = y;
@@ -1829,22 +1978,30 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		else
 			dstPtr = (byte *)vs->pixels + y * vs->pitch + (x * 8 * vs->format.bytesPerPixel);
 
+		if (useStripCache) {
+			const byte *cached = _stripCache.lookup(stripnr, height, rowSize, cachedPlanes);
+			if (cached) {
+				restoreCachedStrip(cached, dstPtr, vs->pitch, x, y, height, rowSize, cachedPlanes);
+				continue;
+			}
+		}
+
 		transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
 
 		// COMI and HE games only uses flag value
 		if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
 			transpStrip = true;
 
-		if (vs->hasTwoBuffers) {
-			byte *frontBuf = (byte *)vs->pixels + y * vs->pitch + (x * 8 * vs->format.bytesPerPixel);
-			if (lightsOn)
-				copy8Col(frontBuf, vs->pitch, dstPtr, height, vs->format.bytesPerPixel);
-			else
-				clear8Col(frontBuf, vs->pitch, height, vs->format.bytesPerPixel);
-		}
-
 		decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
 
+		// Transparent pixels keep whatever was drawn there before, so only
+		// opaque strips can be restored from the cache later on.
+		if (useStripCache && !transpStrip) {
+			byte *cache = _stripCache.store(stripnr, height, rowSize, cachedPlanes, _vm->_screenStartStrip + _numStrips / 2);
+			if (cache)
+				cacheStrip(cache, dstPtr, vs->pitch, x, y, height, rowSize, cachedPlanes);
+		}
+
 #if 0
 		// HACK: blit mask(s) onto normal screen. Useful to debug masking
 		for (int i = 0; i < numzbuf; i++) {
@@ -1869,6 +2026,51 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		}
 #endif
 	}
+
+	if (vs->hasTwoBuffers && limit > 0) {
+		const int offset = y * vs->pitch + (firstX * 8 * vs->format.bytesPerPixel);
+		byte *frontBuf = (byte *)vs->pixels + offset;
+		if (lightsOn)
+			blit(frontBuf, vs->pitch, vs->backBuf + offset, vs->pitch, limit * 8, height, vs->format.bytesPerPixel);
+		else
+			fill(frontBuf, vs->pitch, 0, limit * 8, height, vs->format.bytesPerPixel);
+	}
+}
+
+void Gdi::cacheStrip(byte *cache, const byte *src, int srcPitch, int x, int y, const int height, int rowSize, uint16 planes) {
+	for (int h = 0; h < height; h++) {
+		memcpy(cache, src, rowSize);
+		cache += rowSize;
+		src += srcPitch;
+	}
+
+	for (int i = 1; planes >> i; i++) {
+		if (!(planes & (1 << i)))
+			continue;
+		const byte *mask = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++) {
+			*cache++ = *mask;
+			mask += _numStrips;
+		}
+	}
+}
+
+void Gdi::restoreCachedStrip(const byte *cache, byte *dst, int dstPitch, int x, int y, const int height, int rowSize, uint16 planes) {
+	for (int h = 0; h < height; h++) {
+		memcpy(dst, cache, rowSize);
+		cache += rowSize;
+		dst += dstPitch;
+	}
+
+	for (int i = 1; planes >> i; i++) {
+		if (!(planes & (1 << i)))
+			continue;
+		byte *mask = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++) {
+			*mask = *cache++;
+			mask += _numStrips;
+		}
+	}
 }
 
 bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
@@ -24,6 +24,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -182,6 +183,75 @@ struct StripTable;
 #define CHARSET_MASK_TRANSPARENCY	 0xFD
 #define CHARSET_MASK_TRANSPARENCY_32 0xFDFDFDFD
 
+// Default memory limit of the background strip cache
+#define MAX_BACKGROUND_STRIP_CACHE_MEMORY (2 * 1024 * 1024)
+
+/**
+ * Cache of the decoded background strips of the current room. Every strip
+ * keeps the pixels and Z-plane mask columns it decoded to, so that strips
+ * which scroll back into view are copied instead of being decompressed
+ * again. Once the memory limit is exceeded, the strips farthest away from
+ * the visible part of the room are dropped first.
+ */
+class BackgroundStripCache {
+public:
+	struct Statistics {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+	};
+
+	BackgroundStripCache();
+	~BackgroundStripCache();
+
+	/**
+	 * Returns the cached data of a strip: height rows of rowSize bytes of
+	 * pixels, followed by a column of height mask bytes for every Z-plane
+	 * set in planes. Returns 0 if the strip isn't cached with that layout.
+	 */
+	const byte *lookup(int stripnr, int height, int rowSize, uint16 planes);
+
+	/**
+	 * Returns a buffer to store the data of a strip in, using the layout
+	 * described for lookup(). Strips far away from centerStrip are evicted
+	 * to make room for it. Returns 0 if the cache is disabled or the strip
+	 * doesn't fit.
+	 */
+	byte *store(int stripnr, int height, int rowSize, uint16 planes, int centerStrip);
+
+	void clear();
+
+	void enable(bool enable);
+	bool isEnabled() const { return _enabled; }
+
+	void setMemoryBudget(uint32 budget);
+	uint32 getMemoryBudget() const { return _memoryBudget; }
+	uint32 getMemoryUsage() const { return _memoryUsage; }
+	uint getStripCount() const { return _stripCount; }
+
+	const Statistics &getStatistics() const { return _stats; }
+	void resetStatistics();
+
+private:
+	struct Strip {
+		byte *data;
+		uint32 size;
+		uint16 height;
+		uint16 rowSize;
+		uint16 planes;
+	};
+
+	void freeStrip(Strip &strip);
+	bool evictStrips(uint32 maxMemory, int centerStrip);
+
+	Common::Array<Strip> _strips;
+	uint _stripCount;
+	uint32 _memoryUsage;
+	uint32 _memoryBudget;
+	bool _enabled;
+	Statistics _stats;
+};
+
 class Gdi {
 protected:
 	ScummEngine *_vm;
@@ -240,6 +310,9 @@ protected:
 	                int stripnr, int numzbuf, const byte *zplane_list[9],
 	                bool transpStrip, byte flag);
 
+	void cacheStrip(byte *cache, const byte *src, int srcPitch, int x, int y, const int height, int rowSize, uint16 planes);
+	void restoreCachedStrip(const byte *cache, byte *dst, int dstPitch, int x, int y, const int height, int rowSize, uint16 planes);
+
 	virtual void prepareDrawBitmap(const byte *ptr, VirtScreen *vs,
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip);
@@ -251,7 +324,7 @@ public:
 	virtual void init();
 	virtual void roomChanged(byte *roomptr);
 	virtual void loadTiles(byte *roomptr);
-	void setTransparentColor(byte transparentColor) { _transparentColor = transparentColor; }
+	void setTransparentColor(byte transparentColor);
 
 	void drawBitmap(const byte *ptr, VirtScreen *vs, int x, int y, const int width, const int height,
 	                int stripnr, int numstrip, byte flag);
@@ -267,10 +340,13 @@ public:
 
 	void resetBackground(int top, int bottom, int strip);
 
+	BackgroundStripCache _stripCache;
+
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbObjectMode    = 2 << 2,
+		dbBackground    = 1 << 4	// room background, may use the strip cache
 	};
 };
 
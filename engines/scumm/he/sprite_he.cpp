@@ -22,6 +22,8 @@
 
 #ifdef ENABLE_HE
 
+#include "common/algorithm.h"
+
 #include "scumm/he/intern_he.h"
 #include "scumm/resource.h"
 #include "scumm/saveload.h"
@@ -38,7 +40,10 @@ Sprite::Sprite(ScummEngine_v90he *vm)
 	_vm(vm),
 	_spriteGroups(0),
 	_spriteTable(0),
-	_activeSpritesTable(0) {
+	_activeSpritesTable(0),
+	_spriteGridWidth(0),
+	_spriteGridHeight(0),
+	_spriteGridValid(false) {
 }
 
 Sprite::~Sprite() {
@@ -98,114 +103,188 @@ void Sprite::getSpriteBounds(int spriteId, bool checkGroup, Common::Rect &bound)
 	}
 }
 
+// Below this number of active sprites, they are hit-tested one by one
+#define SPRITE_GRID_MIN_SPRITES 32
+// Size of the cells of the sprite hit-testing grid, in pixels
+#define SPRITE_GRID_CELL_SIZE 64
+
+int Sprite::getSpriteGridCell(int x, int y) const {
+	int cx = CLIP(x / SPRITE_GRID_CELL_SIZE, 0, _spriteGridWidth - 1);
+	int cy = CLIP(y / SPRITE_GRID_CELL_SIZE, 0, _spriteGridHeight - 1);
+	return cy * _spriteGridWidth + cx;
+}
+
+void Sprite::updateSpriteGrid() {
+	if (_spriteGridValid)
+		return;
+
+	_spriteGridWidth = MAX(1, (_vm->_screenWidth + SPRITE_GRID_CELL_SIZE - 1) / SPRITE_GRID_CELL_SIZE);
+	_spriteGridHeight = MAX(1, (_vm->_screenHeight + SPRITE_GRID_CELL_SIZE - 1) / SPRITE_GRID_CELL_SIZE);
+	_spriteGrid.resize(_spriteGridWidth * _spriteGridHeight);
+	for (uint i = 0; i < _spriteGrid.size(); i++)
+		_spriteGrid[i].clear();
+	_spriteGridUnbounded.clear();
+
+	// Positions outside of the screen are clamped to the border cells, both
+	// here and when looking them up, so no sprite is missed.
+	for (int i = 0; i < _numSpritesToProcess; i++) {
+		SpriteInfo *spi = _activeSpritesTable[i];
+
+		// Mask images are hit-tested without checking the bounding box
+		if (spi->maskImage) {
+			_spriteGridUnbounded.push_back(i);
+			continue;
+		}
+		if (spi->bbox.left > spi->bbox.right || spi->bbox.top > spi->bbox.bottom)
+			continue;
+
+		int topLeft = getSpriteGridCell(spi->bbox.left, spi->bbox.top);
+		int bottomRight = getSpriteGridCell(spi->bbox.right, spi->bbox.bottom);
+		for (int cy = topLeft / _spriteGridWidth; cy <= bottomRight / _spriteGridWidth; cy++) {
+			for (int cx = topLeft % _spriteGridWidth; cx <= bottomRight % _spriteGridWidth; cx++)
+				_spriteGrid[cy * _spriteGridWidth + cx].push_back(i);
+		}
+	}
+
+	_spriteGridValid = true;
+}
+
 //
 // spriteInfoGet functions
 //
 int Sprite::findSpriteWithClassOf(int x_pos, int y_pos, int spriteGroupId, int type, int num, int *args) {
 	debug(2, "findSprite: x %d, y %d, spriteGroup %d, type %d, num %d", x_pos, y_pos, spriteGroupId, type, num);
+
+	if (_numSpritesToProcess < SPRITE_GRID_MIN_SPRITES) {
+		for (int i = (_numSpritesToProcess - 1); i >= 0; i--) {
+			SpriteInfo *spi = _activeSpritesTable[i];
+			if (checkSpriteHit(spi, x_pos, y_pos, spriteGroupId, type, num, args))
+				return spi->id;
+		}
+		return 0;
+	}
+
+	// Only test the sprites which may cover the position, topmost first
+	updateSpriteGrid();
+	const Common::Array<int> &cell = _spriteGrid[getSpriteGridCell(x_pos, y_pos)];
+	int i = cell.size() - 1;
+	int j = _spriteGridUnbounded.size() - 1;
+	while (i >= 0 || j >= 0) {
+		int index;
+		if (j < 0 || (i >= 0 && cell[i] > _spriteGridUnbounded[j]))
+			index = cell[i--];
+		else
+			index = _spriteGridUnbounded[j--];
+
+		SpriteInfo *spi = _activeSpritesTable[index];
+		if (checkSpriteHit(spi, x_pos, y_pos, spriteGroupId, type, num, args))
+			return spi->id;
+	}
+
+	return 0;
+}
+
+bool Sprite::checkSpriteHit(SpriteInfo *spi, int x_pos, int y_pos, int spriteGroupId, int type, int num, int *args) {
 	Common::Point pos[1];
 	bool cond;
 	int code, classId;
 
-	for (int i = (_numSpritesToProcess - 1); i >= 0; i--) {
-		SpriteInfo *spi = _activeSpritesTable[i];
-		if (!spi->curImage)
-			continue;
+	if (!spi->curImage)
+		return false;
 
-		if (spriteGroupId && spi->group != spriteGroupId)
-			continue;
+	if (spriteGroupId && spi->group != spriteGroupId)
+		return false;
 
-		cond = true;
-		for (int j = 0; j < num; j++) {
-			code = classId = args[j];
-			classId &= 0x7F;
-			assertRange(1, classId, 32, "class");
-			if (code & 0x80) {
-				if (!(spi->classFlags & (1 << (classId - 1))))
-					cond = 0;
-			} else {
-				if ((spi->classFlags & (1 << (classId - 1))))
-					cond = 0;
-			}
+	cond = true;
+	for (int j = 0; j < num; j++) {
+		code = classId = args[j];
+		classId &= 0x7F;
+		assertRange(1, classId, 32, "class");
+		if (code & 0x80) {
+			if (!(spi->classFlags & (1 << (classId - 1))))
+				cond = 0;
+		} else {
+			if ((spi->classFlags & (1 << (classId - 1))))
+				cond = 0;
 		}
-		if (!cond)
-			continue;
+	}
+	if (!cond)
+		return false;
+
+	if (type) {
+		if (spi->bbox.left > spi->bbox.right)
+			return false;
+		if (spi->bbox.top > spi->bbox.bottom)
+			return false;
+		if (spi->bbox.left > x_pos)
+			return false;
+		if (spi->bbox.top > y_pos)
+			return false;
+		if (spi->bbox.right < x_pos)
+			return false;
+		if (spi->bbox.bottom < y_pos)
+			return false;
+		return true;
+	} else {
+		int image, imageState, angle, scale;
+		int32 w, h;
 
-		if (type) {
+		image = spi->curImage;
+		if (spi->maskImage) {
+			int32 x1, x2, y1, y2;
+
+			image = spi->maskImage;
+			imageState = spi->curImageState % _vm->_wiz->getWizImageStates(spi->maskImage);
+
+			pos[0].x = x_pos - spi->pos.x;
+			pos[0].y = y_pos - spi->pos.y;
+
+			_vm->_wiz->getWizImageSpot(spi->curImage, imageState, x1, y1);
+			_vm->_wiz->getWizImageSpot(spi->maskImage, imageState, x2, y2);
+
+			pos[0].x += (x2 - x1);
+			pos[0].y += (y2 - y1);
+		} else {
 			if (spi->bbox.left > spi->bbox.right)
-				continue;
+				return false;
 			if (spi->bbox.top > spi->bbox.bottom)
-				continue;
+				return false;
 			if (spi->bbox.left > x_pos)
-				continue;
+				return false;
 			if (spi->bbox.top > y_pos)
-				continue;
+				return false;
 			if (spi->bbox.right < x_pos)
-				continue;
+				return false;
 			if (spi->bbox.bottom < y_pos)
-				continue;
-			return spi->id;
-		} else {
-			int image, imageState, angle, scale;
-			int32 w, h;
+				return false;
 
-			image = spi->curImage;
-			if (spi->maskImage) {
-				int32 x1, x2, y1, y2;
-
-				image = spi->maskImage;
-				imageState = spi->curImageState % _vm->_wiz->getWizImageStates(spi->maskImage);
-
-				pos[0].x = x_pos - spi->pos.x;
-				pos[0].y = y_pos - spi->pos.y;
-
-				_vm->_wiz->getWizImageSpot(spi->curImage, imageState, x1, y1);
-				_vm->_wiz->getWizImageSpot(spi->maskImage, imageState, x2, y2);
-
-				pos[0].x += (x2 - x1);
-				pos[0].y += (y2 - y1);
-			} else {
-				if (spi->bbox.left > spi->bbox.right)
-					continue;
-				if (spi->bbox.top > spi->bbox.bottom)
-					continue;
-				if (spi->bbox.left > x_pos)
-					continue;
-				if (spi->bbox.top > y_pos)
-					continue;
-				if (spi->bbox.right < x_pos)
-					continue;
-				if (spi->bbox.bottom < y_pos)
-					continue;
+			pos[0].x = x_pos - spi->pos.x;
+			pos[0].y = y_pos - spi->pos.y;
+			imageState = spi->curImageState;
+		}
 
-				pos[0].x = x_pos - spi->pos.x;
-				pos[0].y = y_pos - spi->pos.y;
-				imageState = spi->curImageState;
+		angle = spi->curAngle;
+		scale = spi->curScale;
+		if ((spi->flags & kSFScaled) || (spi->flags & kSFRotated)) {
+			if (spi->flags & kSFScaled && scale) {
+				pos[0].x = pos[0].x * 256 / scale;
+				pos[0].y = pos[0].y * 256 / scale;
 			}
-
-			angle = spi->curAngle;
-			scale = spi->curScale;
-			if ((spi->flags & kSFScaled) || (spi->flags & kSFRotated)) {
-				if (spi->flags & kSFScaled && scale) {
-					pos[0].x = pos[0].x * 256 / scale;
-					pos[0].y = pos[0].y * 256 / scale;
-				}
-				if (spi->flags & kSFRotated && angle) {
-					angle = (360 - angle) % 360;
-					_vm->_wiz->polygonRotatePoints(pos, 1, angle);
-				}
-
-				_vm->_wiz->getWizImageDim(image, imageState, w, h);
-				pos[0].x += w / 2;
-				pos[0].y += h / 2;
+			if (spi->flags & kSFRotated && angle) {
+				angle = (360 - angle) % 360;
+				_vm->_wiz->polygonRotatePoints(pos, 1, angle);
 			}
 
-			if (_vm->_wiz->isWizPixelNonTransparent(image, imageState, pos[0].x, pos[0].y, spi->curImgFlags))
-				return spi->id;
+			_vm->_wiz->getWizImageDim(image, imageState, w, h);
+			pos[0].x += w / 2;
+			pos[0].y += h / 2;
 		}
+
+		if (_vm->_wiz->isWizPixelNonTransparent(image, imageState, pos[0].x, pos[0].y, spi->curImgFlags))
+			return true;
 	}
 
-	return 0;
+	return false;
 }
 
 int Sprite::getSpriteClass(int spriteId, int num, int *args) {
@@ -511,6 +590,7 @@ void Sprite::setSpriteMaskImage(int spriteId, int value) {
 	assertRange(1, spriteId, _varNumSprites, "sprite");
 
 	_spriteTable[spriteId].maskImage = value;
+	_spriteGridValid = false;
 }
 
 void Sprite::setSpriteImageState(int spriteId, int state) {
@@ -789,6 +869,7 @@ void Sprite::resetSprite(int spriteId) {
 	_spriteTable[spriteId].palette = 0;
 	_spriteTable[spriteId].sourceImage = 0;
 	_spriteTable[spriteId].maskImage = 0;
+	_spriteGridValid = false;
 	_spriteTable[spriteId].priority = 0;
 	_spriteTable[spriteId].field_84 = 0;
 	_spriteTable[spriteId].imgFlags = 0;
@@ -1050,6 +1131,8 @@ void Sprite::allocTables(int numSprites, int numGroups, int numMaxSprites) {
 	_spriteGroups = (SpriteGroup *)malloc((_varNumSpriteGroups + 1) * sizeof(SpriteGroup));
 	_spriteTable = (SpriteInfo *)malloc((_varNumSprites + 1) * sizeof(SpriteInfo));
 	_activeSpritesTable = (SpriteInfo **)malloc((_varNumSprites + 1) * sizeof(SpriteInfo *));
+	_spriteListed.resize(_varNumSprites + 1);
+	_spriteGridValid = false;
 }
 
 void Sprite::resetGroup(int spriteGroupId) {
@@ -1080,6 +1163,7 @@ void Sprite::resetTables(bool refreshScreen) {
 		_vm->restoreBackgroundHE(Common::Rect(_vm->_screenWidth, _vm->_screenHeight));
 	}
 	_numSpritesToProcess = 0;
+	_spriteGridValid = false;
 }
 
 void Sprite::resetBackground() {
@@ -1183,26 +1267,34 @@ void Sprite::updateImages() {
 	}
 }
 
-static int compareSprTable(const void *a, const void *b) {
-	const SpriteInfo *spr1 = *(const SpriteInfo *const*)a;
-	const SpriteInfo *spr2 = *(const SpriteInfo *const*)b;
-
-	if (spr1->zorder > spr2->zorder)
-		return 1;
-
-	if (spr1->zorder < spr2->zorder)
-		return -1;
+static inline bool compareSprTable(const SpriteInfo *spr1, const SpriteInfo *spr2) {
+	if (spr1->zorder != spr2->zorder)
+		return spr1->zorder < spr2->zorder;
 
-	return 0;
+	return spr1->id < spr2->id;
 }
 
 void Sprite::sortActiveSprites() {
 	int groupZorder;
 
-	_numSpritesToProcess = 0;
+	_spriteGridValid = false;
 
-	if (_varNumSprites <= 1)
+	if (_varNumSprites <= 1) {
+		_numSpritesToProcess = 0;
 		return;
+	}
+
+	// Start out from the order of the last frame, so that only the sprites
+	// which were activated or changed their priority have to be moved.
+	int32 numSprites = 0;
+	for (int i = 0; i < _numSpritesToProcess; i++) {
+		SpriteInfo *spi = _activeSpritesTable[i];
+		if (spi->flags & kSFActive) {
+			_activeSpritesTable[numSprites++] = spi;
+			_spriteListed[spi - _spriteTable] = 1;
+		}
+	}
+	_numSpritesToProcess = numSprites;
 
 	for (int i = 1; i < _varNumSprites; i++) {
 		SpriteInfo *spi = &_spriteTable[i];
@@ -1221,14 +1313,36 @@ void Sprite::sortActiveSprites() {
 			spi->id = i;
 			spi->zorder = spi->priority + groupZorder;
 
-			_activeSpritesTable[_numSpritesToProcess++] = spi;
+			if (!_spriteListed[i])
+				_activeSpritesTable[_numSpritesToProcess++] = spi;
 		}
 	}
 
+	for (int i = 0; i < numSprites; i++)
+		_spriteListed[_activeSpritesTable[i] - _spriteTable] = 0;
+
 	if (_numSpritesToProcess < 2)
 		return;
 
-	qsort(_activeSpritesTable, _numSpritesToProcess, sizeof(SpriteInfo *), compareSprTable);
+	// Insertion sort is linear on the mostly sorted table. Should too many
+	// sprites be out of place, fall back to sorting the table from scratch.
+	int32 moves = 0;
+	const int32 maxMoves = 8 * _numSpritesToProcess;
+	for (int i = 1; i < _numSpritesToProcess; i++) {
+		SpriteInfo *spi = _activeSpritesTable[i];
+		int j = i;
+		while (j > 0 && compareSprTable(spi, _activeSpritesTable[j - 1])) {
+			_activeSpritesTable[j] = _activeSpritesTable[j - 1];
+			j--;
+		}
+		_activeSpritesTable[j] = spi;
+
+		moves += i - j;
+		if (moves > maxMoves) {
+			Common::sort(_activeSpritesTable, _activeSpritesTable + _numSpritesToProcess, compareSprTable);
+			break;
+		}
+	}
 }
 
 void Sprite::processImages(bool arg) {
@@ -1239,6 +1353,7 @@ void Sprite::processImages(bool arg) {
 	int angle, scale;
 	int32 w, h;
 	WizParameters wiz;
+	const VirtScreen *vs = &_vm->_virtscr[kMainVirtScreen];
 
 	for (int i = 0; i < _numSpritesToProcess; i++) {
 		SpriteInfo *spi = _activeSpritesTable[i];
@@ -1246,6 +1361,8 @@ void Sprite::processImages(bool arg) {
 		if (!(spi->flags & kSFNeedRedraw))
 			continue;
 
+		_spriteGridValid = false;
+
 		spr_flags = spi->flags;
 
 		if (arg) {
@@ -1369,6 +1486,14 @@ void Sprite::processImages(bool arg) {
 			wiz.processFlags |= kWPFDstResNum;
 			wiz.dstResNum = _spriteGroups[spi->group].image;
 		}
+
+		// Skip sprites drawn entirely outside of the screen, unless they
+		// are drawn somewhere else or have side effects
+		if (image && !(wiz.processFlags & kWPFDstResNum) && !_vm->_fullRedraw &&
+		    !(wiz.img.flags & (kWIFRemapPalette | kWIFPrint | kWIFBlitToMemBuffer | kWIFIsPolygon)) &&
+		    (spi->bbox.right < 0 || spi->bbox.bottom < 0 || spi->bbox.left > vs->w || spi->bbox.top > vs->h))
+			continue;
+
 		_vm->_wiz->displayWizComplexImage(&wiz);
 	}
 }
@@ -1444,8 +1569,10 @@ void Sprite::saveOrLoadSpriteData(Serializer *s) {
 	}
 
 	// Reset active sprite table
-	if (s->isLoading())
+	if (s->isLoading()) {
 		_numSpritesToProcess = 0;
+		_spriteGridValid = false;
+	}
 
 }
 
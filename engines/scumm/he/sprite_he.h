@@ -23,6 +23,8 @@
 #if !defined(SCUMM_HE_SPRITE_HE_H) && defined(ENABLE_HE)
 #define SCUMM_HE_SPRITE_HE_H
 
+#include "common/array.h"
+
 namespace Scumm {
 
 enum SpriteFlags {
@@ -213,6 +215,24 @@ public:
 	void setSpriteImage(int spriteId, int imageNum);
 private:
 	ScummEngine_v90he *_vm;
+
+	/** Sprites of the active sprites table which have been re-sorted, see sortActiveSprites(). */
+	Common::Array<byte> _spriteListed;
+
+	/**
+	 * Grid of screen cells holding the indices of the active sprites whose
+	 * bounding box overlaps them, in drawing order. Used to find the sprites
+	 * at a position without testing all active sprites.
+	 */
+	Common::Array<Common::Array<int> > _spriteGrid;
+	/** Active sprites which are hit-tested regardless of their bounding box. */
+	Common::Array<int> _spriteGridUnbounded;
+	int _spriteGridWidth, _spriteGridHeight;
+	bool _spriteGridValid;
+
+	bool checkSpriteHit(SpriteInfo *spi, int x, int y, int spriteGroupId, int type, int num, int *args);
+	int getSpriteGridCell(int x, int y) const;
+	void updateSpriteGrid();
 };
 
 } // End of namespace Scumm
@@ -369,6 +369,158 @@ void Wiz::writeColor(uint8 *dstPtr, int dstType, uint16 color) {
 	}
 }
 
+/**
+ * Whether writeColor() stores colors in little endian byte order for the
+ * given destination type. Used to pick the byte order of the span writers
+ * below once per span rather than once per pixel.
+ */
+static bool isLittleEndianDst(int dstType) {
+	switch (dstType) {
+	case kDstCursor:
+	case kDstScreen:
+#ifdef SCUMM_LITTLE_ENDIAN
+		return true;
+#else
+		return false;
+#endif
+	case kDstMemory:
+	case kDstResource:
+		return true;
+	default:
+		error("writeColor: Unknown dstType %d", dstType);
+	}
+}
+
+template<bool littleEndian>
+static inline void storeColor(uint8 *dstPtr, uint16 color) {
+	if (littleEndian)
+		WRITE_LE_UINT16(dstPtr, color);
+	else
+		WRITE_BE_UINT16(dstPtr, color);
+}
+
+/**
+ * Mix two pairs of 16 bit colors at once, the way kWizXMap mixes single
+ * colors: both halves are summed separately after halving each channel.
+ * The mask clears the bit shifted in from the upper color, and the sums
+ * can't overflow into it.
+ */
+static inline uint32 mixColorPairs(uint32 src, uint32 dst) {
+	return ((src >> 1) & 0x7DEF7DEF) + ((dst >> 1) & 0x7DEF7DEF);
+}
+
+/**
+ * Write a span of count pixels of 8 bit image data to a 16 bit destination.
+ * dataInc is 0 for a run of a single color, and 1 for literal pixels.
+ */
+template<int type, bool littleEndian>
+static void write8BitSpanTo16Bit(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int dataInc, int count, const uint8 *palPtr) {
+	for (; count > 0; --count, dstPtr += dstInc, dataPtr += dataInc) {
+		uint16 color = (type == kWizCopy) ? *dataPtr : READ_LE_UINT16(palPtr + *dataPtr * 2);
+		if (type == kWizXMap)
+			color = ((color >> 1) & 0x7DEF) + ((READ_UINT16(dstPtr) >> 1) & 0x7DEF);
+		storeColor<littleEndian>(dstPtr, color);
+	}
+}
+
+/**
+ * Write a span of count pixels of 8 bit image data. kWizCopy stores the
+ * color index as is, kWizRMap remaps it through palPtr, and kWizXMap (shadow)
+ * looks up the pair of source and destination color in the 256x256 table
+ * xmapPtr. For 16 bit destinations, palPtr holds 16 bit colors instead, and
+ * kWizXMap averages the source and destination colors. Transparent pixels
+ * are skipped by the caller and never get here. dataInc is 0 for a run of a
+ * single color, and 1 for literal pixels; dstInc is the (possibly negative)
+ * step in bytes between destination pixels.
+ */
+template<int type>
+static void write8BitSpan(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int dataInc, int count, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	if (count <= 0)
+		return;
+
+	if (bitDepth == 2) {
+		if (isLittleEndianDst(dstType))
+			write8BitSpanTo16Bit<type, true>(dstPtr, dstInc, dataPtr, dataInc, count, palPtr);
+		else
+			write8BitSpanTo16Bit<type, false>(dstPtr, dstInc, dataPtr, dataInc, count, palPtr);
+		return;
+	}
+
+	if (type == kWizXMap) {
+		if (dataInc == 0) {
+			const uint8 *map = xmapPtr + *dataPtr * 256;
+			for (; count > 0; --count, dstPtr += dstInc)
+				*dstPtr = map[*dstPtr];
+		} else {
+			for (; count > 0; --count, dstPtr += dstInc, ++dataPtr)
+				*dstPtr = xmapPtr[*dataPtr * 256 + *dstPtr];
+		}
+	} else if (dataInc == 0) {
+		uint8 *first = (dstInc < 0) ? dstPtr - (count - 1) : dstPtr;
+		memset(first, (type == kWizRMap) ? palPtr[*dataPtr] : *dataPtr, count);
+	} else if (type == kWizCopy && dstInc > 0) {
+		memcpy(dstPtr, dataPtr, count);
+	} else {
+		for (; count > 0; --count, dstPtr += dstInc, ++dataPtr)
+			*dstPtr = (type == kWizRMap) ? palPtr[*dataPtr] : *dataPtr;
+	}
+}
+
+#ifdef USE_RGB_COLOR
+/**
+ * Write a span of count pixels of 16 bit image data. kWizCopy stores the
+ * colors as is, kWizXMap (shadow) averages each source color with the
+ * destination color. Transparent pixels are skipped by the caller and never
+ * get here. dataInc is 0 for a run of a single color, and 2 for literal
+ * pixels.
+ */
+template<int type, bool littleEndian>
+static void write16BitSpan(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int dataInc, int count) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	if (littleEndian && dstInc == 2) {
+		if (type == kWizCopy && dataInc == 2) {
+			memcpy(dstPtr, dataPtr, count * 2);
+			return;
+		}
+
+		if (type == kWizXMap) {
+			// Two pixels at a time
+			const uint32 runPair = (uint32)READ_LE_UINT16(dataPtr) * 0x10001;
+			for (; count >= 2; count -= 2, dstPtr += 4, dataPtr += dataInc * 2) {
+				const uint32 srcPair = dataInc ? READ_LE_UINT32(dataPtr) : runPair;
+				WRITE_LE_UINT32(dstPtr, mixColorPairs(srcPair, READ_LE_UINT32(dstPtr)));
+			}
+		}
+	}
+#endif
+
+	if (dataInc == 0 && type == kWizCopy) {
+		const uint16 color = READ_LE_UINT16(dataPtr);
+		for (; count > 0; --count, dstPtr += dstInc)
+			storeColor<littleEndian>(dstPtr, color);
+		return;
+	}
+
+	for (; count > 0; --count, dstPtr += dstInc, dataPtr += dataInc) {
+		uint16 color = READ_LE_UINT16(dataPtr);
+		if (type == kWizXMap)
+			color = ((color >> 1) & 0x7DEF) + ((READ_UINT16(dstPtr) >> 1) & 0x7DEF);
+		storeColor<littleEndian>(dstPtr, color);
+	}
+}
+
+template<int type>
+static void write16BitSpan(uint8 *dstPtr, int dstInc, const uint8 *dataPtr, int dataInc, int count, int dstType) {
+	if (count <= 0)
+		return;
+
+	if (isLittleEndianDst(dstType))
+		write16BitSpan<type, true>(dstPtr, dstInc, dataPtr, dataInc, count);
+	else
+		write16BitSpan<type, false>(dstPtr, dstInc, dataPtr, dataInc, count);
+}
+#endif
+
 #ifdef USE_RGB_COLOR
 void Wiz::copy16BitWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *xmapPtr) {
 	Common::Rect r1, r2;
@@ -646,11 +798,21 @@ void Wiz::copyRaw16BitWizImage(uint8 *dst, const uint8 *src, int dstPitch, int d
 		src += (r1.top * srcw + r1.left) * 2;
 		dst += r2.top * dstPitch + r2.left * 2;
 		while (h--) {
-			for (int i = 0; i < w; ++ i) {
-				uint16 col = READ_LE_UINT16(src + 2 * i);
-				if (transColor == -1 || transColor != col) {
-					writeColor(dst + i * 2, dstType, col);
+			// Copy the spans of non transparent pixels
+			int i = 0;
+			while (i < w) {
+				if (transColor != -1) {
+					while (i < w && READ_LE_UINT16(src + 2 * i) == transColor)
+						++i;
 				}
+				int start = i;
+				if (transColor == -1) {
+					i = w;
+				} else {
+					while (i < w && READ_LE_UINT16(src + 2 * i) != transColor)
+						++i;
+				}
+				write16BitSpan<kWizCopy>(dst + start * 2, 2, src + start * 2, 2, i - start, dstType);
 			}
 			src += srcw * 2;
 			dst += dstPitch;
@@ -770,10 +932,8 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
-						dstPtr += dstInc;
-					}
+					write16BitSpan<type>(dstPtr, dstInc, dataPtr, 0, code, dstType);
+					dstPtr += dstInc * code;
 					dataPtr += 2;
 				} else {
 					code = (code >> 2) + 1;
@@ -790,11 +950,9 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write16BitColor<type>(dstPtr, dataPtr, dstType, xmapPtr);
-						dataPtr += 2;
-						dstPtr += dstInc;
-					}
+					write16BitSpan<type>(dstPtr, dstInc, dataPtr, 2, code, dstType);
+					dataPtr += code * 2;
+					dstPtr += dstInc * code;
 				}
 			}
 		}
@@ -804,35 +962,6 @@ void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const u
 }
 #endif
 
-template<int type>
-void Wiz::write8BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
-	if (bitDepth == 2) {
-		if (type == kWizXMap) {
-			uint16 color = READ_LE_UINT16(palPtr + *dataPtr * 2);
-			uint16 srcColor = (color >> 1) & 0x7DEF;
-			uint16 dstColor = (READ_UINT16(dstPtr) >> 1) & 0x7DEF;
-			uint16 newColor = srcColor + dstColor;
-			writeColor(dstPtr, dstType, newColor);
-		}
-		if (type == kWizRMap) {
-			writeColor(dstPtr, dstType, READ_LE_UINT16(palPtr + *dataPtr * 2));
-		}
-		if (type == kWizCopy) {
-			writeColor(dstPtr, dstType, *dataPtr);
-		}
-	} else {
-		if (type == kWizXMap) {
-			*dstPtr = xmapPtr[*dataPtr * 256 + *dstPtr];
-		}
-		if (type == kWizRMap) {
-			*dstPtr = palPtr[*dataPtr];
-		}
-		if (type == kWizCopy) {
-			*dstPtr = *dataPtr;
-		}
-	}
-}
-
 template<int type>
 void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
 	const uint8 *dataPtr, *dataPtrNext;
@@ -904,10 +1033,8 @@ void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dstPtr += dstInc;
-					}
+					write8BitSpan<type>(dstPtr, dstInc, dataPtr, 0, code, dstType, palPtr, xmapPtr, bitDepth);
+					dstPtr += dstInc * code;
 					dataPtr++;
 				} else {
 					code = (code >> 2) + 1;
@@ -924,11 +1051,9 @@ void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8
 					if (w < 0) {
 						code += w;
 					}
-					while (code--) {
-						write8BitColor<type>(dstPtr, dataPtr, dstType, palPtr, xmapPtr, bitDepth);
-						dataPtr++;
-						dstPtr += dstInc;
-					}
+					write8BitSpan<type>(dstPtr, dstInc, dataPtr, 1, code, dstType, palPtr, xmapPtr, bitDepth);
+					dataPtr += code;
+					dstPtr += dstInc * code;
 				}
 			}
 		}
@@ -952,24 +1077,21 @@ void Wiz::decompressRawWizImage(uint8 *dst, int dstPitch, int dstType, const uin
 		return;
 	}
 	while (h--) {
-		for (int i = 0; i < w; ++i) {
-			uint8 col = src[i];
-			if (transColor == -1 || transColor != col) {
-				if (type == kWizRMap) {
-					if (bitDepth == 2) {
-						writeColor(dst + i * 2, dstType, READ_LE_UINT16(palPtr + col * 2));
-					} else {
-						dst[i] = palPtr[col];
-					}
-				}
-				if (type == kWizCopy) {
-					if (bitDepth == 2) {
-						writeColor(dst + i * 2, dstType, col);
-					} else {
-						dst[i] = col;
-					}
-				}
+		// Copy the spans of non transparent pixels
+		int i = 0;
+		while (i < w) {
+			if (transColor != -1) {
+				while (i < w && src[i] == transColor)
+					++i;
 			}
+			int start = i;
+			if (transColor == -1) {
+				i = w;
+			} else {
+				while (i < w && src[i] != transColor)
+					++i;
+			}
+			write8BitSpan<type>(dst + start * bitDepth, bitDepth, src + start, 1, i - start, dstType, palPtr, NULL, bitDepth);
 		}
 		src += srcPitch;
 		dst += dstPitch;
@@ -1959,26 +2081,43 @@ void Wiz::drawWizPolygonImage(uint8 *dst, const uint8 *src, const uint8 *mask, i
 		++y_start;
 	}
 
+	// Walk the source image along each destination line with 16.16 fixed
+	// point steps. The byte order and depth are resolved once per image.
+	const int32 srcSize = wizW * wizH;
+	const bool littleEndian = (bitDepth == 2) && isLittleEndianDst(dstType);
 	pra = &pdd.ra[0];
 	for (i = 0; i < pdd.rAreasNum; ++i, ++pra) {
 		uint8 *dstPtr = dst + pra->dst_offs;
 		int32 w = pra->w;
 		int32 x_acc = pra->x_s;
 		int32 y_acc = pra->y_s;
-		while (--w) {
-			int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
-			assert(src_offs < wizW * wizH);
-			x_acc += pra->x_step;
-			y_acc += pra->y_step;
-			if (bitDepth == 2) {
-				if (transColor == -1 || transColor != READ_LE_UINT16(src + src_offs * 2)) {
-					writeColor(dstPtr, dstType, READ_LE_UINT16(src + src_offs * 2));
+		const int32 x_step = pra->x_step;
+		const int32 y_step = pra->y_step;
+		if (bitDepth == 2) {
+			for (; --w; dstPtr += 2, x_acc += x_step, y_acc += y_step) {
+				int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
+				assert(src_offs < srcSize);
+				uint16 color = READ_LE_UINT16(src + src_offs * 2);
+				if (transColor == -1 || transColor != color) {
+					if (littleEndian)
+						storeColor<true>(dstPtr, color);
+					else
+						storeColor<false>(dstPtr, color);
 				}
-			} else {
-				if (transColor == -1 || transColor != src[src_offs])
+			}
+		} else if (transColor == -1) {
+			for (; --w; ++dstPtr, x_acc += x_step, y_acc += y_step) {
+				int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
+				assert(src_offs < srcSize);
+				*dstPtr = src[src_offs];
+			}
+		} else {
+			for (; --w; ++dstPtr, x_acc += x_step, y_acc += y_step) {
+				int32 src_offs = (y_acc >> 16) * wizW + (x_acc >> 16);
+				assert(src_offs < srcSize);
+				if (transColor != src[src_offs])
 					*dstPtr = src[src_offs];
 			}
-			dstPtr += bitDepth;
 		}
 	}
 
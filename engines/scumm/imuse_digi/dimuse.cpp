@@ -354,6 +354,15 @@ void IMuseDigital::callback() {
 					feedSize -= curFeedSize;
 					assert(feedSize >= 0);
 				} while (feedSize != 0);
+
+				// Decompress the next bundle block of this track ahead of time,
+				// so that the next feed doesn't stall on it
+				if (track->stream && track->curRegion != -1) {
+					int32 nextOffset = track->regionOffset;
+					if (bits == 12)
+						nextOffset = (nextOffset * 3) / 4;
+					_sound->prefetchRegionData(track->soundDesc, track->curRegion, nextOffset);
+				}
 			}
 			if (_mixer->isReady()) {
 				_mixer->setChannelVolume(track->mixChanHandle, track->getVol());
@@ -37,6 +37,15 @@ BundleDirCache::BundleDirCache() {
 		_budleDirCache[fileId].isCompressed = false;
 		_budleDirCache[fileId].indexTable = NULL;
 	}
+	for (int i = 0; i < BUNDLE_BLOCK_CACHE_SIZE; i++) {
+		_decodedBlocks[i].slot = -1;
+		_decodedBlocks[i].index = -1;
+		_decodedBlocks[i].block = -1;
+		_decodedBlocks[i].size = 0;
+		_decodedBlocks[i].lastUse = 0;
+		_decodedBlocks[i].data = NULL;
+	}
+	_blockUseCounter = 0;
 }
 
 BundleDirCache::~BundleDirCache() {
@@ -44,6 +53,8 @@ BundleDirCache::~BundleDirCache() {
 		free(_budleDirCache[fileId].bundleTable);
 		free(_budleDirCache[fileId].indexTable);
 	}
+	for (int i = 0; i < BUNDLE_BLOCK_CACHE_SIZE; i++)
+		free(_decodedBlocks[i].data);
 }
 
 BundleDirCache::AudioTable *BundleDirCache::getTable(int slot) {
@@ -62,6 +73,52 @@ bool BundleDirCache::isSndDataExtComp(int slot) {
 	return _budleDirCache[slot].isCompressed;
 }
 
+byte *BundleDirCache::findDecodedBlock(int slot, int32 index, int32 block, int32 &size) {
+	for (int i = 0; i < BUNDLE_BLOCK_CACHE_SIZE; i++) {
+		DecodedBlock &entry = _decodedBlocks[i];
+		if (entry.block == block && entry.index == index && entry.slot == slot) {
+			entry.lastUse = ++_blockUseCounter;
+			size = entry.size;
+			return entry.data;
+		}
+	}
+	return NULL;
+}
+
+byte *BundleDirCache::allocDecodedBlock(int slot, int32 index, int32 block) {
+	// Take a free entry or, failing that, the least recently used one
+	DecodedBlock *victim = &_decodedBlocks[0];
+	for (int i = 0; i < BUNDLE_BLOCK_CACHE_SIZE; i++) {
+		DecodedBlock &entry = _decodedBlocks[i];
+		if (entry.slot == -1) {
+			victim = &entry;
+			break;
+		}
+		if (entry.lastUse < victim->lastUse)
+			victim = &entry;
+	}
+
+	if (!victim->data) {
+		victim->data = (byte *)malloc(BUNDLE_BLOCK_SIZE);
+		assert(victim->data);
+	}
+	victim->slot = slot;
+	victim->index = index;
+	victim->block = block;
+	victim->size = 0;
+	victim->lastUse = ++_blockUseCounter;
+	return victim->data;
+}
+
+void BundleDirCache::setDecodedBlockSize(byte *data, int32 size) {
+	for (int i = 0; i < BUNDLE_BLOCK_CACHE_SIZE; i++) {
+		if (_decodedBlocks[i].data == data) {
+			_decodedBlocks[i].size = size;
+			return;
+		}
+	}
+}
+
 int BundleDirCache::matchFile(const char *filename) {
 	int32 tag, offset;
 	bool found = false;
@@ -146,6 +203,7 @@ BundleMgr::BundleMgr(BundleDirCache *cache) {
 	_numCompItems = 0;
 	_curSampleId = -1;
 	_fileBundleId = -1;
+	_cacheSlot = -1;
 	_file = new ScummFile();
 	_compInputBuff = NULL;
 }
@@ -185,6 +243,7 @@ bool BundleMgr::open(const char *filename, bool &compressed, bool errorFlag) {
 
 	int slot = _cache->matchFile(filename);
 	assert(slot != -1);
+	_cacheSlot = slot;
 	compressed = _cache->isSndDataExtComp(slot);
 	_numFiles = _cache->getNumFiles(slot);
 	assert(_numFiles);
@@ -192,8 +251,6 @@ bool BundleMgr::open(const char *filename, bool &compressed, bool errorFlag) {
 	_indexTable = _cache->getIndexTable(slot);
 	assert(_bundleTable);
 	_compTableLoaded = false;
-	_outputSize = 0;
-	_lastBlock = -1;
 
 	return true;
 }
@@ -205,8 +262,6 @@ void BundleMgr::close() {
 		_numFiles = 0;
 		_numCompItems = 0;
 		_compTableLoaded = false;
-		_lastBlock = -1;
-		_outputSize = 0;
 		_curSampleId = -1;
 		free(_compTable);
 		_compTable = NULL;
@@ -245,6 +300,42 @@ bool BundleMgr::loadCompTable(int32 index) {
 	return true;
 }
 
+byte *BundleMgr::getDecodedBlock(int32 index, int32 block, int32 &outputSize) {
+	byte *data = _cache->findDecodedBlock(_cacheSlot, index, block, outputSize);
+	if (data)
+		return data;
+
+	data = _cache->allocDecodedBlock(_cacheSlot, index, block);
+	// CMI hack: one more zero byte at the end of input buffer
+	_compInputBuff[_compTable[block].size] = 0;
+	_file->seek(_bundleTable[index].offset + _compTable[block].offset, SEEK_SET);
+	_file->read(_compInputBuff, _compTable[block].size);
+	outputSize = BundleCodecs::decompressCodec(_compTable[block].codec, _compInputBuff, data, _compTable[block].size);
+	if (outputSize > BUNDLE_BLOCK_SIZE) {
+		error("_outputSize: %d", outputSize);
+	}
+	_cache->setDecodedBlockSize(data, outputSize);
+
+	return data;
+}
+
+void BundleMgr::prefetchSampleByCurIndex(int32 offset, int headerSize) {
+	// Decompress ahead the block holding the given offset, or the one
+	// following it, so that the next read is served from the block cache.
+	// At most one block is decompressed per call.
+	if (!_file->isOpen() || _curSampleId == -1 || !_compTableLoaded)
+		return;
+
+	int32 block = (offset + headerSize) / BUNDLE_BLOCK_SIZE;
+	int32 size;
+	for (int32 i = block; i <= block + 1 && i < _numCompItems; i++) {
+		if (!_cache->findDecodedBlock(_cacheSlot, _curSampleId, i, size)) {
+			getDecodedBlock(_curSampleId, i, size);
+			return;
+		}
+	}
+}
+
 int32 BundleMgr::decompressSampleByCurIndex(int32 offset, int32 size, byte **compFinal, int headerSize, bool headerOutside) {
 	return decompressSampleByIndex(_curSampleId, offset, size, compFinal, headerSize, headerOutside);
 }
@@ -286,19 +377,7 @@ int32 BundleMgr::decompressSampleByIndex(int32 index, int32 offset, int32 size,
 	skip = (offset + headerSize) % 0x2000;
 
 	for (i = firstBlock; i <= lastBlock; i++) {
-		if (_lastBlock != i) {
-			// CMI hack: one more zero byte at the end of input buffer
-			_compInputBuff[_compTable[i].size] = 0;
-			_file->seek(_bundleTable[index].offset + _compTable[i].offset, SEEK_SET);
-			_file->read(_compInputBuff, _compTable[i].size);
-			_outputSize = BundleCodecs::decompressCodec(_compTable[i].codec, _compInputBuff, _compOutputBuff, _compTable[i].size);
-			if (_outputSize > 0x2000) {
-				error("_outputSize: %d", _outputSize);
-			}
-			_lastBlock = i;
-		}
-
-		outputSize = _outputSize;
+		byte *blockData = getDecodedBlock(index, i, outputSize);
 
 		if (headerOutside) {
 			outputSize -= skip;
@@ -315,7 +394,7 @@ int32 BundleMgr::decompressSampleByIndex(int32 index, int32 offset, int32 size,
 
 		assert(finalSize + outputSize <= blocksFinalSize);
 
-		memcpy(*compFinal + finalSize, _compOutputBuff + skip, outputSize);
+		memcpy(*compFinal + finalSize, blockData + skip, outputSize);
 		finalSize += outputSize;
 
 		size -= outputSize;
@@ -29,6 +29,11 @@ namespace Scumm {
 
 class BaseScummFile;
 
+// Size of one decompressed bundle block
+#define BUNDLE_BLOCK_SIZE 0x2000
+// Number of decompressed bundle blocks kept in the shared block cache
+#define BUNDLE_BLOCK_CACHE_SIZE 64
+
 class BundleDirCache {
 public:
 	struct AudioTable {
@@ -52,6 +57,21 @@ private:
 		IndexNode *indexTable;
 	} _budleDirCache[4];
 
+	// Decompressed blocks shared by all bundle managers, so that tracks
+	// which read the same sample (e.g. a crossfade between two regions of
+	// the same music) don't decompress the same block twice. The block
+	// buffers are allocated once and reused when an entry is evicted.
+	struct DecodedBlock {
+		int slot;
+		int32 index;
+		int32 block;
+		int32 size;
+		uint32 lastUse;
+		byte *data;
+	} _decodedBlocks[BUNDLE_BLOCK_CACHE_SIZE];
+
+	uint32 _blockUseCounter;
+
 public:
 	BundleDirCache();
 	~BundleDirCache();
@@ -61,6 +81,10 @@ public:
 	IndexNode *getIndexTable(int slot);
 	int32 getNumFiles(int slot);
 	bool isSndDataExtComp(int slot);
+
+	byte *findDecodedBlock(int slot, int32 index, int32 block, int32 &size);
+	byte *allocDecodedBlock(int slot, int32 index, int32 block);
+	void setDecodedBlockSize(byte *data, int32 size);
 };
 
 class BundleMgr {
@@ -84,12 +108,11 @@ private:
 	BaseScummFile *_file;
 	bool _compTableLoaded;
 	int _fileBundleId;
-	byte _compOutputBuff[0x2000];
+	int _cacheSlot;
 	byte *_compInputBuff;
-	int _outputSize;
-	int _lastBlock;
 
 	bool loadCompTable(int32 index);
+	byte *getDecodedBlock(int32 index, int32 block, int32 &outputSize);
 
 public:
 
@@ -102,6 +125,7 @@ public:
 	int32 decompressSampleByName(const char *name, int32 offset, int32 size, byte **compFinal, bool headerOutside);
 	int32 decompressSampleByIndex(int32 index, int32 offset, int32 size, byte **compFinal, int header_size, bool headerOutside);
 	int32 decompressSampleByCurIndex(int32 offset, int32 size, byte **compFinal, int headerSize, bool headerOutside);
+	void prefetchSampleByCurIndex(int32 offset, int headerSize);
 };
 
 } // End of namespace Scumm
@@ -632,6 +632,21 @@ int ImuseDigiSndMgr::getJumpFade(SoundDesc *soundDesc, int number) {
 	return soundDesc->jump[number].fadeDelay;
 }
 
+void ImuseDigiSndMgr::prefetchRegionData(SoundDesc *soundDesc, int region, int32 offset) {
+	assert(checkForProperHandle(soundDesc));
+	assert(region >= 0 && region < soundDesc->numRegions);
+
+	// Only uncompressed bundles go through the bundle block cache
+	if (!soundDesc->bundle || soundDesc->compressed)
+		return;
+
+	if (offset + soundDesc->offsetData >= soundDesc->region[region].length)
+		return;
+
+	int32 start = soundDesc->region[region].offset - soundDesc->offsetData;
+	soundDesc->bundle->prefetchSampleByCurIndex(start + offset, soundDesc->offsetData);
+}
+
 int32 ImuseDigiSndMgr::getDataFromRegion(SoundDesc *soundDesc, int region, byte **buf, int32 offset, int32 size) {
 	debug(6, "getDataFromRegion() region:%d, offset:%d, size:%d, numRegions:%d", region, offset, size, soundDesc->numRegions);
 	assert(checkForProperHandle(soundDesc));
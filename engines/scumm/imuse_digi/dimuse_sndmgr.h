@@ -146,6 +146,7 @@ public:
 	void getSyncSizeAndPtrById(SoundDesc *soundDesc, int number, int32 &sync_size, byte **sync_ptr);
 
 	int32 getDataFromRegion(SoundDesc *soundDesc, int region, byte **buf, int32 offset, int32 size);
+	void prefetchRegionData(SoundDesc *soundDesc, int region, int32 offset);
 };
 
 } // End of namespace Scumm
@@ -47,10 +47,15 @@ enum {
 	RF_USAGE = 0x7F,
 	RF_USAGE_MAX = RF_USAGE,
 
+	RS_PREFETCHED = 0x01,
 	RS_MODIFIED = 0x10,
+	RS_EXPIRED = 0x20,
 	RF_OFFHEAP = 0x40
 };
 
+/** The number of expired resources remembered for prefetching. */
+#define MAX_EXPIRED_RESOURCES 16
+
 
 
 extern const char *nameOfResType(ResType type);
@@ -612,7 +617,9 @@ void ScummEngine::ensureResourceLoaded(ResType type, ResId idx) {
 	if (idx <= _res->_types[type].size() && _res->_types[type][idx]._address)
 		return;
 
+	uint32 loadStart = _system->getMillis();
 	loadResource(type, idx);
+	_res->noteResourceLoaded(type, idx, _system->getMillis() - loadStart, false);
 
 	if (_game.version == 5 && type == rtRoom && (int)idx == _roomResource)
 		VAR(VAR_ROOM_FLAG) = 1;
@@ -736,8 +743,11 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return NULL;
 
 	// If the resource is missing, but loadable from the game data files, try to do so.
-	if (!_res->_types[type][idx]._address && _res->_types[type]._mode != kDynamicResTypeMode) {
-		ensureResourceLoaded(type, idx);
+	if (_res->_types[type]._mode != kDynamicResTypeMode) {
+		const bool loaded = (_res->_types[type][idx]._address != NULL);
+		if (!loaded)
+			ensureResourceLoaded(type, idx);
+		_res->noteResourceAccess(type, idx, loaded);
 	}
 
 	ptr = (byte *)_res->_types[type][idx]._address;
@@ -752,6 +762,25 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 	return ptr;
 }
 
+/**
+ * Load the most recently expired resource back into memory, if prefetching
+ * is enabled and it fits into the heap without expiring anything else.
+ * Called once per frame, so at most one resource is loaded at a time.
+ */
+void ScummEngine::prefetchExpiredResource() {
+	ResType type;
+	ResId idx;
+
+	if (!_res->_prefetchExpired || !_res->getPrefetchCandidate(type, idx))
+		return;
+
+	debugC(DEBUG_RESOURCE, "prefetchExpiredResource(%s,%d)", nameOfResType(type), idx);
+
+	uint32 loadStart = _system->getMillis();
+	loadResource(type, idx);
+	_res->noteResourceLoaded(type, idx, _system->getMillis() - loadStart, true);
+}
+
 byte *ScummEngine::getStringAddress(ResId idx) {
 	byte *addr = getResourceAddress(rtString, idx);
 	return addr;
@@ -844,6 +873,7 @@ ResourceManager::Resource::Resource() {
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
+	_loadTime = 0;
 }
 
 ResourceManager::Resource::~Resource() {
@@ -872,6 +902,8 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_prefetchExpired = false;
+	resetStatistics();
 }
 
 ResourceManager::~ResourceManager() {
@@ -1032,8 +1064,101 @@ void ResourceManager::Resource::setOnHeap() {
 	_status &= ~RF_OFFHEAP;
 }
 
+void ResourceManager::Resource::setExpired() {
+	_status |= RS_EXPIRED;
+}
+
+bool ResourceManager::Resource::isExpired() const {
+	return (_status & RS_EXPIRED) != 0;
+}
+
+void ResourceManager::Resource::setPrefetched() {
+	_status |= RS_PREFETCHED;
+}
+
+bool ResourceManager::Resource::isPrefetched() const {
+	return (_status & RS_PREFETCHED) != 0;
+}
+
+void ResourceManager::Resource::clearLoadStatus() {
+	_status &= ~(RS_EXPIRED | RS_PREFETCHED);
+}
+
+void ResourceManager::noteResourceAccess(ResType type, ResId idx, bool hit) {
+	Resource &res = _types[type][idx];
+
+	if (!hit) {
+		_stats[type].misses++;
+		return;
+	}
+
+	_stats[type].hits++;
+	if (res.isPrefetched()) {
+		_stats[type].prefetchHits++;
+		res.clearLoadStatus();
+	}
+}
+
+void ResourceManager::noteResourceLoaded(ResType type, ResId idx, uint32 loadTime, bool prefetched) {
+	if (!validateResource("noteResourceLoaded", type, idx))
+		return;
+
+	Resource &res = _types[type][idx];
+	if (!res._address)
+		return;
+
+	ResTypeStats &stats = _stats[type];
+	res._loadTime = MIN<uint32>(loadTime, 0xFFFF);
+	stats.loads++;
+	stats.loadTime += loadTime;
+	if (res.isExpired()) {
+		stats.reloads++;
+		stats.reloadTime += loadTime;
+	}
+
+	res.clearLoadStatus();
+	if (prefetched) {
+		res.setPrefetched();
+		stats.prefetches++;
+	}
+}
+
+bool ResourceManager::getPrefetchCandidate(ResType &type, ResId &idx) {
+	for (int i = _expiredList.size() - 1; i >= 0; i--) {
+		const ExpiredResource &entry = _expiredList[i];
+
+		// Drop resources which were loaded again in the meantime
+		if (_types[entry.type][entry.idx]._address) {
+			_expiredList.remove_at(i);
+			continue;
+		}
+
+		if (_allocatedSize + entry.size < _minHeapThreshold) {
+			type = entry.type;
+			idx = entry.idx;
+			_expiredList.remove_at(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ResourceManager::resetStatistics() {
+	memset(_stats, 0, sizeof(_stats));
+}
+
+/**
+ * How much is gained by expiring the given resource. Resources which have
+ * not been used for a long time, which are large, and which are quick to
+ * load again are expired first.
+ */
+static uint32 expiryScore(const ResourceManager::Resource &res, byte counter) {
+	return counter * ((res._size >> 10) + 1) / (res._loadTime + 1);
+}
+
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
+	uint32 best_score;
 	ResType best_type;
 	int best_res = 0;
 	uint32 oldAllocatedSize;
@@ -1050,7 +1175,7 @@ void ResourceManager::expireResources(uint32 size) {
 
 	do {
 		best_type = rtInvalid;
-		best_counter = 2;
+		best_score = 0;
 
 		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 			if (_types[type]._mode != kDynamicResTypeMode) {
@@ -1060,10 +1185,13 @@ void ResourceManager::expireResources(uint32 size) {
 				while (idx-- > 0) {
 					Resource &tmp = _types[type][idx];
 					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
+					if (!tmp.isLocked() && counter >= 2 && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
+						uint32 score = expiryScore(tmp, counter);
+						if (score >= best_score) {
+							best_score = score;
+							best_type = type;
+							best_res = idx;
+						}
 					}
 				}
 			}
@@ -1071,7 +1199,34 @@ void ResourceManager::expireResources(uint32 size) {
 
 		if (!best_type)
 			break;
+
+		Resource &victim = _types[best_type][best_res];
+		const bool unusedPrefetch = victim.isPrefetched();
+		const uint32 victimSize = victim._size;
+
 		nukeResource(best_type, best_res);
+		victim.clearLoadStatus();
+		victim.setExpired();
+		_stats[best_type].expired++;
+
+		// Remember expired rooms, costumes and sounds so they can be
+		// prefetched again, unless they were prefetched and never used.
+		if (!unusedPrefetch && (best_type == rtRoom || best_type == rtCostume || best_type == rtSound)) {
+			for (uint i = 0; i < _expiredList.size(); i++) {
+				if (_expiredList[i].type == best_type && _expiredList[i].idx == best_res) {
+					_expiredList.remove_at(i);
+					break;
+				}
+			}
+			if (_expiredList.size() >= MAX_EXPIRED_RESOURCES)
+				_expiredList.remove_at(0);
+
+			ExpiredResource entry;
+			entry.type = best_type;
+			entry.idx = best_res;
+			entry.size = victimSize;
+			_expiredList.push_back(entry);
+		}
 	} while (size + _allocatedSize > _minHeapThreshold);
 
 	increaseResourceCounters();
@@ -1088,6 +1243,7 @@ void ResourceManager::freeResources() {
 		}
 		_types[type].clear();
 	}
+	_expiredList.clear();
 }
 
 void ScummEngine::loadPtrToResource(ResType type, ResId idx, const byte *source) {
@@ -125,6 +125,12 @@ public:
 		 */
 		uint32 _roomoffs;
 
+		/**
+		 * How long (in milliseconds) it took to load this resource from the
+		 * game data files, used to estimate the cost of expiring it.
+		 */
+		uint16 _loadTime;
+
 	public:
 		Resource();
 		~Resource();
@@ -144,6 +150,28 @@ public:
 		void setOffHeap();
 		void setOnHeap();
 		bool isOffHeap() const;
+
+		void setExpired();
+		bool isExpired() const;
+		void setPrefetched();
+		bool isPrefetched() const;
+		void clearLoadStatus();
+	};
+
+	/**
+	 * Usage statistics of a resource type, shown by the "resources"
+	 * debugger command.
+	 */
+	struct ResTypeStats {
+		uint32 hits;		///< Lookups of a resource that was loaded
+		uint32 misses;		///< Lookups of a resource that had to be loaded
+		uint32 loads;		///< Resources loaded from the data files
+		uint32 loadTime;	///< Total time spent on these loads, in ms
+		uint32 reloads;		///< Loads of resources that were expired before
+		uint32 reloadTime;	///< Total time spent on these reloads, in ms
+		uint32 expired;		///< Resources expired to free memory
+		uint32 prefetches;	///< Expired resources loaded again in advance
+		uint32 prefetchHits;	///< Prefetched resources that were used afterwards
 	};
 
 	/**
@@ -170,11 +198,29 @@ public:
 	};
 	ResTypeData _types[rtLast + 1];
 
+	ResTypeStats _stats[rtLast + 1];
+
+	/**
+	 * If set, resources of the types likely to be needed again (rooms,
+	 * costumes and sounds) that were expired to free memory are loaded
+	 * again between frames, as long as there is room for them.
+	 */
+	bool _prefetchExpired;
+
 protected:
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	struct ExpiredResource {
+		ResType type;
+		ResId idx;
+		uint32 size;
+	};
+
+	/** The most recently expired resources, candidates for prefetching. */
+	Common::Array<ExpiredResource> _expiredList;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
@@ -224,6 +270,29 @@ public:
 
 	void resourceStats();
 
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+	uint32 getMinHeapThreshold() const { return _minHeapThreshold; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
+
+	/**
+	 * Account a lookup of the given resource in the statistics, and mark a
+	 * prefetched resource as used.
+	 */
+	void noteResourceAccess(ResType type, ResId idx, bool hit);
+
+	/**
+	 * Record the time it took to load the given resource from the data files.
+	 */
+	void noteResourceLoaded(ResType type, ResId idx, uint32 loadTime, bool prefetched);
+
+	/**
+	 * Get the most recently expired resource which fits into the heap
+	 * without expiring anything else, and remove it from the list.
+	 */
+	bool getPrefetchCandidate(ResType &type, ResId &idx);
+
+	void resetStatistics();
+
 //protected:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
@@ -430,6 +430,9 @@ bool ScummEngine::loadState(int slot, bool compat) {
 				_res->nukeResource(type, idx);
 			}
 
+	// The boxes of the saved room are loaded below
+	resetBoxRoutes();
+
 	resetScummVars();
 
 	if (_game.features & GF_OLD_BUNDLE)
@@ -3034,6 +3034,7 @@ void ScummEngine_v6::o6_setBoxSet() {
 
 	assert(matrix);
 	memcpy(matrix, boxm + 8, mboxSize);
+	resetBoxRoutes();
 
 	if (_game.version == 7)
 		putActors();
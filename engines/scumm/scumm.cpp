@@ -35,6 +35,7 @@
 #include "graphics/cursorman.h"
 
 #include "scumm/akos.h"
+#include "scumm/boxes.h"
 #include "scumm/charset.h"
 #include "scumm/costume.h"
 #include "scumm/debugger.h"
@@ -136,6 +137,7 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 		_gdi = new Gdi(this);
 	}
 	_res = new ResourceManager(this);
+	_boxRoutes = new BoxRoutes();
 
 	// Convert MD5 checksum back into a digest
 	for (int i = 0; i < 16; ++i) {
@@ -640,6 +642,7 @@ ScummEngine::~ScummEngine() {
 
 	delete _debugger;
 
+	delete _boxRoutes;
 	delete _res;
 	delete _gdi;
 }
@@ -2191,6 +2194,7 @@ load_game:
 	camera._last = camera._cur;
 
 	_res->increaseExpireCounter();
+	prefetchExpiredResource();
 
 	animateCursor();
 
@@ -93,6 +93,7 @@ class Sound;
 
 struct Box;
 struct BoxCoords;
+struct BoxRoutes;
 struct FindObjectInRoom;
 
 // Use g_scumm from error() ONLY
@@ -736,6 +737,7 @@ protected:
 	int getResourceRoomNr(ResType type, ResId idx);
 	virtual uint32 getResourceRoomOffset(ResType type, ResId idx);
 	int getResourceSize(ResType type, ResId idx);
+	void prefetchExpiredResource();
 
 public:
 	byte *getResourceAddress(ResType type, ResId idx);
@@ -1118,6 +1120,9 @@ public:
 	byte getNumBoxes();
 	byte *getBoxMatrixBaseAddr();
 	int getNextBox(byte from, byte to);
+	int getSharedBoxEdge(byte box1nr, byte box2nr, BoxCoords &box1, BoxCoords &box2);
+	void getBoxGates(byte box1nr, byte box2nr, Common::Point gateA[2], Common::Point gateB[2]);
+	void resetBoxRoutes();
 
 	void setBoxFlags(int box, int val);
 	void setBoxScale(int box, int b);
@@ -1145,7 +1150,12 @@ protected:
 	void setBoxScaleSlot(int box, int slot);
 	void convertScaleTableToScaleSlot(int slot);
 
+	BoxRoutes *_boxRoutes;
+
+	void unpackBoxMatrix(int numOfBoxes);
+	bool areBoxesNeighborsCached(int box1nr, int box2nr);
 	void calcItineraryMatrix(byte *itineraryMatrix, int num);
+	void updateItineraryMatrix();
 	void createBoxMatrix();
 	virtual bool areBoxesNeighbors(int i, int j);
 
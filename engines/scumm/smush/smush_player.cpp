@@ -241,6 +241,13 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm) {
 	_paused = false;
 	_pauseStartTime = 0;
 	_pauseTime = 0;
+	_aheadBuffer = NULL;
+	_decodedAhead = false;
+	_aheadFrame = 0;
+	_aheadUpdateNeeded = false;
+	_aheadPalDirtyMin = 256;
+	_aheadPalDirtyMax = -1;
+	_benchmarking = false;
 }
 
 SmushPlayer::~SmushPlayer() {
@@ -252,6 +259,7 @@ void SmushPlayer::init(int32 speed) {
 	_frame = 0;
 	_speed = speed;
 	_endOfFile = false;
+	_decodedAhead = false;
 
 	_vm->_smushVideoShouldFinish = false;
 	_vm->_smushActive = true;
@@ -298,6 +306,18 @@ void SmushPlayer::release() {
 
 	_IACTstream = NULL;
 
+	// Leave the last frame in the main virtual screen, should it have been
+	// decoded into the decode ahead buffer
+	if (_aheadBuffer) {
+		byte *screenBuffer = _vm->_virtscr[kMainVirtScreen].getPixels(0, 0);
+		if (_dst == _aheadBuffer)
+			memcpy(screenBuffer, _aheadBuffer, _vm->_screenWidth * _vm->_screenHeight);
+		_dst = screenBuffer;
+		free(_aheadBuffer);
+		_aheadBuffer = NULL;
+	}
+	_decodedAhead = false;
+
 	_vm->_smushActive = false;
 	_vm->_fullRedraw = true;
 
@@ -855,7 +875,7 @@ void SmushPlayer::handleFrame(int32 frameSize, Common::SeekableReadStream &b) {
 			break;
 #endif
 		case MKTAG('P','S','A','D'):
-			if (!_compressedFileMode)
+			if (!_compressedFileMode && !_benchmarking)
 				handleSoundFrame(subSize, b);
 			break;
 		case MKTAG('T','R','E','S'):
@@ -865,7 +885,8 @@ void SmushPlayer::handleFrame(int32 frameSize, Common::SeekableReadStream &b) {
 			handleDeltaPalette(subSize, b);
 			break;
 		case MKTAG('I','A','C','T'):
-			handleIACT(subSize, b);
+			if (!_benchmarking)
+				handleIACT(subSize, b);
 			break;
 		case MKTAG('S','T','O','R'):
 			handleStore(subSize, b);
@@ -1078,6 +1099,56 @@ void SmushPlayer::updateScreen() {
 	debugC(DEBUG_SMUSH, "Smush stats: updateScreen( %03d )", end_time - start_time);
 }
 
+bool SmushPlayer::canDecodeAhead() const {
+	// FT INSANE runs game logic between frames, and the 384x242 frames are
+	// decoded into a buffer of their own, so both are decoded when due
+	if (_insanity || _specialBuffer)
+		return false;
+
+	// Wait until the current frame has been shown
+	if (_decodedAhead || _updateNeeded || _seekPos >= 0 || _endOfFile || !_base)
+		return false;
+
+	// Make sure there is another chunk left, so that the end of the file is
+	// only noticed once the last frame has been shown
+	return _base->pos() + 8 < (int32)_baseSize;
+}
+
+void SmushPlayer::decodeAhead() {
+	byte *screenBuffer = _vm->_virtscr[kMainVirtScreen].getPixels(0, 0);
+	const int size = _vm->_screenWidth * _vm->_screenHeight;
+
+	if (!_aheadBuffer) {
+		_aheadBuffer = (byte *)malloc(size);
+		assert(_aheadBuffer);
+	}
+
+	// Decode into the buffer which is not shown. Codecs and text only draw
+	// over parts of the frame, so start out with the shown frame.
+	byte *target = (_dst == screenBuffer) ? _aheadBuffer : screenBuffer;
+	memcpy(target, _dst, size);
+	_dst = target;
+
+	_aheadFrame = _frame;
+	timerCallback();
+
+	// Hold back the screen update and palette changes until the frame is due
+	_aheadUpdateNeeded = _updateNeeded;
+	_updateNeeded = false;
+	_aheadPalDirtyMin = _palDirtyMin;
+	_aheadPalDirtyMax = _palDirtyMax;
+	_palDirtyMin = 256;
+	_palDirtyMax = -1;
+
+	_decodedAhead = true;
+}
+
+void SmushPlayer::presentDecodedAhead() {
+	_updateNeeded = _aheadUpdateNeeded;
+	setDirtyColors(_aheadPalDirtyMin, _aheadPalDirtyMax);
+	_decodedAhead = false;
+}
+
 void SmushPlayer::insanity(bool flag) {
 	_insanity = flag;
 }
@@ -1198,12 +1269,16 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 			elapsed = now - _startTime;
 		}
 
-		if (elapsed >= ((_frame - _startFrame) * 1000) / _speed) {
-			if (elapsed >= ((_frame + 1) * 1000) / _speed)
+		const uint32 nextFrame = _decodedAhead ? _aheadFrame : _frame;
+		if (elapsed >= ((nextFrame - _startFrame) * 1000) / _speed) {
+			if (elapsed >= ((nextFrame + 1) * 1000) / _speed)
 				skipFrame = true;
 			else
 				skipFrame = false;
-			timerCallback();
+			if (_decodedAhead)
+				presentDecodedAhead();
+			else
+				timerCallback();
 		}
 
 		_vm->scummLoop_handleSound();
@@ -1249,6 +1324,11 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 			_IACTpos = 0;
 			break;
 		}
+
+		// Use the time until the next frame is due to decode it
+		if (canDecodeAhead())
+			decodeAhead();
+
 		_vm->_system->delayMillis(10);
 	}
 
@@ -1258,4 +1338,45 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 	CursorMan.showMouse(oldMouseState);
 }
 
+bool SmushPlayer::benchmark(const char *filename, uint32 &frames, uint32 &time) {
+	ScummFile f;
+	_vm->openFile(f, filename);
+	if (!f.isOpen())
+		return false;
+	f.close();
+
+	// Decode all frames as fast as possible, without audio and without
+	// presenting them
+	_benchmarking = true;
+	_updateNeeded = false;
+	_warpNeeded = false;
+	_palDirtyMin = 256;
+	_palDirtyMax = -1;
+
+	_seekFile = filename;
+	_seekPos = 0;
+	_seekFrame = 0;
+	_base = 0;
+
+	setupAnim(filename);
+	init(12);
+
+	_startFrame = 0;
+	_frame = 0;
+	_pauseTime = 0;
+
+	uint32 startTime = _vm->_system->getMillis();
+	while (!_endOfFile)
+		parseNextFrame();
+	time = _vm->_system->getMillis() - startTime;
+	frames = _frame;
+
+	_smixer->stop();
+	_vm->_mixer->stopHandle(_compressedFileSoundHandle);
+	release();
+	_benchmarking = false;
+
+	return true;
+}
+
 } // End of namespace Scumm
@@ -82,6 +82,16 @@ private:
 	bool _middleAudio;
 	bool _skipPalette;
 
+	// The next frame is decoded ahead into a second buffer while the
+	// current one is shown, and only presented once it is due
+	byte *_aheadBuffer;
+	bool _decodedAhead;
+	uint32 _aheadFrame;
+	bool _aheadUpdateNeeded;
+	int _aheadPalDirtyMin, _aheadPalDirtyMax;
+
+	bool _benchmarking;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm);
 	~SmushPlayer();
@@ -90,6 +100,7 @@ public:
 	void unpause();
 
 	void play(const char *filename, int32 speed, int32 offset = 0, int32 startFrame = 0);
+	bool benchmark(const char *filename, uint32 &frames, uint32 &time);
 	void release();
 	void warpMouse(int x, int y, int buttons);
 
@@ -116,6 +127,10 @@ private:
 	void updateScreen();
 	void tryCmpFile(const char *filename);
 
+	bool canDecodeAhead() const;
+	void decodeAhead();
+	void presentDecodedAhead();
+
 	bool readString(const char *file);
 	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height);
 	void handleAnimHeader(int32 subSize, Common::SeekableReadStream &);
@@ -22,13 +22,47 @@
 
 #include "sword25/console.h"
 #include "sword25/sword25.h"
+#include "sword25/kernel/kernel.h"
+#include "sword25/kernel/resmanager.h"
+#include "sword25/script/luascript.h"
+#include "sword25/util/lua/lstate.h"
 
 namespace Sword25 {
 
 Sword25Console::Sword25Console(Sword25Engine *vm) : GUI::Debugger(), _vm(vm) {
+	DCmd_Register("resources", WRAP_METHOD(Sword25Console, Cmd_Resources));
+	DCmd_Register("lua_stats", WRAP_METHOD(Sword25Console, Cmd_LuaStats));
 }
 
 Sword25Console::~Sword25Console() {
 }
 
+bool Sword25Console::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *resourceManager = Kernel::getInstance()->getResourceManager();
+	DebugPrintf("%s", resourceManager->getStatistics().c_str());
+	return true;
+}
+
+bool Sword25Console::Cmd_LuaStats(int argc, const char **argv) {
+	lua_State *L = static_cast<lua_State *>(Kernel::getInstance()->getScript()->getScriptObject());
+	const VMStats &stats = G(L)->vmstats;
+
+	unsigned long accesses = stats.tcachehits + stats.tcachemisses;
+	DebugPrintf("Table accesses by string: %lu, %lu found through the inline caches (%lu%%)\n",
+	            accesses, stats.tcachehits, accesses ? stats.tcachehits * 100 / accesses : 0);
+	DebugPrintf("Interned strings: %d in %d buckets\n", G(L)->strt.nuse, G(L)->strt.size);
+	DebugPrintf("%s", static_cast<LuaScriptEngine *>(Kernel::getInstance()->getScript())->getStatistics().c_str());
+
+#ifdef LUAI_OPCOUNTS
+	for (int i = 0; i < NUM_OPCODES; i++) {
+		if (stats.opcounts[i])
+			DebugPrintf("%-10s %lu\n", luaP_opnames[i], stats.opcounts[i]);
+	}
+#else
+	DebugPrintf("Opcode counts are not available, LUAI_OPCOUNTS is not defined\n");
+#endif
+
+	return true;
+}
+
 } // End of namespace Sword25
@@ -36,6 +36,9 @@ public:
 
 private:
 	Sword25Engine *_vm;
+
+	bool Cmd_Resources(int argc, const char **argv);
+	bool Cmd_LuaStats(int argc, const char **argv);
 };
 
 } // End of namespace Sword25
@@ -110,6 +110,8 @@ bool DynamicBitmap::doRender() {
 }
 
 bool DynamicBitmap::setContent(const byte *pixeldata, uint size, uint offset, uint stride) {
+	// The new content has to be redrawn even though the object did not move
+	forceRefresh();
 	return _image->setContent(pixeldata, size, offset, stride);
 }
 
@@ -44,6 +44,8 @@
 #include "sword25/package/packagemanager.h"
 #include "sword25/kernel/inputpersistenceblock.h"
 #include "sword25/kernel/outputpersistenceblock.h"
+#include "sword25/kernel/resmanager.h"
+#include "sword25/script/script.h"
 
 
 #include "sword25/gfx/graphicengine.h"
@@ -61,6 +63,8 @@ enum {
 namespace Sword25 {
 
 static const uint FRAMETIME_SAMPLE_COUNT = 5;       // Anzahl der Framezeiten ber die, die Framezeit gemittelt wird
+static const uint32 PRECACHE_TIME_BUDGET = 5;          // Time in milliseconds spent per frame on loading precached resources
+static const uint32 SCRIPT_GC_TIME_BUDGET = 2;         // Time in milliseconds spent per frame on collecting script garbage
 
 GraphicEngine::GraphicEngine(Kernel *pKernel) :
 	_width(0),
@@ -107,6 +111,7 @@ bool GraphicEngine::init(int width, int height, int bitDepth, int backbufferCoun
 	_screenRect.top = 0;
 	_screenRect.right = _width;
 	_screenRect.bottom = _height;
+	_clipRect = _screenRect;
 
 	const Graphics::PixelFormat format = g_system->getScreenFormat();
 
@@ -132,6 +137,9 @@ bool GraphicEngine::startFrame(bool updateAll) {
 	// Dieser Wert kann ber GetLastFrameDuration() von Modulen abgefragt werden, die zeitabhngig arbeiten.
 	updateLastFrameDuration();
 
+	if (updateAll)
+		_renderObjectManagerPtr->invalidateScreen();
+
 	// Den Layer-Manager auf den nchsten Frame vorbereiten
 	_renderObjectManagerPtr->startFrame();
 
@@ -140,14 +148,23 @@ bool GraphicEngine::startFrame(bool updateAll) {
 
 bool GraphicEngine::endFrame() {
 #ifndef THEORA_INDIRECT_RENDERING
-	if (Kernel::getInstance()->getFMV()->isMovieLoaded())
+	if (Kernel::getInstance()->getFMV()->isMovieLoaded()) {
+		// The movie is drawn directly to the screen
+		_renderObjectManagerPtr->invalidateScreen();
+		Kernel::getInstance()->getScript()->collectGarbage(SCRIPT_GC_TIME_BUDGET);
 		return true;
+	}
 #endif
 
 	_renderObjectManagerPtr->render();
 
 	g_system->updateScreen();
 
+	// Load some of the resources the scripts want to have precached
+	Kernel::getInstance()->getResourceManager()->processPrecacheQueue(PRECACHE_TIME_BUDGET);
+
+	Kernel::getInstance()->getScript()->collectGarbage(SCRIPT_GC_TIME_BUDGET);
+
 	return true;
 }
 
@@ -181,6 +198,9 @@ bool GraphicEngine::fill(const Common::Rect *fillRectPtr, uint color) {
 		rect = *fillRectPtr;
 	}
 
+	if (rect.isValidRect())
+		rect.clip(_clipRect);
+
 	if (rect.width() > 0 && rect.height() > 0) {
 		if (ca == 0xff) {
 			_backSurface.fillRect(rect, color);
@@ -215,8 +235,6 @@ bool GraphicEngine::fill(const Common::Rect *fillRectPtr, uint color) {
 				outo += _backSurface.pitch;
 			}
 		}
-
-		g_system->copyRectToScreen(_backSurface.getBasePtr(rect.left, rect.top), _backSurface.pitch, rect.left, rect.top, rect.width(), rect.height());
 	}
 
 	return true;
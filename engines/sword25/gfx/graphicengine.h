@@ -229,6 +229,17 @@ public:
 	 */
 	bool fill(const Common::Rect *fillRectPtr = 0, uint color = BS_RGB(0, 0, 0));
 
+	/**
+	 * Restricts all drawing into the back surface to the given rectangle.
+	 * The render object manager sets it to each of the areas it redraws.
+	 */
+	void setClipRect(const Common::Rect &rect) {
+		_clipRect = rect;
+	}
+	const Common::Rect &getClipRect() const {
+		return _clipRect;
+	}
+
 	Graphics::Surface _backSurface;
 	Graphics::Surface *getSurface() { return &_backSurface; }
 
@@ -290,6 +301,7 @@ protected:
 	int _width;
 	int _height;
 	Common::Rect _screenRect;
+	Common::Rect _clipRect;
 	int _bitDepth;
 
 	/**
@@ -163,6 +163,12 @@ public:
 	*/
 	virtual uint getPixel(int x, int y) = 0;
 
+	/**
+	    @brief Returns the number of bytes the image data occupies in memory.
+	    @remark The resource manager uses this to keep the cache within its memory limit.
+	*/
+	virtual uint getMemoryUsage() const = 0;
+
 	//@{
 	/** @name Information methodes */
 
@@ -33,28 +33,33 @@
 #include "sword25/gfx/image/image.h"
 #include "sword25/gfx/image/imgloader.h"
 #include "graphics/pixelformat.h"
+#include "graphics/surface.h"
 #include "graphics/decoders/png.h"
 
 namespace Sword25 {
 
 bool ImgLoader::decodePNGImage(const byte *fileDataPtr, uint fileSize, byte *&uncompressedDataPtr, int &width, int &height, int &pitch) {
-	Common::MemoryReadStream *fileStr = new Common::MemoryReadStream(fileDataPtr, fileSize, DisposeAfterUse::NO);
+	Common::MemoryReadStream fileStr(fileDataPtr, fileSize, DisposeAfterUse::NO);
 
 	Graphics::PNGDecoder png;
-	if (!png.loadStream(*fileStr)) // the fileStr pointer, and thus pFileData will be deleted after this is done
+	if (!png.loadHeader(fileStr))
 		error("Error while reading PNG image");
 
-	const Graphics::Surface *sourceSurface = png.getSurface();
-	Graphics::Surface *pngSurface = sourceSurface->convertTo(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), png.getPalette());
-
-	width = pngSurface->w;
-	height = pngSurface->h;
-	uncompressedDataPtr = new byte[pngSurface->pitch * pngSurface->h];
-	memcpy(uncompressedDataPtr, (byte *)pngSurface->pixels, pngSurface->pitch * pngSurface->h);
-	pngSurface->free();
-
-	delete pngSurface;
-	delete fileStr;
+	width = png.getWidth();
+	height = png.getHeight();
+	pitch = width * 4;
+	uncompressedDataPtr = new byte[pitch * height];
+
+	// The rows are decoded and converted directly into the image data
+	Graphics::Surface dst;
+	dst.w = width;
+	dst.h = height;
+	dst.pitch = pitch;
+	dst.pixels = uncompressedDataPtr;
+	dst.format = Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+	if (png.decodeRows(dst) != (uint)height)
+		error("Error while decoding PNG image");
 
 	// Signal success
 	return true;
@@ -34,7 +34,9 @@
 // -----------------------------------------------------------------------------
 
 #include "common/savefile.h"
+#include "sword25/kernel/kernel.h"
 #include "sword25/package/packagemanager.h"
+#include "sword25/gfx/graphicengine.h"
 #include "sword25/gfx/image/imgloader.h"
 #include "sword25/gfx/image/renderedimage.h"
 
@@ -73,16 +75,22 @@ static byte *readSavegameThumbnail(const Common::String &filename, uint &fileSiz
 	// Seek to the actual PNG image
 	loadString(*file);		// Marker (BS25SAVEGAME)
 	Common::String storedVersionID = loadString(*file);		// Version
+	int version = 1;
 	if (storedVersionID != "SCUMMVM1")
-		loadString(*file);
+		version = atoi(loadString(*file).c_str());
 
 	loadString(*file);		// Description
-	uint32 compressedGamedataSize = atoi(loadString(*file).c_str());
-	loadString(*file);		// Uncompressed game data size
-	file->skip(compressedGamedataSize);	// Skip the game data and move to the thumbnail itself
-	uint32 thumbnailStart = file->pos();
+	if (version >= 3) {
+		// The thumbnail comes before the game data
+		fileSize = atoi(loadString(*file).c_str());
+	} else {
+		uint32 compressedGamedataSize = atoi(loadString(*file).c_str());
+		loadString(*file);		// Uncompressed game data size
+		file->skip(compressedGamedataSize);	// Skip the game data and move to the thumbnail itself
+		uint32 thumbnailStart = file->pos();
 
-	fileSize = file->size() - thumbnailStart;
+		fileSize = file->size() - thumbnailStart;
+	}
 
 	// Check if the thumbnail is in our own format, or a PNG file.
 	uint32 header = file->readUint32BE();
@@ -99,7 +107,12 @@ static byte *readSavegameThumbnail(const Common::String &filename, uint &fileSiz
 RenderedImage::RenderedImage(const Common::String &filename, bool &result) :
 	_data(0),
 	_width(0),
-	_height(0) {
+	_height(0),
+	_alphaType(ALPHA_UNKNOWN),
+	_runs(0),
+	_runPixels(0),
+	_rowRunStart(0),
+	_rowPixelStart(0) {
 	result = false;
 
 	PackageManager *pPackage = Kernel::getInstance()->getPackage();
@@ -142,6 +155,9 @@ RenderedImage::RenderedImage(const Common::String &filename, bool &result) :
 
 	_doCleanup = true;
 
+	// Loaded images never change, so store them in the compact form
+	compress();
+
 	return;
 }
 
@@ -149,7 +165,12 @@ RenderedImage::RenderedImage(const Common::String &filename, bool &result) :
 
 RenderedImage::RenderedImage(uint width, uint height, bool &result) :
 	_width(width),
-	_height(height) {
+	_height(height),
+	_alphaType(ALPHA_UNKNOWN),
+	_runs(0),
+	_runPixels(0),
+	_rowRunStart(0),
+	_rowPixelStart(0) {
 
 	_data = new byte[width * height * 4];
 	Common::fill(_data, &_data[width * height * 4], 0);
@@ -162,7 +183,8 @@ RenderedImage::RenderedImage(uint width, uint height, bool &result) :
 	return;
 }
 
-RenderedImage::RenderedImage() : _width(0), _height(0), _data(0) {
+RenderedImage::RenderedImage() : _width(0), _height(0), _data(0), _alphaType(ALPHA_UNKNOWN),
+	_runs(0), _runPixels(0), _rowRunStart(0), _rowPixelStart(0) {
 	_backSurface = Kernel::getInstance()->getGfx()->getSurface();
 
 	_doCleanup = false;
@@ -175,6 +197,11 @@ RenderedImage::RenderedImage() : _width(0), _height(0), _data(0) {
 RenderedImage::~RenderedImage() {
 	if (_doCleanup)
 		delete[] _data;
+
+	delete[] _runs;
+	delete[] _runPixels;
+	delete[] _rowRunStart;
+	delete[] _rowPixelStart;
 }
 
 // -----------------------------------------------------------------------------
@@ -187,6 +214,11 @@ bool RenderedImage::fill(const Common::Rect *pFillRect, uint color) {
 // -----------------------------------------------------------------------------
 
 bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, uint stride) {
+	if (_runs) {
+		error("SetContent() is not supported on compressed images.");
+		return false;
+	}
+
 	// Check if PixelData contains enough pixel to create an image with image size equals width * height
 	if (size < static_cast<uint>(_width * _height * 4)) {
 		error("PixelData vector is too small to define a 32 bit %dx%d image.", _width, _height);
@@ -202,6 +234,8 @@ bool RenderedImage::setContent(const byte *pixeldata, uint size, uint offset, ui
 		in += stride;
 	}
 
+	_alphaType = ALPHA_UNKNOWN;
+
 	return true;
 }
 
@@ -209,6 +243,9 @@ void RenderedImage::replaceContent(byte *pixeldata, int width, int height) {
 	_width = width;
 	_height = height;
 	_data = pixeldata;
+
+	// The content is replaced for every frame, so don't scan it
+	_alphaType = ALPHA_FULL;
 }
 // -----------------------------------------------------------------------------
 
@@ -217,7 +254,327 @@ uint RenderedImage::getPixel(int x, int y) {
 	return 0;
 }
 
+uint RenderedImage::getMemoryUsage() const {
+	if (_runs)
+		return _rowRunStart[_height] * 2 + _rowPixelStart[_height] * 4 + (_height + 1) * 8;
+	else if (_doCleanup)
+		return _width * _height * 4;
+	else
+		return 0;
+}
+
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// BLITTING
+// -----------------------------------------------------------------------------
+
+/**
+ * Applies the color modulation to a pixel drawn with full opacity.
+ */
+static inline uint32 tintPixel(uint32 pix, int cr, int cg, int cb) {
+	int b = (pix >> 0) & 0xff;
+	int g = (pix >> 8) & 0xff;
+	int r = (pix >> 16) & 0xff;
+
+	if (cb != 255)
+		b = (b * cb) >> 8;
+	if (cg != 255)
+		g = (g * cg) >> 8;
+	if (cr != 255)
+		r = (r * cr) >> 8;
+
+	return 0xff000000 | (r << 16) | (g << 8) | b;
+}
+
+static inline int blendChannel(int dst, int src, int a, int c) {
+	if (c == 0)
+		return 0;
+	else if (c != 255)
+		return (dst + (((src - dst) * a * c) >> 16)) & 0xff;
+	else
+		return (dst + (((src - dst) * a) >> 8)) & 0xff;
+}
+
+/**
+ * Blits a row of pixels. The kernel is specialized on the kind of alpha
+ * values found in the image, on whether a color modulation has to be
+ * applied, and on whether the source pixels are picked through a column
+ * table (for flipped or scaled blits) or read one after the other.
+ */
+template<int alphaType, bool tinted, bool indexed>
+static void blitRow(uint32 *out, const uint32 *in, const int *columns, int width, int ca, int cr, int cg, int cb) {
+	if (alphaType == RenderedImage::ALPHA_OPAQUE && !tinted && !indexed) {
+		memcpy(out, in, width * 4);
+		return;
+	}
+
+	for (int j = 0; j < width; j++, out++) {
+		uint32 pix = indexed ? in[columns[j]] : in[j];
+
+		if (alphaType == RenderedImage::ALPHA_OPAQUE) {
+			*out = tinted ? tintPixel(pix, cr, cg, cb) : pix;
+			continue;
+		}
+
+		int a = (pix >> 24) & 0xff;
+		if (tinted && ca != 255)
+			a = a * ca >> 8;
+
+		if (a == 0)
+			continue;
+
+		if (a == 255 || alphaType == RenderedImage::ALPHA_BINARY) {
+			*out = tinted ? tintPixel(pix, cr, cg, cb) : pix;
+			continue;
+		}
+
+		// Only reached by images with translucent pixels
+		uint32 dst = *out;
+		int b, g, r;
+		if (tinted) {
+			b = blendChannel((dst >> 0) & 0xff, (pix >> 0) & 0xff, a, cb);
+			g = blendChannel((dst >> 8) & 0xff, (pix >> 8) & 0xff, a, cg);
+			r = blendChannel((dst >> 16) & 0xff, (pix >> 16) & 0xff, a, cr);
+		} else {
+			b = (dst >> 0) & 0xff;
+			g = (dst >> 8) & 0xff;
+			r = (dst >> 16) & 0xff;
+			b = (b + ((((int)(pix >> 0) & 0xff) - b) * a >> 8)) & 0xff;
+			g = (g + ((((int)(pix >> 8) & 0xff) - g) * a >> 8)) & 0xff;
+			r = (r + ((((int)(pix >> 16) & 0xff) - r) * a >> 8)) & 0xff;
+		}
+		*out = 0xff000000 | (r << 16) | (g << 8) | b;
+	}
+}
+
+typedef RenderedImage::BlitRowProc BlitRowProc;
+
+template<int alphaType>
+static BlitRowProc getBlitRowProc(bool tinted, bool indexed) {
+	if (tinted)
+		return indexed ? blitRow<alphaType, true, true> : blitRow<alphaType, true, false>;
+	else
+		return indexed ? blitRow<alphaType, false, true> : blitRow<alphaType, false, false>;
+}
+
 // -----------------------------------------------------------------------------
+// COMPRESSED IMAGES
+// -----------------------------------------------------------------------------
+
+// Every run header stores its kind in the upper two bits and its length in
+// the lower ones
+#define RUN_LENGTH_BITS 14
+#define MAX_RUN_LENGTH ((1 << RUN_LENGTH_BITS) - 1)
+
+static inline int getRunType(uint32 pix) {
+	uint32 a = pix >> 24;
+	if (a == 0)
+		return RenderedImage::RUN_TRANSPARENT;
+	else if (a == 255)
+		return RenderedImage::RUN_OPAQUE;
+	else
+		return RenderedImage::RUN_TRANSLUCENT;
+}
+
+static inline uint32 premultiplyPixel(uint32 pix) {
+	uint32 a = pix >> 24;
+	uint32 r = (((pix >> 16) & 0xff) * a + 127) / 255;
+	uint32 g = (((pix >> 8) & 0xff) * a + 127) / 255;
+	uint32 b = ((pix & 0xff) * a + 127) / 255;
+	return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// x * y / 255, rounded
+static inline int mul255(int x, int y) {
+	int t = x * y + 128;
+	return (t + (t >> 8)) >> 8;
+}
+
+static inline int blendPremultipliedChannel(int dst, int src, int a, int ca, int c) {
+	if (c == 0)
+		return 0;
+	else if (c != 255)
+		return MIN(255, dst - ((dst * a * c) >> 16) + ((src * ca * c) >> 16));
+	else
+		return MIN(255, dst - ((dst * a) >> 8) + ((src * ca) >> 8));
+}
+
+/**
+ * Blits a row of pixels with premultiplied alpha. The colors match those of
+ * blitRow() for the unmultiplied pixels, apart from rounding of up to one
+ * step per channel.
+ */
+template<bool tinted, bool indexed>
+static void blitPremultipliedRow(uint32 *out, const uint32 *in, const int *columns, int width, int ca, int cr, int cg, int cb) {
+	for (int j = 0; j < width; j++, out++) {
+		uint32 pix = indexed ? in[columns[j]] : in[j];
+
+		int a = (pix >> 24) & 0xff;
+		if (a == 0)
+			continue;
+
+		if (!tinted) {
+			if (a == 255) {
+				*out = pix;
+			} else {
+				uint32 dst = *out;
+				int b = (pix & 0xff) + mul255(dst & 0xff, 255 - a);
+				int g = ((pix >> 8) & 0xff) + mul255((dst >> 8) & 0xff, 255 - a);
+				int r = ((pix >> 16) & 0xff) + mul255((dst >> 16) & 0xff, 255 - a);
+				*out = 0xff000000 | (r << 16) | (g << 8) | b;
+			}
+			continue;
+		}
+
+		if (a == 255 && ca == 255) {
+			*out = tintPixel(pix, cr, cg, cb);
+			continue;
+		}
+
+		// The color channels are already weighted with the pixel alpha,
+		// only the constant alpha has to be applied to them
+		if (ca != 255)
+			a = a * ca >> 8;
+
+		uint32 dst = *out;
+		int b = blendPremultipliedChannel((dst >> 0) & 0xff, (pix >> 0) & 0xff, a, ca, cb);
+		int g = blendPremultipliedChannel((dst >> 8) & 0xff, (pix >> 8) & 0xff, a, ca, cg);
+		int r = blendPremultipliedChannel((dst >> 16) & 0xff, (pix >> 16) & 0xff, a, ca, cr);
+		*out = 0xff000000 | (r << 16) | (g << 8) | b;
+	}
+}
+
+template<bool tinted>
+static BlitRowProc getPremultipliedRowProc(bool indexed) {
+	return indexed ? blitPremultipliedRow<tinted, true> : blitPremultipliedRow<tinted, false>;
+}
+
+void RenderedImage::compress() {
+	const uint32 *pix = (const uint32 *)_data;
+
+	// Count the runs and the pixels which have to be stored
+	uint runCount = 0;
+	uint pixelCount = 0;
+	for (int y = 0; y < _height; y++) {
+		const uint32 *row = pix + y * _width;
+		int x = 0;
+		while (x < _width) {
+			int type = getRunType(row[x]);
+			int length = 1;
+			while (x + length < _width && length < MAX_RUN_LENGTH && getRunType(row[x + length]) == type)
+				length++;
+
+			runCount++;
+			if (type != RUN_TRANSPARENT)
+				pixelCount += length;
+			x += length;
+		}
+	}
+
+	// Images with few transparent pixels are faster and smaller as they are
+	uint compressedSize = runCount * 2 + pixelCount * 4 + (_height + 1) * 8;
+	uint rawSize = _width * _height * 4;
+	if (compressedSize >= rawSize)
+		return;
+
+	_runs = new uint16[runCount];
+	_runPixels = new uint32[pixelCount];
+	_rowRunStart = new uint32[_height + 1];
+	_rowPixelStart = new uint32[_height + 1];
+
+	uint16 *run = _runs;
+	uint32 *out = _runPixels;
+	for (int y = 0; y < _height; y++) {
+		const uint32 *row = pix + y * _width;
+		_rowRunStart[y] = run - _runs;
+		_rowPixelStart[y] = out - _runPixels;
+
+		int x = 0;
+		while (x < _width) {
+			int type = getRunType(row[x]);
+			int length = 1;
+			while (x + length < _width && length < MAX_RUN_LENGTH && getRunType(row[x + length]) == type)
+				length++;
+
+			*run++ = (type << RUN_LENGTH_BITS) | length;
+			if (type == RUN_OPAQUE) {
+				memcpy(out, row + x, length * 4);
+				out += length;
+			} else if (type == RUN_TRANSLUCENT) {
+				for (int i = 0; i < length; i++)
+					*out++ = premultiplyPixel(row[x + i]);
+			}
+			x += length;
+		}
+	}
+	_rowRunStart[_height] = runCount;
+	_rowPixelStart[_height] = pixelCount;
+
+	debug(5, "Compressed %dx%d image to %d%% of its size (%d runs)", _width, _height, compressedSize * 100 / rawSize, runCount);
+
+	delete[] _data;
+	_data = 0;
+}
+
+void RenderedImage::expandRow(int y, uint32 *out) const {
+	const uint16 *run = _runs + _rowRunStart[y];
+	const uint16 *runEnd = _runs + _rowRunStart[y + 1];
+	const uint32 *in = _runPixels + _rowPixelStart[y];
+
+	for (; run < runEnd; run++) {
+		int length = *run & MAX_RUN_LENGTH;
+		if ((*run >> RUN_LENGTH_BITS) == RUN_TRANSPARENT) {
+			memset(out, 0, length * 4);
+		} else {
+			memcpy(out, in, length * 4);
+			in += length;
+		}
+		out += length;
+	}
+}
+
+void RenderedImage::blitRuns(uint32 *out, int y, int x, int width, BlitRowProc blitRowProc, bool tinted, int ca, int cr, int cg, int cb) const {
+	const uint16 *run = _runs + _rowRunStart[y];
+	const uint16 *runEnd = _runs + _rowRunStart[y + 1];
+	const uint32 *in = _runPixels + _rowPixelStart[y];
+	int end = x + width;
+
+	// Transparent runs are skipped, opaque ones copied as they are
+	for (int pos = 0; run < runEnd && pos < end; run++) {
+		int type = *run >> RUN_LENGTH_BITS;
+		int length = *run & MAX_RUN_LENGTH;
+		int first = MAX(pos, x);
+		int last = MIN(pos + length, end);
+
+		if (type != RUN_TRANSPARENT) {
+			if (first < last) {
+				if (type == RUN_OPAQUE && !tinted)
+					memcpy(out + first - x, in + first - pos, (last - first) * 4);
+				else
+					blitRowProc(out + first - x, in + first - pos, NULL, last - first, ca, cr, cg, cb);
+			}
+			in += length;
+		}
+		pos += length;
+	}
+}
+
+void RenderedImage::detectAlphaType() {
+	_alphaType = ALPHA_OPAQUE;
+
+	const uint32 *pix = (const uint32 *)_data;
+	for (int i = 0; i < _width * _height; i++) {
+		uint32 a = pix[i] >> 24;
+		if (a != 255) {
+			if (a != 0) {
+				_alphaType = ALPHA_FULL;
+				return;
+			}
+			_alphaType = ALPHA_BINARY;
+		}
+	}
+}
 
 bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height) {
 	int ca = (color >> 24) & 0xff;
@@ -238,32 +595,34 @@ bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRe
 		cb = cb * ca >> 8;
 	}
 
-	// Create an encapsulating surface for the data
-	Graphics::Surface srcImage;
 	// TODO: Is the data really in the screen format?
-	srcImage.format = g_system->getScreenFormat();
-	srcImage.pitch = _width * 4;
-	srcImage.w = _width;
-	srcImage.h = _height;
-	srcImage.pixels = _data;
+	const byte *srcPixels = _data;
+	int srcWidth = _width;
+	int srcHeight = _height;
+	const int srcPitch = _width * 4;
+
+	int srcLeft = 0, srcTop = 0;
 
 	if (pPartRect) {
-		srcImage.pixels = &_data[pPartRect->top * srcImage.pitch + pPartRect->left * 4];
-		srcImage.w = pPartRect->right - pPartRect->left;
-		srcImage.h = pPartRect->bottom - pPartRect->top;
+		srcLeft = pPartRect->left;
+		srcTop = pPartRect->top;
+		if (_data)
+			srcPixels = &_data[pPartRect->top * srcPitch + pPartRect->left * 4];
+		srcWidth = pPartRect->right - pPartRect->left;
+		srcHeight = pPartRect->bottom - pPartRect->top;
 
 		debug(6, "Blit(%d, %d, %d, [%d, %d, %d, %d], %08x, %d, %d)", posX, posY, flipping,
 			pPartRect->left,  pPartRect->top, pPartRect->width(), pPartRect->height(), color, width, height);
 	} else {
 
 		debug(6, "Blit(%d, %d, %d, [%d, %d, %d, %d], %08x, %d, %d)", posX, posY, flipping, 0, 0,
-			srcImage.w, srcImage.h, color, width, height);
+			srcWidth, srcHeight, color, width, height);
 	}
 
 	if (width == -1)
-		width = srcImage.w;
+		width = srcWidth;
 	if (height == -1)
-		height = srcImage.h;
+		height = srcHeight;
 
 #ifdef SCALING_TESTING
 	// Hardcode scaling to 66% to test scaling
@@ -271,179 +630,125 @@ bool RenderedImage::blit(int posX, int posY, int flipping, Common::Rect *pPartRe
 	height = height * 2 / 3;
 #endif
 
-	Graphics::Surface *img;
-	Graphics::Surface *imgScaled = NULL;
-	byte *savedPixels = NULL;
-	if ((width != srcImage.w) || (height != srcImage.h)) {
-		// Scale the image
-		img = imgScaled = scale(srcImage, width, height);
-		savedPixels = (byte *)img->pixels;
-	} else {
-		img = &srcImage;
-	}
-
-	// Handle off-screen clipping
-	if (posY < 0) {
-		img->h = MAX(0, (int)img->h - -posY);
-		img->pixels = (byte *)img->pixels + img->pitch * -posY;
-		posY = 0;
+	// Scaled images are sampled on the fly, the tables map the columns and
+	// rows of the scaled image to those of the source image
+	int *horizUsage = NULL;
+	int *vertUsage = NULL;
+	if ((width != srcWidth) || (height != srcHeight)) {
+		horizUsage = scaleLine(width, srcWidth);
+		vertUsage = scaleLine(height, srcHeight);
 	}
 
-	if (posX < 0) {
-		img->w = MAX(0, (int)img->w - -posX);
-		img->pixels = (byte *)img->pixels + (-posX * 4);
-		posX = 0;
-	}
+	// Clip against the screen and the area currently being redrawn
+	Common::Rect clipRect = Kernel::getInstance()->getGfx()->getClipRect();
+	clipRect.clip(Common::Rect(_backSurface->w, _backSurface->h));
+
+	int x0 = MAX<int>(posX, clipRect.left);
+	int y0 = MAX<int>(posY, clipRect.top);
+	int w = MIN<int>(posX + width, clipRect.right) - x0;
+	int h = MIN<int>(posY + height, clipRect.bottom) - y0;
+	int clipX = x0 - posX, clipY = y0 - posY;
+	posX = x0;
+	posY = y0;
+
+	if ((w > 0) && (h > 0)) {
+		bool tinted = (ca != 255 || cr != 255 || cg != 255 || cb != 255);
+		bool indexed = (horizUsage != NULL) || (flipping & Image::FLIP_V);
+
+		// FLIP_V mirrors the image horizontally, FLIP_H vertically
+		int *columns = NULL;
+		if (indexed) {
+			columns = new int[w];
+			for (int j = 0; j < w; j++) {
+				int x = clipX + j;
+				if (flipping & Image::FLIP_V)
+					x = width - 1 - x;
+				columns[j] = horizUsage ? horizUsage[x] : x;
+			}
+		}
 
-	img->w = CLIP((int)img->w, 0, (int)MAX((int)_backSurface->w - posX, 0));
-	img->h = CLIP((int)img->h, 0, (int)MAX((int)_backSurface->h - posY, 0));
+		byte *outo = (byte *)_backSurface->getBasePtr(posX, posY);
 
-	if ((img->w > 0) && (img->h > 0)) {
-		int xp = 0, yp = 0;
+		if (_runs) {
+			BlitRowProc blitRowProc = tinted ? getPremultipliedRowProc<true>(indexed) : getPremultipliedRowProc<false>(indexed);
+
+			// Flipped and scaled blits pick single pixels, so the rows are
+			// expanded first. Rows repeated by scaling are only expanded once.
+			uint32 *rowBuffer = NULL;
+			int bufferedRow = -1;
+			if (indexed)
+				rowBuffer = new uint32[_width];
+
+			for (int i = 0; i < h; i++) {
+				int y = clipY + i;
+				if (flipping & Image::FLIP_H)
+					y = height - 1 - y;
+				if (vertUsage)
+					y = vertUsage[y];
+				y += srcTop;
+
+				if (indexed) {
+					if (y != bufferedRow) {
+						expandRow(y, rowBuffer);
+						bufferedRow = y;
+					}
+					blitRowProc((uint32 *)outo, rowBuffer + srcLeft, columns, w, ca, cr, cg, cb);
+				} else {
+					blitRuns((uint32 *)outo, y, srcLeft + clipX, w, blitRowProc, tinted, ca, cr, cg, cb);
+				}
+				outo += _backSurface->pitch;
+			}
 
-		int inStep = 4;
-		int inoStep = img->pitch;
-		if (flipping & Image::FLIP_V) {
-			inStep = -inStep;
-			xp = img->w - 1;
-		}
+			delete[] rowBuffer;
+		} else {
+			if (_alphaType == ALPHA_UNKNOWN)
+				detectAlphaType();
+
+			// Blitting with a constant alpha makes every pixel translucent
+			int alphaType = (ca != 255) ? ALPHA_FULL : _alphaType;
+
+			BlitRowProc blitRowProc;
+			switch (alphaType) {
+			case ALPHA_OPAQUE:
+				blitRowProc = getBlitRowProc<ALPHA_OPAQUE>(tinted, indexed);
+				break;
+			case ALPHA_BINARY:
+				blitRowProc = getBlitRowProc<ALPHA_BINARY>(tinted, indexed);
+				break;
+			default:
+				blitRowProc = getBlitRowProc<ALPHA_FULL>(tinted, indexed);
+				break;
+			}
 
-		if (flipping & Image::FLIP_H) {
-			inoStep = -inoStep;
-			yp = img->h - 1;
-		}
+			for (int i = 0; i < h; i++) {
+				int y = clipY + i;
+				if (flipping & Image::FLIP_H)
+					y = height - 1 - y;
+				if (vertUsage)
+					y = vertUsage[y];
 
-		byte *ino = (byte *)img->getBasePtr(xp, yp);
-		byte *outo = (byte *)_backSurface->getBasePtr(posX, posY);
-		byte *in, *out;
-
-		for (int i = 0; i < img->h; i++) {
-			out = outo;
-			in = ino;
-			for (int j = 0; j < img->w; j++) {
-				uint32 pix = *(uint32 *)in;
-				int b = (pix >> 0) & 0xff;
-				int g = (pix >> 8) & 0xff;
-				int r = (pix >> 16) & 0xff;
-				int a = (pix >> 24) & 0xff;
-				in += inStep;
-
-				if (ca != 255) {
-					a = a * ca >> 8;
-				}
+				const uint32 *in = (const uint32 *)(srcPixels + y * srcPitch);
+				if (!indexed)
+					in += clipX;
 
-				switch (a) {
-				case 0: // Full transparency
-					out += 4;
-					break;
-				case 255: // Full opacity
-#if defined(SCUMM_LITTLE_ENDIAN)
-					if (cb != 255)
-						*out++ = (b * cb) >> 8;
-					else
-						*out++ = b;
-
-					if (cg != 255)
-						*out++ = (g * cg) >> 8;
-					else
-						*out++ = g;
-
-					if (cr != 255)
-						*out++ = (r * cr) >> 8;
-					else
-						*out++ = r;
-
-					*out++ = a;
-#else
-					*out++ = a;
-
-					if (cr != 255)
-						*out++ = (r * cr) >> 8;
-					else
-						*out++ = r;
-
-					if (cg != 255)
-						*out++ = (g * cg) >> 8;
-					else
-						*out++ = g;
-
-					if (cb != 255)
-						*out++ = (b * cb) >> 8;
-					else
-						*out++ = b;
-#endif
-					break;
-
-				default: // alpha blending
-#if defined(SCUMM_LITTLE_ENDIAN)
-					if (cb == 0)
-						*out = 0;
-					else if (cb != 255)
-						*out += ((b - *out) * a * cb) >> 16;
-					else
-						*out += ((b - *out) * a) >> 8;
-					out++;
-					if (cg == 0)
-						*out = 0;
-					else if (cg != 255)
-						*out += ((g - *out) * a * cg) >> 16;
-					else
-						*out += ((g - *out) * a) >> 8;
-					out++;
-					if (cr == 0)
-						*out = 0;
-					else if (cr != 255)
-						*out += ((r - *out) * a * cr) >> 16;
-					else
-						*out += ((r - *out) * a) >> 8;
-					out++;
-					*out = 255;
-					out++;
-#else
-					*out = 255;
-					out++;
-					if (cr == 0)
-						*out = 0;
-					else if (cr != 255)
-						*out += ((r - *out) * a * cr) >> 16;
-					else
-						*out += ((r - *out) * a) >> 8;
-					out++;
-					if (cg == 0)
-						*out = 0;
-					else if (cg != 255)
-						*out += ((g - *out) * a * cg) >> 16;
-					else
-						*out += ((g - *out) * a) >> 8;
-					out++;
-					if (cb == 0)
-						*out = 0;
-					else if (cb != 255)
-						*out += ((b - *out) * a * cb) >> 16;
-					else
-						*out += ((b - *out) * a) >> 8;
-					out++;
-#endif
-				}
+				blitRowProc((uint32 *)outo, in, columns, w, ca, cr, cg, cb);
+				outo += _backSurface->pitch;
 			}
-			outo += _backSurface->pitch;
-			ino += inoStep;
 		}
 
-		g_system->copyRectToScreen(_backSurface->getBasePtr(posX, posY), _backSurface->pitch, posX, posY,
-			img->w, img->h);
+		delete[] columns;
 	}
 
-	if (imgScaled) {
-		imgScaled->pixels = savedPixels;
-		imgScaled->free();
-		delete imgScaled;
-	}
+	delete[] horizUsage;
+	delete[] vertUsage;
 
 	return true;
 }
 
 void RenderedImage::copyDirectly(int posX, int posY) {
+	if (_runs)
+		error("CopyDirectly() is not supported on compressed images.");
+
 	byte *data = _data;
 	int w = _width;
 	int h = _height;
@@ -467,38 +772,6 @@ void RenderedImage::copyDirectly(int posX, int posY) {
 	g_system->copyRectToScreen(data, _backSurface->pitch, posX, posY, w, h);
 }
 
-/**
- * Scales a passed surface, creating a new surface with the result
- * @param srcImage		Source image to scale
- * @param scaleFactor	Scale amount. Must be between 0 and 1.0 (but not zero)
- * @remarks Caller is responsible for freeing the returned surface
- */
-Graphics::Surface *RenderedImage::scale(const Graphics::Surface &srcImage, int xSize, int ySize) {
-	Graphics::Surface *s = new Graphics::Surface();
-	s->create(xSize, ySize, srcImage.format);
-
-	int *horizUsage = scaleLine(xSize, srcImage.w);
-	int *vertUsage = scaleLine(ySize, srcImage.h);
-
-	// Loop to create scaled version
-	for (int yp = 0; yp < ySize; ++yp) {
-		const byte *srcP = (const byte *)srcImage.getBasePtr(0, vertUsage[yp]);
-		byte *destP = (byte *)s->getBasePtr(0, yp);
-
-		for (int xp = 0; xp < xSize; ++xp) {
-			const byte *tempSrcP = srcP + (horizUsage[xp] * srcImage.format.bytesPerPixel);
-			for (int byteCtr = 0; byteCtr < srcImage.format.bytesPerPixel; ++byteCtr) {
-				*destP++ = *tempSrcP++;
-			}
-		}
-	}
-
-	// Delete arrays and return surface
-	delete[] horizUsage;
-	delete[] vertUsage;
-	return s;
-}
-
 /**
  * Returns an array indicating which pixels of a source image horizontally or vertically get
  * included in a scaled image
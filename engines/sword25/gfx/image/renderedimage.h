@@ -80,6 +80,7 @@ public:
 	virtual bool setContent(const byte *pixeldata, uint size, uint offset = 0, uint stride = 0);
 	void replaceContent(byte *pixeldata, int width, int height);
 	virtual uint getPixel(int x, int y);
+	virtual uint getMemoryUsage() const;
 
 	virtual bool isBlitSource() const {
 		return true;
@@ -103,13 +104,45 @@ public:
 		return true;
 	}
 
-	static Graphics::Surface *scale(const Graphics::Surface &srcImage, int xSize, int ySize);
+	/** Kinds of alpha values found in an image, used to pick the blit kernel */
+	enum ALPHA_TYPES {
+		ALPHA_UNKNOWN,
+		ALPHA_OPAQUE,	// all pixels are opaque
+		ALPHA_BINARY,	// all pixels are either opaque or fully transparent
+		ALPHA_FULL		// some pixels are translucent
+	};
+
+	/** Kinds of pixel runs in compressed images */
+	enum RUN_TYPES {
+		RUN_TRANSPARENT,	// no pixel data is stored
+		RUN_OPAQUE,
+		RUN_TRANSLUCENT		// stored with premultiplied alpha
+	};
+
+	/** Blits a row of pixels, see blitRow() */
+	typedef void (*BlitRowProc)(uint32 *out, const uint32 *in, const int *columns, int width, int ca, int cr, int cg, int cb);
 
 private:
 	byte *_data;
 	int  _width;
 	int  _height;
 	bool _doCleanup;
+	ALPHA_TYPES _alphaType;
+
+	void detectAlphaType();
+
+	// Loaded images are stored as runs of transparent, opaque and translucent
+	// pixels. Only the pixels of the latter two are stored, translucent ones
+	// with premultiplied alpha. _data is NULL for such images.
+	uint16 *_runs;
+	uint32 *_runPixels;
+	uint32 *_rowRunStart;
+	uint32 *_rowPixelStart;
+
+	void compress();
+	void expandRow(int y, uint32 *out) const;
+	void blitRuns(uint32 *out, int y, int x, int width, BlitRowProc blitRowProc,
+	              bool tinted, int ca, int cr, int cg, int cb) const;
 
 	Graphics::Surface *_backSurface;
 
@@ -62,6 +62,9 @@ public:
 	virtual bool fill(const Common::Rect *fillRectPtr, uint color);
 	virtual bool setContent(const byte *pixeldata, uint size, uint offset, uint stride);
 	virtual uint getPixel(int x, int y);
+	virtual uint getMemoryUsage() const {
+		return _width * _height * 4;
+	}
 
 	virtual bool isBlitSource() const               {
 		return false;
@@ -37,12 +37,17 @@
 #include "sword25/gfx/image/vectorimage.h"
 #include "sword25/gfx/image/renderedimage.h"
 
+#include "common/list.h"
+
 #include "graphics/colormasks.h"
 
 namespace Sword25 {
 
 #define BEZSMOOTHNESS 0.5
 
+// The number of bytes the cached rasterized vector images may occupy
+#define RASTER_CACHE_SIZE (8 * 1024 * 1024)
+
 // -----------------------------------------------------------------------------
 // SWF datatype
 // -----------------------------------------------------------------------------
@@ -210,11 +215,87 @@ Common::Rect CalculateBoundingBox(const VectorImageElement &vectorImageElement)
 }
 
 
+// -----------------------------------------------------------------------------
+// Raster cache
+// -----------------------------------------------------------------------------
+
+struct VectorImageRaster {
+	const VectorImage *image;
+	int width;
+	int height;
+	byte *pixelData;
+};
+
+typedef Common::List<VectorImageRaster> RasterList;
+
+// Most recently used rasters first. The list is created on demand and freed
+// together with the last raster.
+static RasterList *s_rasters = 0;
+static uint s_rasterCacheSize = 0;
+
+static byte *lookupRaster(const VectorImage *image, int width, int height) {
+	if (!s_rasters)
+		return 0;
+
+	for (RasterList::iterator it = s_rasters->begin(); it != s_rasters->end(); ++it) {
+		if (it->image == image && it->width == width && it->height == height) {
+			VectorImageRaster raster = *it;
+			s_rasters->erase(it);
+			s_rasters->push_front(raster);
+			return raster.pixelData;
+		}
+	}
+
+	return 0;
+}
+
+static void storeRaster(const VectorImage *image, int width, int height, byte *pixelData) {
+	if (!s_rasters)
+		s_rasters = new RasterList();
+
+	VectorImageRaster raster;
+	raster.image = image;
+	raster.width = width;
+	raster.height = height;
+	raster.pixelData = pixelData;
+	s_rasters->push_front(raster);
+	s_rasterCacheSize += width * height * 4;
+
+	// Release the least recently used rasters, but never the new one
+	while (s_rasterCacheSize > RASTER_CACHE_SIZE && s_rasters->size() > 1) {
+		VectorImageRaster &oldest = s_rasters->back();
+		s_rasterCacheSize -= oldest.width * oldest.height * 4;
+		free(oldest.pixelData);
+		s_rasters->pop_back();
+	}
+}
+
+static void removeRasters(const VectorImage *image) {
+	if (!s_rasters)
+		return;
+
+	RasterList::iterator it = s_rasters->begin();
+	while (it != s_rasters->end()) {
+		if (it->image == image) {
+			s_rasterCacheSize -= it->width * it->height * 4;
+			free(it->pixelData);
+			it = s_rasters->erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (s_rasters->empty()) {
+		delete s_rasters;
+		s_rasters = 0;
+	}
+}
+
 // -----------------------------------------------------------------------------
 // Construction
 // -----------------------------------------------------------------------------
 
-VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _pixelData(0), _fname(fname) {
+VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _fname(fname) {
 	success = false;
 
 	// Create bitstream object
@@ -299,8 +380,7 @@ VectorImage::~VectorImage() {
 			if (_elements[j].getPathInfo(i).getVec())
 				free(_elements[j].getPathInfo(i).getVec());
 
-	if (_pixelData)
-		free(_pixelData);
+	removeRasters(this);
 }
 
 
@@ -593,6 +673,26 @@ uint VectorImage::getPixel(int x, int y) {
 
 // -----------------------------------------------------------------------------
 
+uint VectorImage::getMemoryUsage() const {
+	// Only the vector data is counted, the rasters are limited by their own
+	// cache
+	uint size = sizeof(VectorImage);
+
+	for (uint j = 0; j < _elements.size(); j++) {
+		const VectorImageElement &element = _elements[j];
+
+		size += sizeof(VectorImageElement);
+		size += element._lineStyles.size() * sizeof(VectorImageElement::LineStyleType);
+		size += element._fillStyles.size() * sizeof(uint32);
+		for (uint i = 0; i < element._pathInfos.size(); i++)
+			size += sizeof(VectorPathInfo) + (element._pathInfos[i].getVecLen() + 1) * sizeof(ArtBpath);
+	}
+
+	return size;
+}
+
+// -----------------------------------------------------------------------------
+
 bool VectorImage::setContent(const byte *pixeldata, uint size, uint offset, uint stride) {
 	error("SetContent() is not supported.");
 	return 0;
@@ -603,26 +703,21 @@ bool VectorImage::blit(int posX, int posY,
                        Common::Rect *pPartRect,
                        uint color,
                        int width, int height) {
-	static VectorImage *oldThis = 0;
-	static int              oldWidth = -2;
-	static int              oldHeight = -2;
-
 	// If width or height to 0, nothing needs to be shown.
 	if (width == 0 || height == 0)
 		return true;
 
-	// Determine if the old image in the cache can not be reused and must be recalculated
-	if (!(oldThis == this && oldWidth == width && oldHeight == height)) {
-		render(width, height);
-
-		oldThis = this;
-		oldHeight = height;
-		oldWidth = width;
+	// Only rasterize the image if it has not been drawn at this size recently.
+	// The color modulation is applied when blitting, so it does not matter.
+	byte *pixelData = lookupRaster(this, width, height);
+	if (!pixelData) {
+		pixelData = render(width, height);
+		storeRaster(this, width, height, pixelData);
 	}
 
 	RenderedImage *rend = new RenderedImage();
 
-	rend->replaceContent(_pixelData, width, height);
+	rend->replaceContent(pixelData, width, height);
 	rend->blit(posX, posY, flipping, pPartRect, color, width, height);
 
 	delete rend;
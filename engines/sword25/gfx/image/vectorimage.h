@@ -183,9 +183,14 @@ public:
 	}
 	virtual bool fill(const Common::Rect *pFillRect = 0, uint color = BS_RGB(0, 0, 0));
 
-	void render(int width, int height);
+	/**
+	    @brief Rasterizes the image at the given size.
+	    @return Returns the 32 bit pixel data, which the caller has to free().
+	*/
+	byte *render(int width, int height);
 
 	virtual uint getPixel(int x, int y);
+	virtual uint getMemoryUsage() const;
 	virtual bool isBlitSource() const {
 		return true;
 	}
@@ -224,8 +229,6 @@ private:
 	Common::Array<VectorImageElement>    _elements;
 	Common::Rect                         _boundingBox;
 
-	byte *_pixelData;
-
 	Common::String _fname;
 };
 
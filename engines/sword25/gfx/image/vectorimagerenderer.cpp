@@ -59,30 +59,34 @@ void art_rgb_fill_run1(byte *buf, byte r, byte g, byte b, int n) {
 	}
 }
 
+static inline uint32 art_rgb_blend_pixel1(uint32 v, byte r, byte g, byte b, int alpha) {
+	int va = (v >> 24) & 0xff;
+	int vr = (v >> 16) & 0xff;
+	int vg = (v >> 8) & 0xff;
+	int vb = v & 0xff;
+
+	va = MIN(va + alpha, 0xff);
+	vr = (vr + (((r - vr) * alpha + 0x80) >> 8)) & 0xff;
+	vg = (vg + (((g - vg) * alpha + 0x80) >> 8)) & 0xff;
+	vb = (vb + (((b - vb) * alpha + 0x80) >> 8)) & 0xff;
+
+	return (va << 24) | (vr << 16) | (vg << 8) | vb;
+}
+
 void art_rgb_run_alpha1(byte *buf, byte r, byte g, byte b, int alpha, int n) {
-	int i;
-	int v;
-
-	for (i = 0; i < n; i++) {
-#if defined(SCUMM_LITTLE_ENDIAN)
-		v = *buf;
-		*buf++ = v + (((b - v) * alpha + 0x80) >> 8);
-		v = *buf;
-		*buf++ = v + (((g - v) * alpha + 0x80) >> 8);
-		v = *buf;
-		*buf++ = v + (((r - v) * alpha + 0x80) >> 8);
-		v = *buf;
-		*buf++ = MIN(v + alpha, 0xff);
-#else
-		v = *buf;
-		*buf++ = MIN(v + alpha, 0xff);
-		v = *buf;
-		*buf++ = v + (((r - v) * alpha + 0x80) >> 8);
-		v = *buf;
-		*buf++ = v + (((g - v) * alpha + 0x80) >> 8);
-		v = *buf;
-		*buf++ = v + (((b - v) * alpha + 0x80) >> 8);
-#endif
+	// The pixels are stored as ARGB in native byte order. Runs mostly cover
+	// areas of a single color, so the result is only computed when the
+	// pixel differs from the previous one.
+	uint32 *pix = (uint32 *)buf;
+	uint32 last = 0;
+	uint32 blended = art_rgb_blend_pixel1(last, r, g, b, alpha);
+
+	for (int i = 0; i < n; i++) {
+		if (pix[i] != last) {
+			last = pix[i];
+			blended = art_rgb_blend_pixel1(last, r, g, b, alpha);
+		}
+		pix[i] = blended;
 	}
 }
 
@@ -401,17 +405,14 @@ void drawBez(ArtBpath *bez1, ArtBpath *bez2, byte *buffer, int width, int height
 	free(vec);
 }
 
-void VectorImage::render(int width, int height) {
+byte *VectorImage::render(int width, int height) {
 	double scaleX = (width == - 1) ? 1 : static_cast<double>(width) / static_cast<double>(getWidth());
 	double scaleY = (height == - 1) ? 1 : static_cast<double>(height) / static_cast<double>(getHeight());
 
 	debug(3, "VectorImage::render(%d, %d) %s", width, height, _fname.c_str());
 
-	if (_pixelData)
-		free(_pixelData);
-
-	_pixelData = (byte *)malloc(width * height * 4);
-	memset(_pixelData, 0, width * height * 4);
+	byte *pixelData = (byte *)malloc(width * height * 4);
+	memset(pixelData, 0, width * height * 4);
 
 	for (uint e = 0; e < _elements.size(); e++) {
 
@@ -452,7 +453,7 @@ void VectorImage::render(int width, int height) {
 			(*fill0pos).code = ART_END;
 			(*fill1pos).code = ART_END;
 
-			drawBez(fill1, fill0, _pixelData, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, -1, _elements[e].getFillStyleColor(s));
+			drawBez(fill1, fill0, pixelData, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, -1, _elements[e].getFillStyleColor(s));
 
 			free(fill0);
 			free(fill1);
@@ -465,11 +466,13 @@ void VectorImage::render(int width, int height) {
 
 			for (uint p = 0; p < _elements[e].getPathCount(); p++) {
 				if (_elements[e].getPathInfo(p).getLineStyle() == s + 1) {
-					drawBez(_elements[e].getPathInfo(p).getVec(), 0, _pixelData, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, penWidth, _elements[e].getLineStyleColor(s));
+					drawBez(_elements[e].getPathInfo(p).getVec(), 0, pixelData, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, penWidth, _elements[e].getLineStyleColor(s));
 				}
 			}
 		}
 	}
+
+	return pixelData;
 }
 
 
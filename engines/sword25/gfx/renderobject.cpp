@@ -96,6 +96,10 @@ RenderObject::RenderObject(RenderObjectPtr<RenderObject> parentPtr, TYPES type,
 }
 
 RenderObject::~RenderObject() {
+	// The area the object was drawn to has to be redrawn without it
+	if (_managerPtr && _oldVisible)
+		_managerPtr->addUpdateRect(_dirtyRect);
+
 	// Objekt aus dem Elternobjekt entfernen.
 	if (_parentPtr.isValid())
 		_parentPtr->detatchChildren(this->getHandle());
@@ -106,7 +110,7 @@ RenderObject::~RenderObject() {
 	RenderObjectRegistry::instance().deregisterObject(this);
 }
 
-bool RenderObject::render() {
+bool RenderObject::render(const Common::Array<Common::Rect> &updateRects) {
 	// Objektnderungen validieren
 	validateObject();
 
@@ -120,13 +124,20 @@ bool RenderObject::render() {
 		_childChanged = false;
 	}
 
-	// Objekt zeichnen.
-	doRender();
+	// Draw the object clipped to each of the update rectangles it overlaps.
+	// Objects outside of all of them are skipped.
+	GraphicEngine *gfxPtr = Kernel::getInstance()->getGfx();
+	for (uint i = 0; i < updateRects.size(); ++i) {
+		if (_dirtyRect.intersects(updateRects[i])) {
+			gfxPtr->setClipRect(updateRects[i]);
+			doRender();
+		}
+	}
 
 	// Dann mssen die Kinder gezeichnet werden
 	RENDEROBJECT_ITER it = _children.begin();
 	for (; it != _children.end(); ++it)
-		if (!(*it)->render())
+		if (!(*it)->render(updateRects))
 			return false;
 
 	return true;
@@ -146,6 +157,7 @@ bool RenderObject::updateObjectState() {
 	// Falls sich das Objekt verndert hat, muss der interne Zustand neu berechnet werden und evtl. Update-Regions fr den nchsten Frame
 	// registriert werden.
 	if ((calcBoundingBox() != _oldBbox) ||
+	        (calcDirtyRect() != _dirtyRect) ||
 	        (_visible != _oldVisible) ||
 	        (_x != _oldX) ||
 	        (_y != _oldY) ||
@@ -156,7 +168,15 @@ bool RenderObject::updateObjectState() {
 			_parentPtr->signalChildChange();
 
 		// Die Bounding-Box neu berechnen und Update-Regions registrieren.
+		if (_managerPtr && _oldVisible)
+			_managerPtr->addUpdateRect(_dirtyRect);
 		updateBoxes();
+		if (_managerPtr && _visible)
+			_managerPtr->addUpdateRect(_dirtyRect);
+
+		// Showing or hiding the object shows or hides its children as well
+		if (_managerPtr && _visible != _oldVisible)
+			addChildUpdateRects();
 
 		// nderungen Validieren
 		validateObject();
@@ -174,6 +194,29 @@ bool RenderObject::updateObjectState() {
 void RenderObject::updateBoxes() {
 	// Bounding-Box aktualisieren
 	_bbox = calcBoundingBox();
+	_dirtyRect = calcDirtyRect();
+}
+
+Common::Rect RenderObject::calcDirtyRect() const {
+	// Objects are drawn at their full size, even where they exceed their
+	// parent, so the rectangle is only clipped to the screen.
+	Common::Rect dirtyRect(0, 0, _width, _height);
+	dirtyRect.translate(_absoluteX, _absoluteY);
+
+	if (_managerPtr)
+		dirtyRect.clip(_managerPtr->getScreenRect());
+
+	return dirtyRect;
+}
+
+void RenderObject::addChildUpdateRects() {
+	RENDEROBJECT_ITER it = _children.begin();
+	for (; it != _children.end(); ++it) {
+		if ((*it)->_visible) {
+			_managerPtr->addUpdateRect((*it)->_dirtyRect);
+			(*it)->addChildUpdateRects();
+		}
+	}
 }
 
 Common::Rect RenderObject::calcBoundingBox() const {
@@ -218,7 +218,7 @@ public:
 	            Dieses kann entweder direkt geschehen oder durch den Aufruf von UpdateObjectState() an einem Vorfahren-Objekt.<br>
 	            Diese Methode darf nur von BS_RenderObjectManager aufgerufen werden.
 	*/
-	bool render();
+	bool render(const Common::Array<Common::Rect> &updateRects);
 	/**
 	    @brief Bereitet das Objekt und alle seine Unterobjekte auf einen Rendervorgang vor.
 	           Hierbei werden alle Dirty-Rectangles berechnet und die Renderreihenfolge aktualisiert.
@@ -383,6 +383,7 @@ protected:
 
 	// Kopien der Variablen, die fr die Errechnung des Dirty-Rects und zur Bestimmung der Objektvernderung notwendig sind
 	Common::Rect     _oldBbox;
+	Common::Rect     _dirtyRect;   ///< The area of the screen drawn by doRender(), which isn't clipped to the parent
 	int         _oldX;
 	int         _oldY;
 	int         _oldZ;
@@ -469,6 +470,10 @@ private:
 	    @return Gibt das Dirty-Rectangle des Objektes in Bildschirmkoordinaten zurck.
 	*/
 	Common::Rect calcDirtyRect() const;
+	/**
+	    @brief Registers the dirty rectangles of all visible descendants of the object at the manager.
+	*/
+	void addChildUpdateRects();
 	/**
 	    @brief Berechnet die absolute Position des Objektes.
 	*/
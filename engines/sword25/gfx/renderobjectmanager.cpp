@@ -41,10 +41,17 @@
 #include "sword25/gfx/timedrenderobject.h"
 #include "sword25/gfx/rootrenderobject.h"
 
+#include "common/system.h"
+
 namespace Sword25 {
 
+// Above this number of update rectangles, they are merged into one
+#define MAX_UPDATE_RECTS 16
+
 RenderObjectManager::RenderObjectManager(int width, int height, int framebufferCount) :
-	_frameStarted(false) {
+	_frameStarted(false),
+	_screenRect(0, 0, width, height),
+	_fullRedraw(true) {
 	// Wurzel des BS_RenderObject-Baumes erzeugen.
 	_rootPtr = (new RootRenderObject(this, width, height))->getHandle();
 }
@@ -75,8 +82,66 @@ bool RenderObjectManager::render() {
 
 	_frameStarted = false;
 
+	if (_fullRedraw) {
+		_updateRects.clear();
+		_updateRects.push_back(_screenRect);
+		_fullRedraw = false;
+	}
+
+	if (_updateRects.empty())
+		return true;
+
 	// Die Render-Methode der Wurzel aufrufen. Dadurch wird das rekursive Rendern der Baumelemente angestoen.
-	return _rootPtr->render();
+	GraphicEngine *gfxPtr = Kernel::getInstance()->getGfx();
+	bool result = _rootPtr->render(_updateRects);
+	gfxPtr->setClipRect(_screenRect);
+
+	// Only the redrawn parts of the back surface have to be copied to the screen
+	Graphics::Surface *backSurface = gfxPtr->getSurface();
+	int area = 0;
+	for (uint i = 0; i < _updateRects.size(); ++i) {
+		const Common::Rect &rect = _updateRects[i];
+		g_system->copyRectToScreen(backSurface->getBasePtr(rect.left, rect.top), backSurface->pitch,
+		                           rect.left, rect.top, rect.width(), rect.height());
+		area += rect.width() * rect.height();
+	}
+
+	debug(5, "Rendered %d update rects covering %d%% of the screen", _updateRects.size(),
+	      area * 100 / MAX(1, _screenRect.width() * _screenRect.height()));
+
+	_updateRects.clear();
+
+	return result;
+}
+
+void RenderObjectManager::addUpdateRect(const Common::Rect &rect) {
+	if (_fullRedraw || rect.isEmpty())
+		return;
+
+	Common::Rect updateRect = rect;
+	updateRect.clip(_screenRect);
+	if (updateRect.isEmpty())
+		return;
+
+	// Merge the rectangle with those it overlaps. The merged rectangle may
+	// overlap others, so start over after every merge.
+	uint i = 0;
+	while (i < _updateRects.size()) {
+		if (_updateRects[i].intersects(updateRect)) {
+			updateRect.extend(_updateRects[i]);
+			_updateRects.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+	_updateRects.push_back(updateRect);
+
+	if (_updateRects.size() > MAX_UPDATE_RECTS) {
+		for (i = 1; i < _updateRects.size(); ++i)
+			_updateRects[0].extend(_updateRects[i]);
+		_updateRects.resize(1);
+	}
 }
 
 void RenderObjectManager::attatchTimedRenderObject(RenderObjectPtr<TimedRenderObject> renderObjectPtr) {
@@ -140,6 +205,8 @@ bool RenderObjectManager::unpersist(InputPersistenceBlock &reader) {
 	// Alle BS_AnimationTemplates wieder herstellen.
 	result &= AnimationTemplateRegistry::instance().unpersist(reader);
 
+	invalidateScreen();
+
 	return result;
 }
 
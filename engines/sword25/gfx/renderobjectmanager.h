@@ -42,6 +42,7 @@
 #ifndef SWORD25_RENDEROBJECTMANAGER_H
 #define SWORD25_RENDEROBJECTMANAGER_H
 
+#include "common/array.h"
 #include "common/rect.h"
 #include "sword25/kernel/common.h"
 #include "sword25/gfx/renderobjectptr.h"
@@ -106,11 +107,31 @@ public:
 	*/
 	void detatchTimedRenderObject(RenderObjectPtr<TimedRenderObject> pRenderObject);
 
+	/**
+	 * Adds an area of the screen which has to be redrawn in the next frame.
+	 * Overlapping areas are merged.
+	 */
+	void addUpdateRect(const Common::Rect &rect);
+	/**
+	 * Makes the next frame redraw the whole screen.
+	 */
+	void invalidateScreen() {
+		_fullRedraw = true;
+	}
+	const Common::Rect &getScreenRect() const {
+		return _screenRect;
+	}
+
 	virtual bool persist(OutputPersistenceBlock &writer);
 	virtual bool unpersist(InputPersistenceBlock &reader);
 
 private:
 	bool _frameStarted;
+
+	// Only the update rectangles are redrawn and copied to the screen
+	Common::Rect _screenRect;
+	Common::Array<Common::Rect> _updateRects;
+	bool _fullRedraw;
 	typedef Common::Array<RenderObjectPtr<TimedRenderObject> > RenderObjectList;
 	RenderObjectList _timedRenderObjects;
 
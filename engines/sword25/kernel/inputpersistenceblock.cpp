@@ -29,21 +29,23 @@
  *
  */
 
+#include "common/stream.h"
 #include "common/textconsole.h"
 
 #include "sword25/kernel/inputpersistenceblock.h"
 
 namespace Sword25 {
 
-InputPersistenceBlock::InputPersistenceBlock(const void *data, uint dataLength, int version) :
-	_data(static_cast<const byte *>(data), dataLength),
+InputPersistenceBlock::InputPersistenceBlock(Common::SeekableReadStream *stream, int version) :
+	_stream(stream),
 	_errorState(NONE),
+	_streamDataLeft(0),
+	_streamEnded(true),
 	_version(version) {
-	_iter = _data.begin();
 }
 
 InputPersistenceBlock::~InputPersistenceBlock() {
-	if (_iter != _data.end())
+	if (_stream->pos() < _stream->size())
 		warning("Persistence block was not read to the end.");
 }
 
@@ -54,38 +56,34 @@ void InputPersistenceBlock::read(int16 &value) {
 }
 
 void InputPersistenceBlock::read(signed int &value) {
-	if (checkMarker(SINT_MARKER)) {
-		value = (int32)READ_LE_UINT32(_iter);
-		_iter += 4;
+	if (checkMarker(SINT_MARKER) && checkBlockSize(4)) {
+		value = (int32)_stream->readUint32LE();
 	} else {
 		value = 0;
 	}
 }
 
 void InputPersistenceBlock::read(uint &value) {
-	if (checkMarker(UINT_MARKER)) {
-		value = READ_LE_UINT32(_iter);
-		_iter += 4;
+	if (checkMarker(UINT_MARKER) && checkBlockSize(4)) {
+		value = _stream->readUint32LE();
 	} else {
 		value = 0;
 	}
 }
 
 void InputPersistenceBlock::read(float &value) {
-	if (checkMarker(FLOAT_MARKER)) {
+	if (checkMarker(FLOAT_MARKER) && checkBlockSize(4)) {
 		uint32 tmp[1];
-		tmp[0] = READ_LE_UINT32(_iter);
+		tmp[0] = _stream->readUint32LE();
 		value = ((float *)tmp)[0];
-		_iter += 4;
 	} else {
 		value = 0.0f;
 	}
 }
 
 void InputPersistenceBlock::read(bool &value) {
-	if (checkMarker(BOOL_MARKER)) {
-		uint uintBool = READ_LE_UINT32(_iter);
-		_iter += 4;
+	if (checkMarker(BOOL_MARKER) && checkBlockSize(4)) {
+		uint uintBool = _stream->readUint32LE();
 		value = uintBool != 0;
 	} else {
 		value = false;
@@ -100,8 +98,10 @@ void InputPersistenceBlock::readString(Common::String &value) {
 		read(size);
 
 		if (checkBlockSize(size)) {
-			value = Common::String(reinterpret_cast<const char *>(&*_iter), size);
-			_iter += size;
+			char *buffer = new char[size];
+			_stream->read(buffer, size);
+			value = Common::String(buffer, size);
+			delete[] buffer;
 		}
 	}
 }
@@ -112,14 +112,49 @@ void InputPersistenceBlock::readByteArray(Common::Array<byte> &value) {
 		read(size);
 
 		if (checkBlockSize(size)) {
-			value = Common::Array<byte>(_iter, size);
-			_iter += size;
+			value.resize(size);
+			if (size > 0)
+				_stream->read(&value[0], size);
 		}
 	}
 }
 
+bool InputPersistenceBlock::beginStream() {
+	_streamDataLeft = 0;
+	_streamEnded = !checkMarker(STREAM_MARKER);
+	return !_streamEnded;
+}
+
+uint InputPersistenceBlock::readStreamData(void *buffer, uint size) {
+	if (_streamDataLeft == 0 && !_streamEnded) {
+		// Every piece is preceded by its size, a size of 0 marks the end of the stream
+		read(_streamDataLeft);
+		if (_streamDataLeft == 0 || !checkBlockSize(_streamDataLeft)) {
+			_streamDataLeft = 0;
+			_streamEnded = true;
+		}
+	}
+
+	if (_streamEnded)
+		return 0;
+
+	size = MIN(size, _streamDataLeft);
+	_stream->read(buffer, size);
+	_streamDataLeft -= size;
+
+	return size;
+}
+
+void InputPersistenceBlock::endStream() {
+	while (!_streamEnded) {
+		_stream->skip(_streamDataLeft);
+		read(_streamDataLeft);
+		_streamEnded = (_streamDataLeft == 0);
+	}
+}
+
 bool InputPersistenceBlock::checkBlockSize(int size) {
-	if (_data.end() - _iter >= size) {
+	if (_stream->size() - _stream->pos() >= size) {
 		return true;
 	} else {
 		_errorState = END_OF_DATA;
@@ -132,7 +167,7 @@ bool InputPersistenceBlock::checkMarker(byte marker) {
 	if (!isGood() || !checkBlockSize(1))
 		return false;
 
-	if (*_iter++ == marker) {
+	if (_stream->readByte() == marker) {
 		return true;
 	} else {
 		_errorState = OUT_OF_SYNC;
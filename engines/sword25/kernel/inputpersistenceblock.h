@@ -36,6 +36,10 @@
 #include "sword25/kernel/common.h"
 #include "sword25/kernel/persistenceblock.h"
 
+namespace Common {
+class SeekableReadStream;
+}
+
 namespace Sword25 {
 
 class InputPersistenceBlock : public PersistenceBlock {
@@ -46,7 +50,11 @@ public:
 		OUT_OF_SYNC
 	};
 
-	InputPersistenceBlock(const void *data, uint dataLength, int version);
+	/**
+	 * Creates a persistence block that reads directly from the given stream,
+	 * up to its end. The stream is not deleted by the block.
+	 */
+	InputPersistenceBlock(Common::SeekableReadStream *stream, int version);
 	virtual ~InputPersistenceBlock();
 
 	void read(int16 &value);
@@ -57,6 +65,16 @@ public:
 	void readString(Common::String &value);
 	void readByteArray(Common::Array<byte> &value);
 
+	/**
+	 * Reads data written with OutputPersistenceBlock::beginStream() and
+	 * friends. readStreamData() returns the number of bytes read, which is
+	 * 0 once all data of the stream has been read. endStream() skips the
+	 * data that has not been read.
+	 */
+	bool beginStream();
+	uint readStreamData(void *buffer, uint size);
+	void endStream();
+
 	bool isGood() const {
 		return _errorState == NONE;
 	}
@@ -70,10 +88,12 @@ private:
 	bool checkMarker(byte marker);
 	bool checkBlockSize(int size);
 
-	Common::Array<byte> _data;
-	Common::Array<byte>::const_iterator _iter;
+	Common::SeekableReadStream *_stream;
 	ErrorState _errorState;
 
+	uint _streamDataLeft;
+	bool _streamEnded;
+
 	int _version;
 };
 
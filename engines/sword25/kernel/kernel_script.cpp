@@ -312,7 +312,7 @@ static int precacheResource(lua_State *L) {
 #ifdef PRECACHE_RESOURCES
 	lua_pushbooleancpp(L, pResource->precacheResource(luaL_checkstring(L, 1)));
 #else
-	lua_pushbooleancpp(L, true);
+	lua_pushbooleancpp(L, pResource->queuePrecacheResource(luaL_checkstring(L, 1)));
 #endif
 
 	return 1;
@@ -327,7 +327,8 @@ static int forcePrecacheResource(lua_State *L) {
 #ifdef PRECACHE_RESOURCES
 	lua_pushbooleancpp(L, pResource->precacheResource(luaL_checkstring(L, 1), true));
 #else
-	lua_pushbooleancpp(L, true);
+	// Resources are never changed while the game runs, so there is nothing to reload
+	lua_pushbooleancpp(L, pResource->queuePrecacheResource(luaL_checkstring(L, 1)));
 #endif
 
 	return 1;
@@ -339,9 +340,7 @@ static int getMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This is used for debugging, so it doesn't really matter.
-	// The default value set by the scripts is 256000000 bytes
-	lua_pushnumber(L, 256000000);
+	lua_pushnumber(L, pResource->getMaxMemoryUsage());
 
 	return 1;
 }
@@ -352,8 +351,7 @@ static int setMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This call is ignored, we set a limit on the number of
-	// simultaneous resources loaded instead.
+	pResource->setMaxMemoryUsage(static_cast<uint>(luaL_checknumber(L, 1)));
 
 	return 0;
 }
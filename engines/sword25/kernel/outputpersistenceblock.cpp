@@ -29,16 +29,15 @@
  *
  */
 
-#include "sword25/kernel/outputpersistenceblock.h"
+#include "common/stream.h"
 
-namespace {
-const uint INITIAL_BUFFER_SIZE = 1024 * 64;
-}
+#include "sword25/kernel/outputpersistenceblock.h"
 
 namespace Sword25 {
 
-OutputPersistenceBlock::OutputPersistenceBlock() {
-	_data.reserve(INITIAL_BUFFER_SIZE);
+OutputPersistenceBlock::OutputPersistenceBlock(Common::WriteStream *stream) :
+	_stream(stream),
+	_dataSize(0) {
 }
 
 void OutputPersistenceBlock::write(signed int value) {
@@ -85,15 +84,31 @@ void OutputPersistenceBlock::writeByteArray(Common::Array<byte> &value) {
 	rawWrite(&value[0], value.size());
 }
 
+void OutputPersistenceBlock::beginStream() {
+	writeMarker(STREAM_MARKER);
+}
+
+void OutputPersistenceBlock::writeStreamData(const void *data, uint size) {
+	// Every piece is preceded by its size, a size of 0 marks the end of the stream
+	if (size > 0) {
+		write(size);
+		rawWrite(data, size);
+	}
+}
+
+void OutputPersistenceBlock::endStream() {
+	write((uint)0);
+}
+
 void OutputPersistenceBlock::writeMarker(byte marker) {
-	_data.push_back(marker);
+	_stream->writeByte(marker);
+	_dataSize++;
 }
 
 void OutputPersistenceBlock::rawWrite(const void *dataPtr, size_t size) {
 	if (size > 0) {
-		uint oldSize = _data.size();
-		_data.resize(oldSize + size);
-		memcpy(&_data[oldSize], dataPtr, size);
+		_stream->write(dataPtr, size);
+		_dataSize += size;
 	}
 }
 
@@ -35,11 +35,19 @@
 #include "sword25/kernel/common.h"
 #include "sword25/kernel/persistenceblock.h"
 
+namespace Common {
+class WriteStream;
+}
+
 namespace Sword25 {
 
 class OutputPersistenceBlock : public PersistenceBlock {
 public:
-	OutputPersistenceBlock();
+	/**
+	 * Creates a persistence block that writes directly to the given stream.
+	 * The stream is not deleted by the block.
+	 */
+	OutputPersistenceBlock(Common::WriteStream *stream);
 
 	void write(signed int value);
 	void write(uint value);
@@ -48,18 +56,24 @@ public:
 	void writeString(const Common::String &string);
 	void writeByteArray(Common::Array<byte> &value);
 
-	const void *getData() const {
-		return &_data[0];
-	}
+	/**
+	 * Writes data of unknown total size. The data is handed over in pieces with
+	 * writeStreamData(), between calls to beginStream() and endStream().
+	 */
+	void beginStream();
+	void writeStreamData(const void *data, uint size);
+	void endStream();
+
 	uint getDataSize() const {
-		return _data.size();
+		return _dataSize;
 	}
 
 private:
 	void writeMarker(byte marker);
 	void rawWrite(const void *dataPtr, size_t size);
 
-	Common::Array<byte> _data;
+	Common::WriteStream *_stream;
+	uint _dataSize;
 };
 
 } // End of namespace Sword25
@@ -61,7 +61,8 @@ protected:
 		FLOAT_MARKER,
 		STRING_MARKER,
 		BOOL_MARKER,
-		BLOCK_MARKER
+		BLOCK_MARKER,
+		STREAM_MARKER
 	};
 
 };
@@ -30,6 +30,7 @@
  */
 
 #include "common/fs.h"
+#include "common/memstream.h"
 #include "common/savefile.h"
 #include "common/zlib.h"
 #include "sword25/kernel/kernel.h"
@@ -52,7 +53,7 @@ static const uint  SLOT_COUNT = 18;
 static const uint  FILE_COPY_BUFFER_SIZE = 1024 * 10;
 static const char *VERSIONIDOLD = "SCUMMVM1";
 static const char *VERSIONID = "SCUMMVM2";
-static const int   VERSIONNUM = 2;
+static const int   VERSIONNUM = 3;
 
 #define MAX_SAVEGAME_SIZE 100
 
@@ -105,6 +106,7 @@ struct SavegameInformation {
 	uint gamedataLength;
 	uint gamedataOffset;
 	uint gamedataUncompressedLength;
+	uint thumbnailLength;
 
 	SavegameInformation() {
 		clear();
@@ -117,6 +119,7 @@ struct SavegameInformation {
 		gamedataLength = 0;
 		gamedataOffset = 0;
 		gamedataUncompressedLength = 0;
+		thumbnailLength = 0;
 	}
 };
 
@@ -157,10 +160,16 @@ struct PersistenceService::Impl {
 				curSavegameInfo.version = atoi(versionNum.c_str());
 			}
 			Common::String gameDescription = loadString(file);
-			Common::String gamedataLength = loadString(file);
-			curSavegameInfo.gamedataLength = atoi(gamedataLength.c_str());
-			Common::String gamedataUncompressedLength = loadString(file);
-			curSavegameInfo.gamedataUncompressedLength = atoi(gamedataUncompressedLength.c_str());
+			if (curSavegameInfo.version >= 3) {
+				// The thumbnail is followed by the game data, which extends to the end of the file
+				Common::String thumbnailLength = loadString(file);
+				curSavegameInfo.thumbnailLength = atoi(thumbnailLength.c_str());
+			} else {
+				Common::String gamedataLength = loadString(file);
+				curSavegameInfo.gamedataLength = atoi(gamedataLength.c_str());
+				Common::String gamedataUncompressedLength = loadString(file);
+				curSavegameInfo.gamedataUncompressedLength = atoi(gamedataUncompressedLength.c_str());
+			}
 
 			// If the header can be read in and is detected to be valid, we will have a valid file
 			if (storedMarker == FILE_MARKER) {
@@ -173,7 +182,7 @@ struct PersistenceService::Impl {
 				// The offset to the stored save game data within the file.
 				// This reflects the current position, as the header information
 				// is still followed by a space as separator.
-				curSavegameInfo.gamedataOffset = static_cast<uint>(file->pos());
+				curSavegameInfo.gamedataOffset = static_cast<uint>(file->pos()) + curSavegameInfo.thumbnailLength;
 			}
 
 			delete file;
@@ -267,6 +276,8 @@ bool PersistenceService::saveGame(uint slotID, const Common::String &screenshotF
 		return false;
 	}
 
+	uint32 startTime = g_system->getMillis();
+
 	// Dateinamen erzeugen.
 	Common::String filename = generateSavegameFilename(slotID);
 
@@ -289,37 +300,15 @@ bool PersistenceService::saveGame(uint slotID, const Common::String &screenshotF
 	file->writeString(formatTimestamp(dt));
 	file->writeByte(0);
 
-	if (file->err()) {
-		error("Unable to write header data to savegame file \"%s\".", filename.c_str());
-	}
-
-	// Alle notwendigen Module persistieren.
-	OutputPersistenceBlock writer;
-	bool success = true;
-	success &= Kernel::getInstance()->getScript()->persist(writer);
-	success &= RegionRegistry::instance().persist(writer);
-	success &= Kernel::getInstance()->getGfx()->persist(writer);
-	success &= Kernel::getInstance()->getSfx()->persist(writer);
-	success &= Kernel::getInstance()->getInput()->persist(writer);
-	if (!success) {
-		error("Unable to persist modules for savegame file \"%s\".", filename.c_str());
-	}
-
-	// Write the save game data uncompressed, since the final saved game will be
-	// compressed anyway.
-	char sBuffer[10];
-	snprintf(sBuffer, 10, "%u", writer.getDataSize());
-	file->writeString(sBuffer);
-	file->writeByte(0);
-	snprintf(sBuffer, 10, "%u", writer.getDataSize());
-	file->writeString(sBuffer);
-	file->writeByte(0);
-	file->write(writer.getData(), writer.getDataSize());
-
-	// Get the screenshot
+	// Write the screenshot. It is stored in front of the game data, so that
+	// the game data can be written without knowing its size beforehand.
 	Common::SeekableReadStream *thumbnail = Kernel::getInstance()->getGfx()->getThumbnail();
 
 	if (thumbnail) {
+		snprintf(buf, 20, "%d", thumbnail->size());
+		file->writeString(buf);
+		file->writeByte(0);
+
 		byte *buffer = new byte[FILE_COPY_BUFFER_SIZE];
 		thumbnail->seek(0, SEEK_SET);
 		while (!thumbnail->eos()) {
@@ -330,11 +319,35 @@ bool PersistenceService::saveGame(uint slotID, const Common::String &screenshotF
 		delete[] buffer;
 	} else {
 		warning("The screenshot file \"%s\" does not exist. Savegame is written without a screenshot.", filename.c_str());
+		file->writeString("0");
+		file->writeByte(0);
+	}
+
+	if (file->err()) {
+		error("Unable to write header data to savegame file \"%s\".", filename.c_str());
+	}
+
+	// Alle notwendigen Module persistieren. The data is written directly to
+	// the savegame file, which is compressed by the savefile manager.
+	OutputPersistenceBlock writer(file);
+	bool success = true;
+	success &= Kernel::getInstance()->getScript()->persist(writer);
+	success &= RegionRegistry::instance().persist(writer);
+	success &= Kernel::getInstance()->getGfx()->persist(writer);
+	success &= Kernel::getInstance()->getSfx()->persist(writer);
+	success &= Kernel::getInstance()->getInput()->persist(writer);
+	if (!success) {
+		error("Unable to persist modules for savegame file \"%s\".", filename.c_str());
 	}
 
 	file->finalize();
+	if (file->err()) {
+		error("Unable to write game data to savegame file \"%s\".", filename.c_str());
+	}
 	delete file;
 
+	debug(1, "Saved %d bytes of game data to \"%s\" in %d ms", writer.getDataSize(), filename.c_str(), g_system->getMillis() - startTime);
+
 	// Savegameinformationen fr diesen Slot aktualisieren.
 	_impl->readSlotSavegameInformation(slotID);
 
@@ -373,51 +386,72 @@ bool PersistenceService::loadGame(uint slotID) {
 	}
 #endif
 
-	byte *compressedDataBuffer = new byte[curSavegameInfo.gamedataLength];
-	byte *uncompressedDataBuffer = new byte[curSavegameInfo.gamedataUncompressedLength];
+	uint32 startTime = g_system->getMillis();
+
 	Common::String filename = generateSavegameFilename(slotID);
 	file = sfm->openForLoading(filename);
-
-	file->seek(curSavegameInfo.gamedataOffset);
-	file->read(reinterpret_cast<char *>(&compressedDataBuffer[0]), curSavegameInfo.gamedataLength);
-	if (file->err()) {
-		error("Unable to load the gamedata from the savegame file \"%s\".", filename.c_str());
-		delete[] compressedDataBuffer;
-		delete[] uncompressedDataBuffer;
+	if (!file) {
+		error("Unable to open the savegame file \"%s\".", filename.c_str());
 		return false;
 	}
 
-	// Uncompress game data, if needed.
-	unsigned long uncompressedBufferSize = curSavegameInfo.gamedataUncompressedLength;
+	file->seek(curSavegameInfo.gamedataOffset);
+
+	// Savegames since version 3 are read directly from the savegame file,
+	// older ones store the game data in a block of known size.
+	Common::SeekableReadStream *stream = file;
 
-	if (uncompressedBufferSize > curSavegameInfo.gamedataLength) {
-		// Older saved game, where the game data was compressed again.
-		if (!Common::uncompress(reinterpret_cast<byte *>(&uncompressedDataBuffer[0]), &uncompressedBufferSize,
-					   reinterpret_cast<byte *>(&compressedDataBuffer[0]), curSavegameInfo.gamedataLength)) {
-			error("Unable to decompress the gamedata from savegame file \"%s\".", filename.c_str());
-			delete[] uncompressedDataBuffer;
+	if (curSavegameInfo.version < 3) {
+		byte *compressedDataBuffer = new byte[curSavegameInfo.gamedataLength];
+		file->read(reinterpret_cast<char *>(&compressedDataBuffer[0]), curSavegameInfo.gamedataLength);
+		if (file->err()) {
+			error("Unable to load the gamedata from the savegame file \"%s\".", filename.c_str());
 			delete[] compressedDataBuffer;
 			delete file;
 			return false;
 		}
-	} else {
-		// Newer saved game with uncompressed game data, copy it as-is.
-		memcpy(uncompressedDataBuffer, compressedDataBuffer, uncompressedBufferSize);
-	}
 
-	InputPersistenceBlock reader(&uncompressedDataBuffer[0], curSavegameInfo.gamedataUncompressedLength, curSavegameInfo.version);
+		// Uncompress game data, if needed.
+		unsigned long uncompressedBufferSize = curSavegameInfo.gamedataUncompressedLength;
+
+		if (uncompressedBufferSize > curSavegameInfo.gamedataLength) {
+			// Older saved game, where the game data was compressed again.
+			byte *uncompressedDataBuffer = (byte *)malloc(uncompressedBufferSize);
+			if (!Common::uncompress(reinterpret_cast<byte *>(&uncompressedDataBuffer[0]), &uncompressedBufferSize,
+						   reinterpret_cast<byte *>(&compressedDataBuffer[0]), curSavegameInfo.gamedataLength)) {
+				error("Unable to decompress the gamedata from savegame file \"%s\".", filename.c_str());
+				free(uncompressedDataBuffer);
+				delete[] compressedDataBuffer;
+				delete file;
+				return false;
+			}
+
+			stream = new Common::MemoryReadStream(uncompressedDataBuffer, curSavegameInfo.gamedataUncompressedLength, DisposeAfterUse::YES);
+		} else {
+			// Newer saved game with uncompressed game data, copy it as-is.
+			byte *uncompressedDataBuffer = (byte *)malloc(uncompressedBufferSize);
+			memcpy(uncompressedDataBuffer, compressedDataBuffer, uncompressedBufferSize);
+			stream = new Common::MemoryReadStream(uncompressedDataBuffer, uncompressedBufferSize, DisposeAfterUse::YES);
+		}
+
+		delete[] compressedDataBuffer;
+	}
 
-	// Einzelne Engine-Module depersistieren.
 	bool success = true;
-	success &= Kernel::getInstance()->getScript()->unpersist(reader);
-	// Muss unbedingt nach Script passieren. Da sonst die bereits wiederhergestellten Regions per Garbage-Collection gekillt werden.
-	success &= RegionRegistry::instance().unpersist(reader);
-	success &= Kernel::getInstance()->getGfx()->unpersist(reader);
-	success &= Kernel::getInstance()->getSfx()->unpersist(reader);
-	success &= Kernel::getInstance()->getInput()->unpersist(reader);
-
-	delete[] compressedDataBuffer;
-	delete[] uncompressedDataBuffer;
+	{
+		InputPersistenceBlock reader(stream, curSavegameInfo.version);
+
+		// Einzelne Engine-Module depersistieren.
+		success &= Kernel::getInstance()->getScript()->unpersist(reader);
+		// Muss unbedingt nach Script passieren. Da sonst die bereits wiederhergestellten Regions per Garbage-Collection gekillt werden.
+		success &= RegionRegistry::instance().unpersist(reader);
+		success &= Kernel::getInstance()->getGfx()->unpersist(reader);
+		success &= Kernel::getInstance()->getSfx()->unpersist(reader);
+		success &= Kernel::getInstance()->getInput()->unpersist(reader);
+	}
+
+	if (stream != file)
+		delete stream;
 	delete file;
 
 	if (!success) {
@@ -425,6 +459,8 @@ bool PersistenceService::loadGame(uint slotID) {
 		return false;
 	}
 
+	debug(1, "Loaded game data from \"%s\" in %d ms", filename.c_str(), g_system->getMillis() - startTime);
+
 	return true;
 }
 
@@ -35,6 +35,8 @@
 #include "sword25/kernel/resservice.h"
 #include "sword25/package/packagemanager.h"
 
+#include "common/system.h"
+
 namespace Sword25 {
 
 // Sets the amount of resources that are simultaneously loaded.
@@ -46,6 +48,18 @@ namespace Sword25 {
 // are loaded, the resource manager will start purging resources till it
 // hits the minimum limit above
 #define SWORD25_RESOURCECACHE_MAX 500
+// The default number of bytes the loaded resources may occupy. This is
+// the value the game scripts set through Resource.SetMaxMemoryUsage().
+#define SWORD25_RESOURCECACHE_MEMORY 256000000
+
+ResourceManager::ResourceManager(Kernel *pKernel) :
+	_kernelPtr(pKernel),
+	_maxMemoryUsage(SWORD25_RESOURCECACHE_MEMORY),
+	_usedMemory(0),
+	_loadCount(0),
+	_loadTime(0),
+	_maxLoadTime(0) {
+}
 
 ResourceManager::~ResourceManager() {
 	// Clear all unlocked resources
@@ -87,9 +101,13 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  */
 void ResourceManager::deleteResourcesIfNecessary() {
 	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	if (_resources.size() < SWORD25_RESOURCECACHE_MAX && _usedMemory <= _maxMemoryUsage)
 		return;
 
+	// Release some more than necessary, so that this does not happen on every load
+	uint targetCount = (_resources.size() >= SWORD25_RESOURCECACHE_MAX) ? SWORD25_RESOURCECACHE_MIN : SWORD25_RESOURCECACHE_MAX;
+	uint targetMemory = (_usedMemory > _maxMemoryUsage) ? _maxMemoryUsage / 8 * 7 : _maxMemoryUsage;
+
 	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
 	// The list is processed backwards in order to first release those resources that have been
 	// not been accessed for the longest
@@ -100,14 +118,17 @@ void ResourceManager::deleteResourcesIfNecessary() {
 		// The resource may be released only if it isn't locked
 		if ((*iter)->getLockCount() == 0)
 			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	} while (iter != _resources.begin() && (_resources.size() >= targetCount || _usedMemory > targetMemory));
+
+	if (_usedMemory > _maxMemoryUsage)
+		debugC(kDebugResource, "Resource cache uses %d bytes, more than %d bytes are locked", _usedMemory, _maxMemoryUsage);
 
 	// Are we still above the minimum? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	if (targetCount != SWORD25_RESOURCECACHE_MIN || _resources.size() <= SWORD25_RESOURCECACHE_MIN)
 		return;
 
 	iter = _resources.end();
@@ -220,11 +241,69 @@ bool ResourceManager::precacheResource(const Common::String &fileName, bool forc
 
 #endif
 
+bool ResourceManager::queuePrecacheResource(const Common::String &fileName) {
+	// Get the absolute path to the file
+	Common::String uniqueFileName = getUniqueFileName(fileName);
+	if (uniqueFileName.empty())
+		return false;
+
+	if (getResource(uniqueFileName) || _precacheQueued.contains(uniqueFileName))
+		return true;
+
+	// Loading files which do not exist is fatal, so check this in advance
+	if (!_kernelPtr->getPackage()->fileExists(uniqueFileName)) {
+		debugC(kDebugResource, "Could not precache \"%s\",", fileName.c_str());
+		return false;
+	}
+
+	_precacheQueue.push(uniqueFileName);
+	_precacheQueued[uniqueFileName] = true;
+
+	return true;
+}
+
+void ResourceManager::processPrecacheQueue(uint32 timeBudget) {
+	if (_precacheQueue.empty())
+		return;
+
+	uint32 startTime = g_system->getMillis();
+	uint count = 0;
+
+	do {
+		Common::String uniqueFileName = _precacheQueue.pop();
+		_precacheQueued.erase(uniqueFileName);
+
+		// The resource may have been requested in the meantime
+		if (!getResource(uniqueFileName) && loadResource(uniqueFileName))
+			count++;
+	} while (!_precacheQueue.empty() && g_system->getMillis() - startTime < timeBudget);
+
+	debugC(kDebugResource, "Precached %d resources in %d ms, %d queued", count, g_system->getMillis() - startTime, _precacheQueue.size());
+}
+
+void ResourceManager::setMaxMemoryUsage(uint maxMemoryUsage) {
+	_maxMemoryUsage = maxMemoryUsage;
+	deleteResourcesIfNecessary();
+}
+
+Common::String ResourceManager::getStatistics() const {
+	return Common::String::format("%d resources loaded, using %d of %d bytes\n"
+	                              "%d resources queued for precaching\n"
+	                              "%d resources loaded in %d ms, the slowest in %d ms (%s)\n",
+	                              _resources.size(), _usedMemory, _maxMemoryUsage,
+	                              _precacheQueue.size(),
+	                              _loadCount, _loadTime, _maxLoadTime, _maxLoadTimeFileName.c_str());
+}
+
 /**
  * Moves a resource to the top of the resource list
  * @param pResource     The resource
  */
 void ResourceManager::moveToFront(Resource *pResource) {
+	// Nothing to do for the most recently used resource
+	if (pResource->_iterator == _resources.begin())
+		return;
+
 	// Erase the resource from it's current position
 	_resources.erase(pResource->_iterator);
 	// Re-add the resource at the front of the list
@@ -247,12 +326,25 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			deleteResourcesIfNecessary();
 
 			// Load the resource
+			uint32 startTime = g_system->getMillis();
 			Resource *pResource = _resourceServices[i]->loadResource(fileName);
 			if (!pResource) {
 				error("Responsible service could not load resource \"%s\".", fileName.c_str());
 				return NULL;
 			}
 
+			uint32 loadTime = g_system->getMillis() - startTime;
+			_loadCount++;
+			_loadTime += loadTime;
+			if (loadTime > _maxLoadTime) {
+				_maxLoadTime = loadTime;
+				_maxLoadTimeFileName = fileName;
+			}
+
+			pResource->_memoryUsage = pResource->getMemoryUsage();
+			_usedMemory += pResource->_memoryUsage;
+			debugC(2, kDebugResource, "Loaded \"%s\" (%d bytes) in %d ms", fileName.c_str(), pResource->_memoryUsage, loadTime);
+
 			// Add the resource to the front of the list
 			_resources.push_front(pResource);
 			pResource->_iterator = _resources.begin();
@@ -296,6 +388,8 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
 
+	_usedMemory -= pResource->_memoryUsage;
+
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
 
@@ -35,6 +35,7 @@
 #include "common/list.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/queue.h"
 
 #include "sword25/kernel/common.h"
 
@@ -66,6 +67,46 @@ public:
 	bool precacheResource(const Common::String &fileName, bool forceReload = false);
 #endif
 
+	/**
+	 * Queues a resource to be loaded into the cache. The queue is worked off
+	 * between frames by processPrecacheQueue(), so that scripts can precache
+	 * the resources of the next scene without stalling the current one.
+	 * @param FileName      The filename of the resource to be cached
+	 * @return              Returns false if the file does not exist
+	 */
+	bool queuePrecacheResource(const Common::String &fileName);
+
+	/**
+	 * Loads queued resources until the given time is used up. At least one
+	 * resource is loaded if any is queued.
+	 * @param TimeBudget    The time in milliseconds that may be spent
+	 */
+	void processPrecacheQueue(uint32 timeBudget);
+
+	uint getPrecacheQueueSize() const {
+		return _precacheQueue.size();
+	}
+
+	/**
+	 * Sets the number of bytes the cached resources may occupy. Unlocked
+	 * resources are released, least recently used first, when it is exceeded.
+	 */
+	void setMaxMemoryUsage(uint maxMemoryUsage);
+	uint getMaxMemoryUsage() const {
+		return _maxMemoryUsage;
+	}
+	uint getUsedMemory() const {
+		return _usedMemory;
+	}
+	uint getResourceCount() const {
+		return _resources.size();
+	}
+
+	/**
+	 * Writes the memory usage and load timing statistics to the given string
+	 */
+	Common::String getStatistics() const;
+
 	/**
 	 * Registers a RegisterResourceService. This method is the constructor of
 	 * BS_ResourceService, and thus helps all resource services in the ResourceManager list
@@ -93,9 +134,7 @@ private:
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
-	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
-	{}
+	ResourceManager(Kernel *pKernel);
 	virtual ~ResourceManager();
 
 	/**
@@ -139,6 +178,19 @@ private:
 	Common::List<Resource *> _resources;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
+
+	uint _maxMemoryUsage;
+	uint _usedMemory;
+
+	// Resources queued by queuePrecacheResource(), by their unique filenames
+	Common::Queue<Common::String> _precacheQueue;
+	Common::HashMap<Common::String, bool> _precacheQueued;
+
+	// Load timing statistics in milliseconds
+	uint _loadCount;
+	uint32 _loadTime;
+	uint32 _maxLoadTime;
+	Common::String _maxLoadTimeFileName;
 };
 
 } // End of namespace Sword25
@@ -31,6 +31,8 @@
 
 #include "common/array.h"
 #include "common/debug-channels.h"
+#include "common/memorypool.h"
+#include "common/system.h"
 
 #include "sword25/sword25.h"
 #include "sword25/package/packagemanager.h"
@@ -43,6 +45,8 @@
 #include "sword25/util/lua/lua.h"
 #include "sword25/util/lua/lualib.h"
 #include "sword25/util/lua/lauxlib.h"
+#include "sword25/util/lua/lgc.h"
+#include "sword25/util/lua/lstate.h"
 #include "sword25/util/pluto/pluto.h"
 
 namespace Sword25 {
@@ -50,13 +54,72 @@ namespace Sword25 {
 LuaScriptEngine::LuaScriptEngine(Kernel *KernelPtr) :
 	ScriptEngine(KernelPtr),
 	_state(0),
-	_pcallErrorhandlerRegistryIndex(0) {
+	_pcallErrorhandlerRegistryIndex(0),
+	_gcStartSize(0),
+	_gcCycles(0),
+	_gcLastFrameTime(0),
+	_gcMaxFrameTime(0),
+	_gcTotalTime(0),
+	_gcFrames(0) {
+	for (int i = 0; i < MEMORY_POOL_COUNT; ++i)
+		_memoryPools[i] = new Common::MemoryPool((i + 1) * MEMORY_POOL_GRANULARITY);
 }
 
 LuaScriptEngine::~LuaScriptEngine() {
 	// Lua de-initialisation
 	if (_state)
 		lua_close(_state);
+
+	for (int i = 0; i < MEMORY_POOL_COUNT; ++i)
+		delete _memoryPools[i];
+}
+
+void *LuaScriptEngine::allocateBlock(size_t size) {
+	if (size <= MEMORY_POOL_COUNT * MEMORY_POOL_GRANULARITY)
+		return _memoryPools[(size - 1) / MEMORY_POOL_GRANULARITY]->allocChunk();
+	else
+		return malloc(size);
+}
+
+void LuaScriptEngine::freeBlock(void *ptr, size_t size) {
+	if (size <= MEMORY_POOL_COUNT * MEMORY_POOL_GRANULARITY)
+		_memoryPools[(size - 1) / MEMORY_POOL_GRANULARITY]->freeChunk(ptr);
+	else
+		free(ptr);
+}
+
+/**
+ * The memory allocation function of the Lua state. Lua always passes the
+ * size of the old block, so the pool a block belongs to is known without
+ * storing it.
+ */
+void *LuaScriptEngine::allocate(void *ud, void *ptr, size_t osize, size_t nsize) {
+	LuaScriptEngine *engine = static_cast<LuaScriptEngine *>(ud);
+	const size_t maxPooledSize = MEMORY_POOL_COUNT * MEMORY_POOL_GRANULARITY;
+
+	if (nsize == 0) {
+		if (ptr)
+			engine->freeBlock(ptr, osize);
+		return NULL;
+	}
+
+	if (!ptr)
+		return engine->allocateBlock(nsize);
+
+	// Blocks that stay in the same pool do not have to be moved
+	if (osize <= maxPooledSize && nsize <= maxPooledSize &&
+	        (osize - 1) / MEMORY_POOL_GRANULARITY == (nsize - 1) / MEMORY_POOL_GRANULARITY)
+		return ptr;
+
+	if (osize > maxPooledSize && nsize > maxPooledSize)
+		return realloc(ptr, nsize);
+
+	void *block = engine->allocateBlock(nsize);
+	if (block) {
+		memcpy(block, ptr, MIN(osize, nsize));
+		engine->freeBlock(ptr, osize);
+	}
+	return block;
 }
 
 namespace {
@@ -75,7 +138,7 @@ void debugHook(lua_State *L, lua_Debug *ar) {
 
 bool LuaScriptEngine::init() {
 	// Lua-State initialisation, as well as standard libaries initialisation
-	_state = luaL_newstate();
+	_state = lua_newstate(allocate, this);
 	if (!_state || ! registerStandardLibs() || !registerStandardLibExtensions()) {
 		error("Lua could not be initialized.");
 		return false;
@@ -130,11 +193,52 @@ bool LuaScriptEngine::init() {
 			lua_sethook(_state, debugHook, mask, 0);
 	}
 
+	// The garbage collector is driven by collectGarbage() from now on
+	_gcStartSize = (G(_state)->totalbytes / 100) * G(_state)->gcpause;
+
 	debugC(kDebugScript, "Lua initialized.");
 
 	return true;
 }
 
+void LuaScriptEngine::collectGarbage(uint32 timeBudget) {
+	global_State *g = G(_state);
+	uint32 startTime = g_system->getMillis();
+
+	// A new cycle is started once the memory usage has grown as much as the
+	// collector would have allowed on its own
+	if (g->gcstate != GCSpause || g->totalbytes >= _gcStartSize) {
+		do {
+			if (lua_gc(_state, LUA_GCSTEP, 0)) {
+				_gcCycles++;
+				_gcStartSize = (g->estimate / 100) * g->gcpause;
+
+				// Give memory back to the system, which was only needed
+				// during allocation peaks like loading a savegame
+				for (int i = 0; i < MEMORY_POOL_COUNT; i++)
+					_memoryPools[i]->freeUnusedPages();
+				break;
+			}
+		} while (g_system->getMillis() - startTime < timeBudget);
+	}
+
+	// Keep the collector from running on its own until the next frame,
+	// unless the scripts allocate a lot more memory than usual
+	g->GCthreshold = MAX<lu_mem>(g->totalbytes, _gcStartSize) * 2;
+
+	_gcLastFrameTime = g_system->getMillis() - startTime;
+	_gcMaxFrameTime = MAX(_gcMaxFrameTime, _gcLastFrameTime);
+	_gcTotalTime += _gcLastFrameTime;
+	_gcFrames++;
+}
+
+Common::String LuaScriptEngine::getStatistics() const {
+	return Common::String::format("Lua memory: %d KB, %d garbage collection cycles\n"
+	                              "Garbage collection time: %d ms in the last frame, %d ms at most, %d ms in %d frames\n",
+	                              lua_gc(_state, LUA_GCCOUNT, 0), _gcCycles,
+	                              _gcLastFrameTime, _gcMaxFrameTime, _gcTotalTime, _gcFrames);
+}
+
 bool LuaScriptEngine::executeFile(const Common::String &fileName) {
 #ifdef DEBUG
 	int __startStackDepth = lua_gettop(_state);
@@ -386,12 +490,33 @@ bool pushPermanentsTable(lua_State *L, PERMANENT_TABLE_TYPE tableType) {
 }
 
 namespace {
+const uint CHUNK_BUFFER_SIZE = 1024 * 4;
+
+// Pluto writes its data in many small pieces, which are collected here before
+// they are passed on to the persistence block.
+struct ChunkwriterData {
+	OutputPersistenceBlock *Writer;
+	byte Buffer[CHUNK_BUFFER_SIZE];
+	uint Size;
+};
+
+void flushChunkwriter(ChunkwriterData &cd) {
+	cd.Writer->writeStreamData(cd.Buffer, cd.Size);
+	cd.Size = 0;
+}
+
 int chunkwriter(lua_State *L, const void *p, size_t sz, void *ud) {
-	Common::Array<byte> & chunkData = *reinterpret_cast<Common::Array<byte> * >(ud);
-	const byte *buffer = reinterpret_cast<const byte *>(p);
+	ChunkwriterData &cd = *reinterpret_cast<ChunkwriterData *>(ud);
 
-	while (sz--)
-		chunkData.push_back(*buffer++);
+	if (cd.Size + sz > CHUNK_BUFFER_SIZE)
+		flushChunkwriter(cd);
+
+	if (sz > CHUNK_BUFFER_SIZE) {
+		cd.Writer->writeStreamData(p, sz);
+	} else {
+		memcpy(cd.Buffer + cd.Size, p, sz);
+		cd.Size += sz;
+	}
 
 	return 1;
 }
@@ -409,12 +534,15 @@ bool LuaScriptEngine::persist(OutputPersistenceBlock &writer) {
 	pushPermanentsTable(_state, PTT_PERSIST);
 	lua_getglobal(_state, "_G");
 
-	// Lua persists and stores the data in a Common::Array
-	Common::Array<byte> chunkData;
-	pluto_persist(_state, chunkwriter, &chunkData);
+	// Lua persists the data directly into the writer
+	ChunkwriterData cd;
+	cd.Writer = &writer;
+	cd.Size = 0;
 
-	// Persistenzdaten in den Writer schreiben.
-	writer.writeByteArray(chunkData);
+	writer.beginStream();
+	pluto_persist(_state, chunkwriter, &cd);
+	flushChunkwriter(cd);
+	writer.endStream();
 
 	// Die beiden Tabellen vom Stack nehmen.
 	lua_pop(_state, 2);
@@ -442,6 +570,18 @@ const char *chunkreader(lua_State *L, void *ud, size_t *sz) {
 	}
 }
 
+struct StreamreaderData {
+	InputPersistenceBlock *Reader;
+	byte Buffer[CHUNK_BUFFER_SIZE];
+};
+
+const char *streamreader(lua_State *L, void *ud, size_t *sz) {
+	StreamreaderData &sd = *reinterpret_cast<StreamreaderData *>(ud);
+
+	*sz = sd.Reader->readStreamData(sd.Buffer, CHUNK_BUFFER_SIZE);
+	return *sz ? reinterpret_cast<const char *>(sd.Buffer) : 0;
+}
+
 void clearGlobalTable(lua_State *L, const char **exceptions) {
 	// Iterate over all elements of the global table
 	lua_pushvalue(L, LUA_GLOBALSINDEX);
@@ -509,17 +649,27 @@ bool LuaScriptEngine::unpersist(InputPersistenceBlock &reader) {
 	};
 	clearGlobalTable(_state, clearExceptionsSecondPass);
 
-	// Persisted Lua data
-	Common::Array<byte> chunkData;
-	reader.readByteArray(chunkData);
+	if (reader.getVersion() >= 3) {
+		// The persisted Lua data is read directly from the savegame
+		StreamreaderData sd;
+		sd.Reader = &reader;
+
+		reader.beginStream();
+		pluto_unpersist(_state, streamreader, &sd);
+		reader.endStream();
+	} else {
+		// Older savegames store the persisted Lua data as a single block
+		Common::Array<byte> chunkData;
+		reader.readByteArray(chunkData);
 
-	// Chunk-Reader initialisation. It is used with pluto_unpersist to restore read data
-	ChunkreaderData cd;
-	cd.BufferPtr = &chunkData[0];
-	cd.Size = chunkData.size();
-	cd.BufferReturned = false;
+		// Chunk-Reader initialisation. It is used with pluto_unpersist to restore read data
+		ChunkreaderData cd;
+		cd.BufferPtr = &chunkData[0];
+		cd.Size = chunkData.size();
+		cd.BufferReturned = false;
 
-	pluto_unpersist(_state, chunkreader, &cd);
+		pluto_unpersist(_state, chunkreader, &cd);
+	}
 
 	// Permanents-Table is removed from stack
 	lua_remove(_state, -2);
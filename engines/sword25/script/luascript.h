@@ -39,6 +39,10 @@
 
 struct lua_State;
 
+namespace Common {
+class MemoryPool;
+}
+
 namespace Sword25 {
 
 class Kernel;
@@ -84,6 +88,18 @@ public:
 	 */
 	virtual void setCommandLine(const Common::StringArray &commandLineParameters);
 
+	/**
+	 * Advances the incremental garbage collector of Lua until the time is used up or
+	 * a collection cycle is finished. Between these calls, the collector only runs
+	 * if the scripts allocate much more memory than expected.
+	 */
+	virtual void collectGarbage(uint32 timeBudget);
+
+	/**
+	 * Returns the memory usage and garbage collection statistics
+	 */
+	Common::String getStatistics() const;
+
 	/**
 	 * @remark              The Lua stack is cleared by this method
 	 */
@@ -97,6 +113,27 @@ private:
 	lua_State *_state;
 	int _pcallErrorhandlerRegistryIndex;
 
+	// Small allocations of Lua are served from pools of fixed size chunks
+	enum {
+		MEMORY_POOL_GRANULARITY = 16,
+		MEMORY_POOL_COUNT = 16
+	};
+	Common::MemoryPool *_memoryPools[MEMORY_POOL_COUNT];
+
+	static void *allocate(void *ud, void *ptr, size_t osize, size_t nsize);
+	void *allocateBlock(size_t size);
+	void freeBlock(void *ptr, size_t size);
+
+	// Memory usage at which the next garbage collection cycle is started
+	size_t _gcStartSize;
+
+	// Garbage collection statistics, times are in milliseconds
+	uint _gcCycles;
+	uint32 _gcLastFrameTime;
+	uint32 _gcMaxFrameTime;
+	uint32 _gcTotalTime;
+	uint _gcFrames;
+
 	bool registerStandardLibs();
 	bool registerStandardLibExtensions();
 	bool executeBuffer(const byte *data, uint size, const Common::String &name) const;
@@ -84,6 +84,13 @@ public:
 	*/
 	virtual void setCommandLine(const Common::Array<Common::String> &commandLineParameters) = 0;
 
+	/**
+	 * Runs the garbage collector of the script language for up to the given time.
+	 * This is called once per frame, so that collections are spread evenly over the frames.
+	 * @param TimeBudget    The time in milliseconds that may be spent
+	 */
+	virtual void collectGarbage(uint32 timeBudget) = 0;
+
 	virtual bool persist(OutputPersistenceBlock &writer) = 0;
 	virtual bool unpersist(InputPersistenceBlock &reader) = 0;
 };
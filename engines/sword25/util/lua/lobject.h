@@ -234,6 +234,7 @@ typedef struct Proto {
   Instruction *code;
   struct Proto **p;  /* functions defined inside the function */
   int *lineinfo;  /* map from opcodes to source lines */
+  int *tcache;  /* map from opcodes to cached table slots (see lvm.cpp) */
   struct LocVar *locvars;  /* information about local variables */
   TString **upvalues;  /* upvalue names */
   TString  *source;
@@ -241,6 +242,7 @@ typedef struct Proto {
   int sizek;  /* size of `k' */
   int sizecode;
   int sizelineinfo;
+  int sizetcache;
   int sizep;  /* size of `p' */
   int sizelocvars;
   int linedefined;
@@ -10,6 +10,7 @@
 #include "lua.h"
 
 #include "lobject.h"
+#include "lopcodes.h"
 #include "ltm.h"
 #include "lzio.h"
 
@@ -62,6 +63,18 @@ typedef struct CallInfo {
 #define isLua(ci)	(ttisfunction((ci)->func) && f_isLua(ci))
 
 
+/*
+** statistics of the interpreter
+*/
+typedef struct VMStats {
+  unsigned long tcachehits;  /* table accesses answered by the inline caches */
+  unsigned long tcachemisses;
+#ifdef LUAI_OPCOUNTS
+  unsigned long opcounts[NUM_OPCODES];
+#endif
+} VMStats;
+
+
 /*
 ** `global state', shared by all threads of this state
 */
@@ -91,6 +104,7 @@ typedef struct global_State {
   UpVal uvhead;  /* head of double-linked list of all open upvalues */
   struct Table *mt[NUM_TAGS];  /* metatables for basic types */
   TString *tmname[TM_N];  /* array with tag-method names */
+  VMStats vmstats;
 } global_State;
 
 
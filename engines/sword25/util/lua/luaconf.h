@@ -316,6 +316,14 @@
 #define LUAI_GCMUL	200 /* GC runs 'twice the speed' of memory allocation */
 
 
+/*
+@@ LUAI_OPCOUNTS makes the VM count how often every opcode is executed.
+** CHANGE it (define it) if you want to profile scripts. The counts are
+** kept in the global state, see VMStats in lstate.h.
+*/
+/* #define LUAI_OPCOUNTS */
+
+
 
 /*
 @@ LUA_COMPAT_GETN controls compatibility with old getn behavior.
@@ -18,6 +18,7 @@
 #include "ldo.h"
 #include "lfunc.h"
 #include "lgc.h"
+#include "lmem.h"
 #include "lobject.h"
 #include "lopcodes.h"
 #include "lstate.h"
@@ -158,6 +159,101 @@ void luaV_settable (lua_State *L, const TValue *t, TValue *key, StkId val) {
 }
 
 
+/*
+** Inline caches of table accesses with string keys. Every instruction
+** which indexes a table remembers the node its key was found in last.
+** Tables filled in the same order keep their keys in the same nodes, so
+** the key is usually found there without hashing. The node is compared
+** with the key before it is used, so the caches never need to be
+** invalidated.
+*/
+
+static void inittcache (lua_State *L, Proto *p) {
+  luaM_reallocvector(L, p->tcache, p->sizetcache, p->sizecode, int);
+  p->sizetcache = p->sizecode;
+  memset(p->tcache, 0, p->sizetcache * sizeof(int));
+}
+
+
+static const TValue *cachedgetstr (lua_State *L, Table *h, TString *key,
+                                   int *slot) {
+  const TValue *res;
+  if (*slot < sizenode(h)) {
+    Node *n = gnode(h, *slot);
+    if (ttisstring(gkey(n)) && rawtsvalue(gkey(n)) == key) {
+      G(L)->vmstats.tcachehits++;
+      return gval(n);
+    }
+  }
+  G(L)->vmstats.tcachemisses++;
+  res = luaH_getstr(h, key);
+  if (res != luaO_nilobject)  /* key is in the hash part? */
+    *slot = cast_int(cast(const Node *, res) - gnode(h, 0));
+  return res;
+}
+
+
+/*
+** Same as cachedgetstr, but returns a writable value, or NULL if the key is
+** not in the hash part.
+*/
+static TValue *cachedsetstr (lua_State *L, Table *h, TString *key,
+                             int *slot) {
+  Node *n;
+  if (*slot < sizenode(h)) {
+    n = gnode(h, *slot);
+    if (ttisstring(gkey(n)) && rawtsvalue(gkey(n)) == key) {
+      G(L)->vmstats.tcachehits++;
+      return gval(n);
+    }
+  }
+  G(L)->vmstats.tcachemisses++;
+  n = gnode(h, lmod(key->tsv.hash, sizenode(h)));
+  do {  /* check whether `key' is somewhere in the chain */
+    if (ttisstring(gkey(n)) && rawtsvalue(gkey(n)) == key) {
+      *slot = cast_int(n - gnode(h, 0));
+      return gval(n);
+    }
+    n = gnext(n);
+  } while (n);
+  return NULL;
+}
+
+
+/*
+** Returns 1 if the access was done through the cache, or 0 if it has to be
+** done by luaV_gettable, as it involves metamethods.
+*/
+static int cachedgettable (lua_State *L, const TValue *t, const TValue *key,
+                           StkId val, int *slot) {
+  Table *h;
+  const TValue *res;
+  if (!ttistable(t) || !ttisstring(key)) return 0;
+  h = hvalue(t);
+  res = cachedgetstr(L, h, rawtsvalue(key), slot);
+  if (ttisnil(res) && fasttm(L, h->metatable, TM_INDEX) != NULL)
+    return 0;
+  setobj2s(L, val, res);
+  return 1;
+}
+
+
+static int cachedsettable (lua_State *L, const TValue *t, const TValue *key,
+                           StkId val, int *slot) {
+  Table *h;
+  TValue *oldval;
+  if (!ttistable(t) || !ttisstring(key)) return 0;
+  h = hvalue(t);
+  /* new keys and __newindex are left to luaV_settable */
+  oldval = cachedsetstr(L, h, rawtsvalue(key), slot);
+  if (oldval == NULL || ttisnil(oldval)) return 0;
+  h->flags = 0;
+  setobj2t(L, oldval, val);
+  luaC_barriert(L, h, val);
+  return 1;
+}
+
+
 static int call_binTM (lua_State *L, const TValue *p1, const TValue *p2,
                        StkId res, TMS event) {
   const TValue *tm = luaT_gettmbyobj(L, p1, event);  /* try first operand */
@@ -356,6 +452,9 @@ static void Arith (lua_State *L, StkId ra, const TValue *rb,
 
 #define Protect(x)	{ L->savedpc = pc; {x;}; base = L->base; }
 
+/* cached table slot of the current instruction */
+#define TCACHE		(&cl->p->tcache[pc - cl->p->code - 1])
+
 
 #define arith_op(op,tm) { \
         TValue *rb = RKB(i); \
@@ -381,10 +480,15 @@ void luaV_execute (lua_State *L, int nexeccalls) {
   cl = &clvalue(L->ci->func)->l;
   base = L->base;
   k = cl->p->k;
+  if (cl->p->sizetcache != cl->p->sizecode)
+    inittcache(L, cl->p);
   /* main loop of interpreter */
   for (;;) {
     const Instruction i = *pc++;
     StkId ra;
+#ifdef LUAI_OPCOUNTS
+    G(L)->vmstats.opcounts[GET_OPCODE(i)]++;
+#endif
     if ((L->hookmask & (LUA_MASKLINE | LUA_MASKCOUNT)) &&
         (--L->hookcount == 0 || L->hookmask & LUA_MASKLINE)) {
       traceexec(L, pc);
@@ -430,18 +534,21 @@ void luaV_execute (lua_State *L, int nexeccalls) {
         TValue *rb = KBx(i);
         sethvalue(L, &g, cl->env);
         lua_assert(ttisstring(rb));
-        Protect(luaV_gettable(L, &g, rb, ra));
+        if (!cachedgettable(L, &g, rb, ra, TCACHE))
+          Protect(luaV_gettable(L, &g, rb, ra));
         continue;
       }
       case OP_GETTABLE: {
-        Protect(luaV_gettable(L, RB(i), RKC(i), ra));
+        if (!cachedgettable(L, RB(i), RKC(i), ra, TCACHE))
+          Protect(luaV_gettable(L, RB(i), RKC(i), ra));
         continue;
       }
       case OP_SETGLOBAL: {
         TValue g;
         sethvalue(L, &g, cl->env);
         lua_assert(ttisstring(KBx(i)));
-        Protect(luaV_settable(L, &g, KBx(i), ra));
+        if (!cachedsettable(L, &g, KBx(i), ra, TCACHE))
+          Protect(luaV_settable(L, &g, KBx(i), ra));
         continue;
       }
       case OP_SETUPVAL: {
@@ -451,7 +558,8 @@ void luaV_execute (lua_State *L, int nexeccalls) {
         continue;
       }
       case OP_SETTABLE: {
-        Protect(luaV_settable(L, ra, RKB(i), RKC(i)));
+        if (!cachedsettable(L, ra, RKB(i), RKC(i), TCACHE))
+          Protect(luaV_settable(L, ra, RKB(i), RKC(i)));
         continue;
       }
       case OP_NEWTABLE: {
@@ -464,7 +572,8 @@ void luaV_execute (lua_State *L, int nexeccalls) {
       case OP_SELF: {
         StkId rb = RB(i);
         setobjs2s(L, ra+1, rb);
-        Protect(luaV_gettable(L, rb, RKC(i), ra));
+        if (!cachedgettable(L, rb, RKC(i), ra, TCACHE))
+          Protect(luaV_gettable(L, rb, RKC(i), ra));
         continue;
       }
       case OP_ADD: {
@@ -38,6 +38,8 @@ Proto *pdep_newproto (lua_State *L) {
 	f->code = NULL;
 	f->sizecode = 0;
 	f->sizelineinfo = 0;
+	f->tcache = NULL;
+	f->sizetcache = 0;
 	f->sizeupvalues = 0;
 	f->nups = 0;
 	f->upvalues = NULL;
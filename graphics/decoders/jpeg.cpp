@@ -28,6 +28,7 @@
 #include "common/endian.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
+#include "common/util.h"
 
 namespace Graphics {
 
@@ -43,9 +44,23 @@ static const uint8 _zigZagOrder[64] = {
 	53, 60, 61, 54, 47, 55, 62, 63
 };
 
+// Scaling factors of the AAN IDCT, scaled by 14 bits. They are applied to
+// the quantization tables, so the IDCT itself can skip them.
+static const uint16 _aanScales[64] = {
+	16384, 22725, 21407, 19266, 16384, 12873,  8867,  4520,
+	22725, 31521, 29692, 26722, 22725, 17855, 12299,  6270,
+	21407, 29692, 27969, 25172, 21407, 16819, 11585,  5906,
+	19266, 26722, 25172, 22654, 19266, 15137, 10426,  5315,
+	16384, 22725, 21407, 19266, 16384, 12873,  8867,  4520,
+	12873, 17855, 16819, 15137, 12873, 10114,  6967,  3552,
+	 8867, 12299, 11585, 10426,  8867,  6967,  4799,  2446,
+	 4520,  6270,  5906,  5315,  4520,  3552,  2446,  1247
+};
+
 JPEGDecoder::JPEGDecoder() : ImageDecoder(),
 	_stream(NULL), _w(0), _h(0), _numComp(0), _components(NULL), _numScanComp(0),
-	_scanComp(NULL), _currentComp(NULL), _rgbSurface(0) {
+	_scanComp(NULL), _currentComp(NULL), _rgbSurface(0),
+	_outputFormat(4, 8, 8, 8, 8, 24, 16, 8, 0) {
 
 	// Initialize the quantization tables
 	for (int i = 0; i < JPEG_MAX_QUANT_TABLES; i++)
@@ -72,9 +87,10 @@ const Surface *JPEGDecoder::getSurface() const {
 	if (_rgbSurface)
 		return _rgbSurface;
 
-	// Create an RGBA8888 surface
+	// Create a surface in the output format, which the color conversion
+	// writes directly
 	_rgbSurface = new Graphics::Surface();
-	_rgbSurface->create(_w, _h, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	_rgbSurface->create(_w, _h, _outputFormat);
 
 	// Get our component surfaces
 	const Graphics::Surface *yComponent = getComponent(1);
@@ -120,6 +136,7 @@ void JPEGDecoder::destroy() {
 	if (_rgbSurface) {
 		_rgbSurface->free();
 		delete _rgbSurface;
+		_rgbSurface = 0;
 	}
 }
 
@@ -336,6 +353,29 @@ bool JPEGDecoder::readDHT() {
 			curCode++;
 			cur++;
 		}
+
+		// Fill the tables used for decoding
+		HuffmanTable &huff = _huff[tableNum];
+		cur = 0;
+		huff.maxCode[0] = -1;
+		for (int len = 1; len <= 16; len++) {
+			if (numValues[len - 1]) {
+				huff.valueOffset[len] = cur - huff.codes[cur];
+				cur += numValues[len - 1];
+				huff.maxCode[len] = huff.codes[cur - 1];
+			} else {
+				huff.valueOffset[len] = 0;
+				huff.maxCode[len] = -1;
+			}
+		}
+
+		memset(huff.lookup, 0, sizeof(huff.lookup));
+		for (int i = 0; i < huff.count && huff.sizes[i] <= JPEG_HUFF_LOOKAHEAD; i++) {
+			// All entries starting with the code get its size and value
+			int shift = JPEG_HUFF_LOOKAHEAD - huff.sizes[i];
+			for (int j = 0; j < (1 << shift); j++)
+				huff.lookup[(huff.codes[i] << shift) | j] = (huff.sizes[i] << 8) | huff.values[i];
+		}
 	}
 
 	return true;
@@ -419,6 +459,7 @@ bool JPEGDecoder::readSOS() {
 
 	// Entropy coded sequence starts, initialize Huffman decoder
 	_bitsNumber = 0;
+	_bitsEnd = false;
 
 	// Read all the scan MCUs
 	uint16 xMCU = _w / (_maxFactorH * 8);
@@ -449,7 +490,10 @@ bool JPEGDecoder::readSOS() {
 
 				if (interval == 0) {
 					interval = _restartInterval;
-					_bitsNumber = 0;
+
+					// Drop the padding bits of the current byte. The
+					// restart marker itself is skipped by fillBits().
+					_bitsNumber -= _bitsNumber & 7;
 
 					for (byte i = 0; i < _numScanComp; i++)
 						_scanComp[i]->DCpredictor = 0;					
@@ -481,18 +525,21 @@ bool JPEGDecoder::readDQT() {
 
 		// Validate the table id
 		tableId &= 0xF;
-		if (tableId > JPEG_MAX_QUANT_TABLES) {
+		if (tableId >= JPEG_MAX_QUANT_TABLES) {
 			warning("JPEG: Invalid number of components");
 			return false;
 		}
 
 		// Create the new table if necessary
 		if (!_quant[tableId])
-			_quant[tableId] = new uint16[64];
+			_quant[tableId] = new int32[64];
 
-		// Read the table (stored in Zig-Zag order)
-		for (int i = 0; i < 64; i++)
-			_quant[tableId][i] = highPrecision ? _stream->readUint16BE() : _stream->readByte();
+		// Read the table (stored in Zig-Zag order), and apply the scaling
+		// factors of the IDCT to it
+		for (int i = 0; i < 64; i++) {
+			int32 quant = highPrecision ? _stream->readUint16BE() : _stream->readByte();
+			_quant[tableId][_zigZagOrder[i]] = (quant * _aanScales[_zigZagOrder[i]] + (1 << 11)) >> 12;
+		}
 	}
 
 	return true;
@@ -528,69 +575,112 @@ bool JPEGDecoder::readMCU(uint16 xMCU, uint16 yMCU) {
 	return ok;
 }
 
-// triple-butterfly-add (and possible rounding)
-#define xadd3(xa, xb, xc, xd, h) \
-	p = xa + xb; \
-	n = xa - xb; \
-	xa = p + xc + h; \
-	xb = n + xd + h; \
-	xc = p - xc + h; \
-	xd = n - xd + h;
-
-// butterfly-mul
-#define xmul(xa, xb, k1, k2, sh) \
-	n = k1 * (xa + xb); \
-	p = xa; \
-	xa = (n + (k2 - k1) * xb) >> sh; \
-	xb = (n - (k2 + k1) * p) >> sh;
-
-// IDCT based on public domain code from http://halicery.com/jpeg/idct.html
-void JPEGDecoder::idct1D8x8(int32 src[8], int32 dest[64], int32 ps, int32 half) {
-	int p, n;
-
-	src[0] <<= 9;
-	src[1] <<= 7;
-	src[3] *= 181;
-	src[4] <<= 9;
-	src[5] *= 181;
-	src[7] <<= 7;
+// Fixed point constants of the IDCT, scaled by 8 bits
+#define FIX_1_082392200 277
+#define FIX_1_414213562 362
+#define FIX_1_847759065 473
+#define FIX_2_613125930 669
+
+#define IDCT_MUL(v, c) (((v) * (c)) >> 8)
 
+// One-dimensional AAN IDCT, see jidctfst.c of the IJG JPEG library
+static inline void idct1D8(int32 in0, int32 in1, int32 in2, int32 in3, int32 in4, int32 in5, int32 in6, int32 in7, int32 *out, int stride) {
 	// Even part
-	xmul(src[6], src[2], 277, 669, 0)
-	xadd3(src[0], src[4], src[6], src[2], half)
+	int32 tmp10 = in0 + in4;
+	int32 tmp11 = in0 - in4;
+	int32 tmp13 = in2 + in6;
+	int32 tmp12 = IDCT_MUL(in2 - in6, FIX_1_414213562) - tmp13;
+
+	int32 tmp0 = tmp10 + tmp13;
+	int32 tmp3 = tmp10 - tmp13;
+	int32 tmp1 = tmp11 + tmp12;
+	int32 tmp2 = tmp11 - tmp12;
 
 	// Odd part
-	xadd3(src[1], src[7], src[3], src[5], 0)
-	xmul(src[5], src[3], 251, 50, 6)
-	xmul(src[1], src[7], 213, 142, 6)
-
-	dest[0 * 8] = (src[0] + src[1]) >> ps;
-	dest[1 * 8] = (src[4] + src[5]) >> ps;
-	dest[2 * 8] = (src[2] + src[3]) >> ps;
-	dest[3 * 8] = (src[6] + src[7]) >> ps;
-	dest[4 * 8] = (src[6] - src[7]) >> ps;
-	dest[5 * 8] = (src[2] - src[3]) >> ps;
-	dest[6 * 8] = (src[4] - src[5]) >> ps;
-	dest[7 * 8] = (src[0] - src[1]) >> ps;
+	int32 z13 = in5 + in3;
+	int32 z10 = in5 - in3;
+	int32 z11 = in1 + in7;
+	int32 z12 = in1 - in7;
+
+	int32 tmp7 = z11 + z13;
+	int32 z5 = IDCT_MUL(z10 + z12, FIX_1_847759065);
+	tmp11 = IDCT_MUL(z11 - z13, FIX_1_414213562);
+	tmp10 = IDCT_MUL(z12, FIX_1_082392200) - z5;
+	tmp12 = IDCT_MUL(z10, -FIX_2_613125930) + z5;
+
+	int32 tmp6 = tmp12 - tmp7;
+	int32 tmp5 = tmp11 - tmp6;
+	int32 tmp4 = tmp10 + tmp5;
+
+	out[0 * stride] = tmp0 + tmp7;
+	out[7 * stride] = tmp0 - tmp7;
+	out[1 * stride] = tmp1 + tmp6;
+	out[6 * stride] = tmp1 - tmp6;
+	out[2 * stride] = tmp2 + tmp5;
+	out[5 * stride] = tmp2 - tmp5;
+	out[4 * stride] = tmp3 + tmp4;
+	out[3 * stride] = tmp3 - tmp4;
 }
 
-void JPEGDecoder::idct2D8x8(int32 block[64]) {
+void JPEGDecoder::idct8x8(const int16 coefs[64], const int32 quant[64], byte *dst, int pitch) {
 	int32 tmp[64];
 
-	// Apply 1D IDCT to rows
-	for (int i = 0; i < 8; i++)
-		idct1D8x8(&block[i * 8], &tmp[i], 9, 1 << 8);
+	// Dequantize and apply the 1D IDCT to the columns. The results keep
+	// 2 extra bits of precision.
+	for (int i = 0; i < 8; i++) {
+		const int16 *in = &coefs[i];
+		const int32 *q = &quant[i];
+
+		if (!(in[8] | in[16] | in[24] | in[32] | in[40] | in[48] | in[56])) {
+			// Only the DC coefficient is set, so the whole column has its value
+			int32 dc = in[0] * q[0];
+			for (int j = 0; j < 8; j++)
+				tmp[j * 8 + i] = dc;
+			continue;
+		}
+
+		idct1D8(in[0] * q[0], in[8] * q[8], in[16] * q[16], in[24] * q[24],
+		        in[32] * q[32], in[40] * q[40], in[48] * q[48], in[56] * q[56], &tmp[i], 8);
+	}
+
+	// Apply the 1D IDCT to the rows, then remove the scaling, round, level
+	// shift to make the values unsigned, and clip them
+	for (int j = 0; j < 8; j++) {
+		int32 *in = &tmp[j * 8];
+
+		// Adding to the DC value adds to all values of the row
+		in[0] += (128 << 5) + (1 << 4);
+
+		if (!(in[1] | in[2] | in[3] | in[4] | in[5] | in[6] | in[7])) {
+			memset(dst, CLIP<int32>(in[0] >> 5, 0, 255), 8);
+		} else {
+			int32 row[8];
+			idct1D8(in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7], row, 1);
 
-	// Apply 1D IDCT to columns
-	for (int i = 0; i < 8; i++)
-		idct1D8x8(&tmp[i * 8], &block[i], 12, 1 << 11);
- }
+			for (int i = 0; i < 8; i++)
+				dst[i] = CLIP<int32>(row[i] >> 5, 0, 255);
+		}
+
+		dst += pitch;
+	}
+}
+
+#undef IDCT_MUL
+#undef FIX_1_082392200
+#undef FIX_1_414213562
+#undef FIX_1_847759065
+#undef FIX_2_613125930
 
 bool JPEGDecoder::readDataUnit(uint16 x, uint16 y) {
+	const int32 *quant = _quant[_currentComp->quantTableSelector];
+	if (!quant) {
+		warning("JPEG: Missing quantization table %d", _currentComp->quantTableSelector);
+		return false;
+	}
+
 	// Prepare an empty data array
 	int16 readData[64];
-	for (int i = 1; i < 64; i++)
-		readData[i] = 0;
+	memset(readData, 0, sizeof(readData));
 
 	// Read the DC component
 	readData[0] = _currentComp->DCpredictor + readDC();
@@ -599,32 +689,6 @@ bool JPEGDecoder::readDataUnit(uint16 x, uint16 y) {
 	// Read the AC components (stored in Zig-Zag)
 	readAC(readData);
 
-	// Calculate the DCT coefficients from the input sequence
-	int32 block[64];
-	for (uint8 i = 0; i < 64; i++) {
-		// Dequantize
-		int32 val = readData[i];
-		int16 quant = _quant[_currentComp->quantTableSelector][i];
-		val *= quant;
-
-		// Store the normalized coefficients, undoing the Zig-Zag
-		block[_zigZagOrder[i]] = val;
-	}
-
-	// Apply the IDCT
-	idct2D8x8(block);
-
-	// Level shift to make the values unsigned
-	for (int i = 0; i < 64; i++) {
-		block[i] = block[i] + 128;
-
-		if (block[i] < 0)
-			block[i] = 0;
-
-		if (block[i] > 255)
-			block[i] = 255;
-	}
-
 	// Paint the component surface
 	uint8 scalingV = _maxFactorV / _currentComp->factorV;
 	uint8 scalingH = _maxFactorH / _currentComp->factorH;
@@ -633,6 +697,16 @@ bool JPEGDecoder::readDataUnit(uint16 x, uint16 y) {
 	x <<= 3;
 	y <<= 3;
 
+	if (scalingV == 1 && scalingH == 1) {
+		// Apply the IDCT directly to the surface
+		idct8x8(readData, quant, (byte *)_currentComp->surface.getBasePtr(x, y), _currentComp->surface.pitch);
+		return true;
+	}
+
+	// Apply the IDCT
+	byte block[64];
+	idct8x8(readData, quant, block, 8);
+
 	for (uint8 j = 0; j < 8; j++) {
 		for (uint16 sV = 0; sV < scalingV; sV++) {
 			// Get the beginning of the block line
@@ -640,7 +714,7 @@ bool JPEGDecoder::readDataUnit(uint16 x, uint16 y) {
 
 			for (uint8 i = 0; i < 8; i++) {
 				for (uint16 sH = 0; sH < scalingH; sH++) {
-					*ptr = (byte)(block[j * 8 + i]);
+					*ptr = block[j * 8 + i];
 					ptr++;
 				}
 			}
@@ -684,89 +758,101 @@ void JPEGDecoder::readAC(int16 *out) {
 			// Skip r values
 			cur += r;
 
-			// Read the next value
-			out[cur] = readSignedBits(s);
+			// Read the next value, undoing the Zig-Zag
+			int16 value = readSignedBits(s);
+			if (cur < 64)
+				out[_zigZagOrder[cur]] = value;
 			cur++;
 		}
 	}
 }
 
 int16 JPEGDecoder::readSignedBits(uint8 numBits) {
-	uint16 ret = 0;
+	if (numBits == 0)
+		return 0;
 	if (numBits > 16)
 		error("requested %d bits", numBits); //XXX
 
 	// MSB=0 for negatives, 1 for positives
-	for (int i = 0; i < numBits; i++)
-		ret = (ret << 1) + readBit();
+	int32 ret = readBits(numBits);
 
 	// Extend sign bits (PAG109)
-	if (!(ret >> (numBits - 1))) {
-		uint16 tmp = ((uint16)-1 << numBits) + 1;
-		ret = ret + tmp;
-	}
+	if (!(ret >> (numBits - 1)))
+		ret -= (1 << numBits) - 1;
+
 	return ret;
 }
 
-// TODO: optimize?
 uint8 JPEGDecoder::readHuff(uint8 table) {
-	bool foundCode = false;
-	uint8 val = 0;
-
-	uint8 cur = 0;
-	uint8 codeSize = 1;
-	uint16 code = readBit();
-	while (!foundCode) {
-		// Prepare a code of the current size
-		while (codeSize < _huff[table].sizes[cur]) {
-			code = (code << 1) + readBit();
-			codeSize++;
-		}
+	const HuffmanTable &huff = _huff[table];
 
-		// Compare the codes of the current size
-		while (!foundCode && (codeSize == _huff[table].sizes[cur])) {
-			if (code == _huff[table].codes[cur]) {
-				// Found the code
-				val = _huff[table].values[cur];
-				foundCode = true;
-			} else {
-				// Continue reading
-				cur++;
-			}
+	// Make sure the longest possible code is available
+	if (_bitsNumber < 16)
+		fillBits();
+
+	// Most codes are short enough to be found in the lookup table
+	uint16 entry = huff.lookup[(_bitsData >> (_bitsNumber - JPEG_HUFF_LOOKAHEAD)) & ((1 << JPEG_HUFF_LOOKAHEAD) - 1)];
+	if (entry) {
+		_bitsNumber -= entry >> 8;
+		return entry & 0xFF;
+	}
+
+	// Search the longer codes, size by size
+	for (uint8 size = JPEG_HUFF_LOOKAHEAD + 1; size <= 16; size++) {
+		int32 code = (_bitsData >> (_bitsNumber - size)) & ((1 << size) - 1);
+		if (code <= huff.maxCode[size]) {
+			_bitsNumber -= size;
+			return huff.values[huff.valueOffset[size] + code];
 		}
 	}
 
-	return val;
+	warning("JPEG: Invalid Huffman code");
+	_bitsNumber -= 16;
+	return 0;
+}
+
+uint16 JPEGDecoder::readBits(uint8 numBits) {
+	if (_bitsNumber < numBits)
+		fillBits();
+
+	_bitsNumber -= numBits;
+	return (_bitsData >> _bitsNumber) & ((1 << numBits) - 1);
 }
 
-uint8 JPEGDecoder::readBit() {
-	// Read a whole byte if necessary
-	if (_bitsNumber == 0) {
-		_bitsData = _stream->readByte();
-		_bitsNumber = 8;
-
-		// Detect markers
-		if (_bitsData == 0xFF) {
-			uint8 byte2 = _stream->readByte();
-
-			// A stuffed 0 validates the previous byte
-			if (byte2 != 0) {
-				if (byte2 == 0xDC) {
-					// DNL marker: Define Number of Lines
-					// TODO: terminate scan
-					warning("DNL marker detected: terminate scan");
-				} else if (byte2 >= 0xD0 && byte2 <= 0xD7) {
+void JPEGDecoder::fillBits() {
+	// Read whole bytes until at least 25 bits are available
+	while (_bitsNumber <= 24) {
+		uint8 data = 0;
+
+		if (!_bitsEnd) {
+			data = _stream->readByte();
+
+			if (_stream->eos()) {
+				_bitsEnd = true;
+				data = 0;
+			} else if (data == 0xFF) {
+				// Detect markers
+				uint8 byte2 = _stream->readByte();
+
+				// A stuffed 0 validates the previous byte
+				if (byte2 >= 0xD0 && byte2 <= 0xD7) {
+					// The restart itself is handled by readSOS()
 					debug(7, "RST%d marker detected", byte2 & 7);
-					_bitsData = _stream->readByte();
-				} else {
-					warning("Error: marker 0x%02X read in entropy data", byte2);
+					continue;
+				} else if (byte2 != 0) {
+					// Any other marker ends the entropy coded data. Leave it
+					// to loadStream(), and use zero bits from now on.
+					debug(7, "Marker 0x%02X found in entropy data", byte2);
+					_stream->seek(-2, SEEK_CUR);
+					_bitsEnd = true;
+					data = 0;
 				}
 			}
 		}
-	}
-	_bitsNumber--;
 
-	return (_bitsData & (1 << _bitsNumber)) ? 1 : 0;
+		_bitsData = (_bitsData << 8) | data;
+		_bitsNumber += 8;
+	}
 }
 
 const Surface *JPEGDecoder::getComponent(uint c) const {
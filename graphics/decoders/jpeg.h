@@ -30,6 +30,7 @@
 #ifndef GRAPHICS_JPEG_H
 #define GRAPHICS_JPEG_H
 
+#include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/decoders/image_decoder.h"
 
@@ -39,10 +40,9 @@ class SeekableReadStream;
 
 namespace Graphics {
 
-struct PixelFormat;
-
 #define JPEG_MAX_QUANT_TABLES 4
 #define JPEG_MAX_HUFF_TABLES 2
+#define JPEG_HUFF_LOOKAHEAD 9
 
 class JPEGDecoder : public ImageDecoder {
 public:
@@ -59,6 +59,13 @@ public:
 	uint16 getHeight() const { return _h; }
 	const Surface *getComponent(uint c) const;
 
+	/**
+	 * Set the pixel format of the surface returned by getSurface(). The
+	 * color conversion writes this format directly, so callers do not have
+	 * to convert the surface again. The default is RGBA8888.
+	 */
+	void setOutputPixelFormat(const PixelFormat &format) { _outputFormat = format; }
+
 private:
 	Common::SeekableReadStream *_stream;
 	uint16 _w, _h;
@@ -68,6 +75,7 @@ private:
 	// a getSurface() call while still upholding the
 	// const requirement in other ImageDecoders
 	mutable Graphics::Surface *_rgbSurface;
+	PixelFormat _outputFormat;
 
 	// Image components
 	uint8 _numComp;
@@ -98,8 +106,8 @@ private:
 	uint8 _maxFactorV;
 	uint8 _maxFactorH;
 
-	// Quantization tables
-	uint16 *_quant[JPEG_MAX_QUANT_TABLES];
+	// Quantization tables, in natural order and prescaled for the IDCT
+	int32 *_quant[JPEG_MAX_QUANT_TABLES];
 
 	// Huffman tables
 	struct HuffmanTable {
@@ -107,6 +115,16 @@ private:
 		uint8 *values;
 		uint8 *sizes;
 		uint16 *codes;
+
+		// Size and value of the codes of up to JPEG_HUFF_LOOKAHEAD bits,
+		// indexed by the next JPEG_HUFF_LOOKAHEAD bits of the stream. The
+		// size is stored in the high byte, 0 means a longer code follows.
+		uint16 lookup[1 << JPEG_HUFF_LOOKAHEAD];
+
+		// Largest code of each size (-1 if there is none), and the offset
+		// from a code of that size to the index of its value
+		int32 maxCode[17];
+		int32 valueOffset[17];
 	} _huff[2 * JPEG_MAX_HUFF_TABLES];
 
 	// Marker read functions
@@ -126,13 +144,14 @@ private:
 
 	// Huffman decoding
 	uint8 readHuff(uint8 table);
-	uint8 readBit();
-	uint8 _bitsData;
+	uint16 readBits(uint8 numBits);
+	void fillBits();
+	uint32 _bitsData;
 	uint8 _bitsNumber;
+	bool _bitsEnd;
 
 	// Inverse Discrete Cosine Transformation
-	static void idct1D8x8(int32 src[8], int32 dest[64], int32 ps, int32 half);
-	static void idct2D8x8(int32 block[64]);
+	static void idct8x8(const int16 coefs[64], const int32 quant[64], byte *dst, int pitch);
 };
 
 } // End of Graphics namespace
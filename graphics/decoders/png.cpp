@@ -35,10 +35,31 @@
 #include "graphics/surface.h"
 
 #include "common/stream.h"
+#include "common/util.h"
 
 namespace Graphics {
 
-PNGDecoder::PNGDecoder() : _outputSurface(0), _palette(0), _paletteColorCount(0) {
+#ifdef USE_PNG
+struct PNGDecoder::RowReader {
+	png_structp pngPtr;
+	png_infop infoPtr;
+	bool started;      // Transformations are set up and rows are being read
+	bool paletted;     // The rows are decoded to CLUT8
+	bool interlaced;
+	uint16 row;        // The next row to decode
+	byte *rowBuffer;   // A row in the native format, if it needs to be converted
+	Surface image;     // The whole image, for interlaced images
+
+	RowReader() : pngPtr(0), infoPtr(0), started(false), paletted(false), interlaced(false), row(0), rowBuffer(0) {}
+};
+#endif
+
+// The format of all images which are not decoded to CLUT8
+static inline PixelFormat getRGBAFormat() {
+	return PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+}
+
+PNGDecoder::PNGDecoder() : _outputSurface(0), _palette(0), _paletteColorCount(0), _width(0), _height(0), _rowReader(0) {
 }
 
 PNGDecoder::~PNGDecoder() {
@@ -46,6 +67,7 @@ PNGDecoder::~PNGDecoder() {
 }
 
 void PNGDecoder::destroy() {
+	finishRows();
 	if (_outputSurface) {
 		_outputSurface->free();
 		delete _outputSurface;
@@ -53,6 +75,13 @@ void PNGDecoder::destroy() {
 	}
 	delete[] _palette;
 	_palette = NULL;
+	_paletteColorCount = 0;
+	_width = _height = 0;
+}
+
+PixelFormat PNGDecoder::getNativeFormat() const {
+	// Only paletted images without transparency keep their palette
+	return _palette ? PixelFormat::createFormatCLUT8() : getRGBAFormat();
 }
 
 #ifdef USE_PNG
@@ -71,8 +100,41 @@ void pngReadFromStream(png_structp pngPtr, png_bytep data, png_size_t length) {
 	Common::SeekableReadStream *stream = (Common::SeekableReadStream *)readIOptr;
 	stream->read(data, length);
 }
+
+// Convert a row of RGBA pixels to a format with 2 or 4 bytes per pixel
+template<typename PixelInt>
+static void convertRow(const byte *src, byte *dst, const PixelFormat &dstFormat, uint16 width) {
+	const PixelFormat srcFormat = getRGBAFormat();
+	const uint32 *srcPixel = (const uint32 *)src;
+	PixelInt *dstPixel = (PixelInt *)dst;
+	byte a, r, g, b;
+
+	for (uint16 x = 0; x < width; x++) {
+		srcFormat.colorToARGB(*srcPixel++, a, r, g, b);
+		*dstPixel++ = dstFormat.ARGBToColor(a, r, g, b);
+	}
+}
 #endif
 
+void PNGDecoder::finishRows() {
+#ifdef USE_PNG
+	if (!_rowReader)
+		return;
+
+	// Read additional data at the end.
+	if (_rowReader->row == _height)
+		png_read_end(_rowReader->pngPtr, NULL);
+
+	// Destroy libpng structures
+	png_destroy_read_struct(&_rowReader->pngPtr, &_rowReader->infoPtr, NULL);
+
+	delete[] _rowReader->rowBuffer;
+	_rowReader->image.free();
+	delete _rowReader;
+	_rowReader = 0;
+#endif
+}
+
 /*
  * This code is based on Broken Sword 2.5 engine
  *
@@ -83,40 +145,46 @@ void pngReadFromStream(png_structp pngPtr, png_bytep data, png_size_t length) {
  */
 
 bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
+	if (!loadHeader(stream))
+		return false;
+
+	// Decode the whole image in its native format
+	_outputSurface = new Graphics::Surface();
+	_outputSurface->create(_width, _height, getNativeFormat());
+	if (!_outputSurface->pixels) {
+		error("Could not allocate memory for output image.");
+	}
+
+	decodeRows(*_outputSurface);
+
+	// We no longer need the file stream
+	_stream = 0;
+
+	return true;
+}
+
+bool PNGDecoder::loadHeader(Common::SeekableReadStream &stream) {
 #ifdef USE_PNG
 	destroy();
 
 	_stream = &stream;
 
 	// First, check the PNG signature
-	if (_stream->readUint32BE() != MKTAG(0x89, 'P', 'N', 'G')) {
-		delete _stream;
+	if (_stream->readUint32BE() != MKTAG(0x89, 'P', 'N', 'G'))
 		return false;
-	}
-	if (_stream->readUint32BE() != MKTAG(0x0d, 0x0a, 0x1a, 0x0a)) {
-		delete _stream;
+	if (_stream->readUint32BE() != MKTAG(0x0d, 0x0a, 0x1a, 0x0a))
 		return false;
-	}
 
 	// The following is based on the guide provided in:
 	//http://www.libpng.org/pub/png/libpng-1.2.5-manual.html#section-3
 	//http://www.libpng.org/pub/png/libpng-1.4.0-manual.pdf
 	// along with the png-loading code used in the sword25-engine.
 	png_structp pngPtr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-	if (!pngPtr) {
-		delete _stream;
+	if (!pngPtr)
 		return false;
-	}
 	png_infop infoPtr = png_create_info_struct(pngPtr);
 	if (!infoPtr) {
 		png_destroy_read_struct(&pngPtr, NULL, NULL);
-		delete _stream;
-		return false;
-	}
-	png_infop endInfo = png_create_info_struct(pngPtr);
-	if (!endInfo) {
-		png_destroy_read_struct(&pngPtr, &infoPtr, NULL);
-		delete _stream;
 		return false;
 	}
 
@@ -132,15 +200,11 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	png_read_info(pngPtr, infoPtr);
 
 	// No handling for unknown chunks yet.
-	int bitDepth, colorType, width, height, interlaceType;
+	int bitDepth, colorType, interlaceType;
 	png_uint_32 w, h;
 	png_get_IHDR(pngPtr, infoPtr, &w, &h, &bitDepth, &colorType, &interlaceType, NULL, NULL);
-	width = w;
-	height = h;
-
-	// Allocate memory for the final image data.
-	// To keep memory framentation low this happens before allocating memory for temporary image data.
-	_outputSurface = new Graphics::Surface();
+	_width = w;
+	_height = h;
 
 	// Images of all color formats except PNG_COLOR_TYPE_PALETTE
 	// will be transformed into ARGB images
@@ -160,80 +224,125 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			_palette[(i * 3) + 2] = palette[i].blue;
 
 		}
-		_outputSurface->create(width, height, Graphics::PixelFormat::createFormatCLUT8());
-		png_set_packing(pngPtr);
-	} else {
-		_outputSurface->create(width, height, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
-		if (!_outputSurface->pixels) {
-			error("Could not allocate memory for output image.");
-		}
-		if (bitDepth == 16)
-			png_set_strip_16(pngPtr);
-		if (bitDepth < 8)
-			png_set_expand(pngPtr);
-		if (png_get_valid(pngPtr, infoPtr, PNG_INFO_tRNS))
-			png_set_expand(pngPtr);
-		if (colorType == PNG_COLOR_TYPE_GRAY ||
-			colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
-			png_set_gray_to_rgb(pngPtr);
-
-		// PNGs are Big-Endian:
+	}
+
+	_rowReader = new RowReader();
+	_rowReader->pngPtr = pngPtr;
+	_rowReader->infoPtr = infoPtr;
+	_rowReader->interlaced = (interlaceType != PNG_INTERLACE_NONE);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+uint PNGDecoder::decodeRows(Graphics::Surface &dst, uint maxRows) {
+#ifdef USE_PNG
+	if (!_rowReader)
+		return 0;
+
+	RowReader &reader = *_rowReader;
+	png_structp pngPtr = reader.pngPtr;
+	png_infop infoPtr = reader.infoPtr;
+
+	assert(dst.pixels && dst.w >= _width && dst.h >= _height);
+
+	if (!reader.started) {
+		// The transformations depend on the destination format
+		reader.paletted = _palette && dst.format.bytesPerPixel == 1;
+
+		if (reader.paletted) {
+			png_set_packing(pngPtr);
+		} else if (dst.format.bytesPerPixel == 2 || dst.format.bytesPerPixel == 4) {
+			int bitDepth = png_get_bit_depth(pngPtr, infoPtr);
+			int colorType = png_get_color_type(pngPtr, infoPtr);
+
+			if (bitDepth == 16)
+				png_set_strip_16(pngPtr);
+			if (bitDepth < 8 || colorType == PNG_COLOR_TYPE_PALETTE)
+				png_set_expand(pngPtr);
+			if (png_get_valid(pngPtr, infoPtr, PNG_INFO_tRNS))
+				png_set_expand(pngPtr);
+			if (colorType == PNG_COLOR_TYPE_GRAY ||
+				colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+				png_set_gray_to_rgb(pngPtr);
+
+			// PNGs are Big-Endian:
 #ifdef SCUMM_LITTLE_ENDIAN
-		png_set_bgr(pngPtr);
-		png_set_swap_alpha(pngPtr);
-		if (colorType != PNG_COLOR_TYPE_RGB_ALPHA)
-			png_set_filler(pngPtr, 0xff, PNG_FILLER_BEFORE);
+			png_set_bgr(pngPtr);
+			png_set_swap_alpha(pngPtr);
+			if (colorType != PNG_COLOR_TYPE_RGB_ALPHA)
+				png_set_filler(pngPtr, 0xff, PNG_FILLER_BEFORE);
 #else
-		if (colorType != PNG_COLOR_TYPE_RGB_ALPHA)
-			png_set_filler(pngPtr, 0xff, PNG_FILLER_AFTER);
+			if (colorType != PNG_COLOR_TYPE_RGB_ALPHA)
+				png_set_filler(pngPtr, 0xff, PNG_FILLER_AFTER);
 #endif
+		} else {
+			warning("PNGDecoder: Cannot decode to a surface with %d bytes per pixel", dst.format.bytesPerPixel);
+			return 0;
+		}
 
-	}
+		if (reader.interlaced)
+			png_set_interlace_handling(pngPtr);
 
-	// After the transformations have been registered, the image data is read again.
-	png_read_update_info(pngPtr, infoPtr);
-	png_get_IHDR(pngPtr, infoPtr, &w, &h, &bitDepth, &colorType, NULL, NULL, NULL);
-	width = w;
-	height = h;
+		// After the transformations have been registered, the image data is read again.
+		png_read_update_info(pngPtr, infoPtr);
 
-	if (interlaceType == PNG_INTERLACE_NONE) {
-		// PNGs without interlacing can simply be read row by row.
-		for (int i = 0; i < height; i++) {
-			png_read_row(pngPtr, (png_bytep)_outputSurface->getBasePtr(0, i), NULL);
-		}
-	} else {
-		// PNGs with interlacing require us to allocate an auxillary
-		// buffer with pointers to all row starts.
-
-		// Allocate row pointer buffer
-		png_bytep *rowPtr = new png_bytep[height];
-		if (!rowPtr) {
-			error("Could not allocate memory for row pointers.");
-		}
+		PixelFormat format = reader.paletted ? PixelFormat::createFormatCLUT8() : getRGBAFormat();
+
+		if (reader.interlaced) {
+			// PNGs with interlacing have to be read at once. They are read
+			// into their own surface, and only converted row by row.
+			reader.image.create(_width, _height, format);
 
-		// Initialize row pointers
-		for (int i = 0; i < height; i++)
-			rowPtr[i] = (png_bytep)_outputSurface->getBasePtr(0, i);
+			png_bytep *rowPtr = new png_bytep[_height];
+			for (int i = 0; i < _height; i++)
+				rowPtr[i] = (png_bytep)reader.image.getBasePtr(0, i);
 
-		// Read image data
-		png_read_image(pngPtr, rowPtr);
+			png_read_image(pngPtr, rowPtr);
+
+			delete[] rowPtr;
+		} else if (dst.format != format) {
+			reader.rowBuffer = new byte[_width * format.bytesPerPixel];
+		}
 
-		// Free row pointer buffer
-		delete[] rowPtr;
+		reader.started = true;
 	}
 
-	// Read additional data at the end.
-	png_read_end(pngPtr, NULL);
+	uint rows = _height - reader.row;
+	if (maxRows)
+		rows = MIN(rows, maxRows);
+
+	for (uint i = 0; i < rows; i++, reader.row++) {
+		byte *dstRow = (byte *)dst.getBasePtr(0, reader.row);
+		const byte *srcRow;
+
+		if (reader.interlaced) {
+			srcRow = (const byte *)reader.image.getBasePtr(0, reader.row);
+		} else if (!reader.rowBuffer) {
+			// The row is in the right format already
+			png_read_row(pngPtr, dstRow, NULL);
+			continue;
+		} else {
+			png_read_row(pngPtr, reader.rowBuffer, NULL);
+			srcRow = reader.rowBuffer;
+		}
 
-	// Destroy libpng structures
-	png_destroy_read_struct(&pngPtr, &infoPtr, NULL);
+		if (reader.paletted || dst.format == getRGBAFormat())
+			memcpy(dstRow, srcRow, _width * dst.format.bytesPerPixel);
+		else if (dst.format.bytesPerPixel == 2)
+			convertRow<uint16>(srcRow, dstRow, dst.format, _width);
+		else
+			convertRow<uint32>(srcRow, dstRow, dst.format, _width);
+	}
 
-	// We no longer need the file stream, thus close it here
-	_stream = 0;
+	if (reader.row == _height)
+		finishRows();
 
-	return true;
+	return rows;
 #else
-	return false;
+	return 0;
 #endif
 }
 
@@ -32,6 +32,7 @@
 
 #include "common/scummsys.h"
 #include "common/textconsole.h"
+#include "graphics/pixelformat.h"
 #include "graphics/decoders/image_decoder.h"
 
 namespace Common {
@@ -41,7 +42,6 @@ class SeekableReadStream;
 namespace Graphics {
 
 struct Surface;
-struct PixelFormat;
 
 class PNGDecoder : public ImageDecoder {
 public:
@@ -53,12 +53,50 @@ public:
 	const Graphics::Surface *getSurface() const { return _outputSurface; }
 	const byte *getPalette() const { return _palette; }
 	uint16 getPaletteColorCount() const { return _paletteColorCount; }
+
+	/**
+	 * Read the header of an image, without decoding its pixels. These can
+	 * then be decoded into a surface of the caller's choice with
+	 * decodeRows(). The stream has to stay valid until all rows have been
+	 * decoded.
+	 */
+	bool loadHeader(Common::SeekableReadStream &stream);
+
+	/**
+	 * Decode the next rows of the image whose header was read with
+	 * loadHeader() directly into dst, converting them to the format of dst.
+	 * Paletted images without transparency can be decoded into a CLUT8
+	 * surface, all other destinations need 2 or 4 bytes per pixel.
+	 * Interlaced images are decoded completely on the first call, and
+	 * converted row by row afterwards.
+	 *
+	 * @param dst     the destination surface, at least as large as the image
+	 * @param maxRows the maximum number of rows to decode, 0 for all
+	 * @return the number of rows decoded, 0 once the whole image is decoded
+	 */
+	uint decodeRows(Graphics::Surface &dst, uint maxRows = 0);
+
+	uint16 getWidth() const { return _width; }
+	uint16 getHeight() const { return _height; }
+
+	/**
+	 * Return the format decodeRows() writes without converting the pixels.
+	 */
+	Graphics::PixelFormat getNativeFormat() const;
+
 private:
 	Common::SeekableReadStream *_stream;
 	byte *_palette;
 	uint16 _paletteColorCount;
+	uint16 _width, _height;
 
 	Graphics::Surface *_outputSurface;
+
+	// libpng state while the rows of an image are decoded
+	struct RowReader;
+	RowReader *_rowReader;
+
+	void finishRows();
 };
 
 } // End of namespace Graphics
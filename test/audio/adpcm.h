@@ -0,0 +1,106 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/adpcm_intern.h"
+
+#include "common/memstream.h"
+
+class ADPCMStreamTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Build numBlocks blocks of pseudo random data, patching in a valid
+	// header at the start of every block.
+	byte *createBlocks(Audio::typesADPCM type, int channels, uint32 blockAlign, int numBlocks) {
+		byte *data = (byte *)malloc(blockAlign * numBlocks);
+		uint32 seed = 1234;
+		for (uint32 i = 0; i < blockAlign * numBlocks; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (seed >> 16) & 0xff;
+		}
+
+		for (int block = 0; block < numBlocks; block++) {
+			byte *header = data + block * blockAlign;
+			for (int i = 0; i < channels; i++) {
+				if (type == Audio::kADPCMMSIma) {
+					// Step index
+					WRITE_LE_UINT16(header + i * 4 + 2, (header[i * 4 + 2] % 89));
+				} else {
+					// Predictor and delta
+					header[i] %= 7;
+					WRITE_LE_UINT16(header + channels + i * 2, 16 + (header[channels + i * 2] & 0x7f));
+				}
+			}
+		}
+
+		return data;
+	}
+
+	// Decoding the stream in small pieces must give the same result as
+	// decoding it at once.
+	void readBufferTestTemplate(Audio::typesADPCM type, int channels, uint32 blockAlign, int numBlocks, int expectedSamples) {
+		const uint32 size = blockAlign * numBlocks;
+		byte *data = createBlocks(type, channels, blockAlign, numBlocks);
+
+		Audio::RewindableAudioStream *s = Audio::makeADPCMStream(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES, size, type, 22050, channels, blockAlign);
+
+		int16 *whole = new int16[expectedSamples + 16];
+		TS_ASSERT_EQUALS(s->readBuffer(whole, expectedSamples + 16), expectedSamples);
+		TS_ASSERT_EQUALS(s->endOfData(), true);
+
+		TS_ASSERT_EQUALS(s->rewind(), true);
+		TS_ASSERT_EQUALS(s->endOfData(), false);
+
+		int16 *pieces = new int16[expectedSamples];
+		int samples = 0;
+		while (samples < expectedSamples) {
+			int read = s->readBuffer(pieces + samples, MIN(channels * 3, expectedSamples - samples));
+			TS_ASSERT(read > 0);
+			if (read <= 0)
+				break;
+			samples += read;
+		}
+		TS_ASSERT_EQUALS(samples, expectedSamples);
+		TS_ASSERT_EQUALS(s->endOfData(), true);
+		TS_ASSERT_EQUALS(memcmp(whole, pieces, expectedSamples * sizeof(int16)), 0);
+
+		delete[] whole;
+		delete[] pieces;
+		delete s;
+		free(data);
+	}
+
+public:
+	void test_ms_ima_mono() {
+		// 4 header bytes, 8 samples per 4 data bytes
+		readBufferTestTemplate(Audio::kADPCMMSIma, 1, 256, 3, 3 * (256 - 4) * 2);
+	}
+
+	void test_ms_ima_stereo() {
+		readBufferTestTemplate(Audio::kADPCMMSIma, 2, 512, 3, 3 * (512 - 8) * 2);
+	}
+
+	void test_ms_mono() {
+		// 7 header bytes holding 2 samples, 2 samples per data byte
+		readBufferTestTemplate(Audio::kADPCMMS, 1, 256, 3, 3 * (2 + (256 - 7) * 2));
+	}
+
+	void test_ms_stereo() {
+		readBufferTestTemplate(Audio::kADPCMMS, 2, 512, 3, 3 * (4 + (512 - 14) * 2));
+	}
+
+	void test_ima_block_decode() {
+		// The low nibble is decoded first
+		const byte src[2] = { 0x07, 0x70 };
+		int16 dst[4];
+		int32 last = 0, stepIndex = 0;
+
+		Audio::Ima_ADPCMStream::decodeIMABlock(src, 2, dst, 1, last, stepIndex);
+
+		TS_ASSERT_EQUALS(dst[0], 13);
+		TS_ASSERT_EQUALS(dst[1], 15);
+		TS_ASSERT_EQUALS(dst[2], 16);
+		TS_ASSERT_EQUALS(dst[3], 40);
+		TS_ASSERT_EQUALS(last, 40);
+		TS_ASSERT_EQUALS(stepIndex, 14);
+	}
+};
@@ -0,0 +1,182 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/decoders/jpeg.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "common/memstream.h"
+#include "common/util.h"
+
+// A 23x13 baseline JPEG with 2x2 subsampled chroma and a restart interval
+// of one MCU
+static const byte jpegTestImage[] = {
+	0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+	0x00, 0x01, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x84, 0x00, 0x08, 0x05, 0x05, 0x08, 0x0C, 0x14, 0x19,
+	0x1E, 0x06, 0x06, 0x07, 0x09, 0x0D, 0x1D, 0x1E, 0x1B, 0x07, 0x06, 0x08, 0x0C, 0x14, 0x1C, 0x22,
+	0x1C, 0x07, 0x08, 0x0B, 0x0E, 0x19, 0x2B, 0x28, 0x1F, 0x09, 0x0B, 0x12, 0x1C, 0x22, 0x36, 0x33,
+	0x26, 0x0C, 0x11, 0x1B, 0x20, 0x28, 0x34, 0x38, 0x2E, 0x18, 0x20, 0x27, 0x2B, 0x33, 0x3C, 0x3C,
+	0x32, 0x24, 0x2E, 0x2F, 0x31, 0x38, 0x32, 0x33, 0x31, 0x01, 0x08, 0x09, 0x0C, 0x17, 0x31, 0x31,
+	0x31, 0x31, 0x09, 0x0A, 0x0D, 0x21, 0x31, 0x31, 0x31, 0x31, 0x0C, 0x0D, 0x1C, 0x31, 0x31, 0x31,
+	0x31, 0x31, 0x17, 0x21, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31,
+	0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31,
+	0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0xFF, 0xC0, 0x00, 0x11, 0x08, 0x00,
+	0x0D, 0x00, 0x17, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xFF, 0xC4, 0x01,
+	0xA2, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x10, 0x00,
+	0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7D, 0x01,
+	0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22,
+	0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0, 0x24,
+	0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28, 0x29,
+	0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A,
+	0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A,
+	0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A,
+	0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8,
+	0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6,
+	0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2, 0xE3,
+	0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9,
+	0xFA, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x11, 0x00,
+	0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00,
+	0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13,
+	0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15,
+	0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26, 0x27,
+	0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+	0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+	0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+	0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6,
+	0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4,
+	0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE2,
+	0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9,
+	0xFA, 0xFF, 0xDD, 0x00, 0x04, 0x00, 0x01, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11,
+	0x03, 0x11, 0x00, 0x3F, 0x00, 0xE7, 0x74, 0x7F, 0x13, 0xEA, 0xF6, 0x6C, 0xA6, 0x4B, 0x99, 0xEF,
+	0x50, 0x67, 0xCE, 0xB7, 0x9D, 0xB3, 0xE6, 0x24, 0x81, 0x73, 0x99, 0x0E, 0x4E, 0x78, 0x18, 0xFE,
+	0xE9, 0xCE, 0x3A, 0x90, 0x7B, 0x7F, 0x09, 0xF8, 0xC4, 0x5C, 0x38, 0x8F, 0x55, 0x8E, 0x08, 0xE5,
+	0x23, 0xCB, 0x8A, 0x7C, 0x71, 0x79, 0x73, 0x91, 0x8F, 0xA1, 0x23, 0x3C, 0x60, 0x86, 0x3D, 0x36,
+	0xF0, 0x08, 0x74, 0x58, 0x54, 0x0E, 0x73, 0x9E, 0x14, 0x63, 0xEE, 0x6D, 0x1F, 0xD7, 0x35, 0xC8,
+	0xDE, 0x69, 0x10, 0xAF, 0x6C, 0xE7, 0x18, 0xFF, 0x00, 0x63, 0x35, 0xD7, 0x9A, 0x53, 0x94, 0xA3,
+	0xAC, 0xA2, 0x9E, 0xC9, 0xAF, 0xEB, 0xFE, 0x1C, 0xDF, 0x21, 0xA1, 0x46, 0x7F, 0x16, 0x1E, 0x31,
+	0x7B, 0x29, 0x25, 0xEB, 0xFD, 0x3E, 0xFE, 0xA9, 0x1F, 0xFF, 0xD0, 0xD5, 0xB2, 0xF1, 0xAC, 0x17,
+	0xDB, 0x96, 0xDA, 0xCE, 0xF2, 0xCE, 0xE4, 0x62, 0xE1, 0xE3, 0xDE, 0x30, 0xB0, 0x6E, 0x20, 0x7D,
+	0x9C, 0x28, 0x19, 0x0D, 0xDF, 0x81, 0x82, 0x46, 0x49, 0xE8, 0x26, 0xF3, 0x2F, 0x7F, 0xE7, 0xEA,
+	0xEF, 0xF5, 0xAE, 0x33, 0xC4, 0x3A, 0x5C, 0x31, 0x49, 0xB4, 0x0D, 0xCA, 0x39, 0x84, 0x60, 0x0F,
+	0x2C, 0x60, 0x77, 0x1E, 0x89, 0x81, 0xC9, 0x27, 0x8F, 0xCB, 0x33, 0xEC, 0x70, 0xFF, 0x00, 0xCF,
+	0x3F, 0xD6, 0xBD, 0x9C, 0x06, 0x02, 0xA7, 0x2A, 0xF6, 0x58, 0x84, 0x93, 0xD5, 0x2B, 0x5F, 0xF3,
+	0x67, 0x81, 0x99, 0xD2, 0xBC, 0xE4, 0xE8, 0xE2, 0xEA, 0x45, 0x5F, 0x92, 0x31, 0xD7, 0xDD, 0xB6,
+	0xEB, 0x47, 0xAE, 0xB7, 0xD4, 0xFF, 0xD9
+};
+
+// The components of the image, as decoded by the original decoder
+static const byte jpegTestComponents[3][23 * 13] = {
+	{
+		0xB2, 0xA8, 0xB2, 0xA9, 0xAF, 0xB1, 0xB1, 0xB9, 0xC1, 0xB5, 0xB3, 0xA9, 0xB5, 0xBB, 0xA8, 0xAB,
+		0xAC, 0xB4, 0xC2, 0xB8, 0xBF, 0xBF, 0xC7, 0x19, 0x24, 0x35, 0xDE, 0x1C, 0xC8, 0xDA, 0xB4, 0xC4,
+		0xB8, 0xB7, 0xC5, 0xD7, 0xBE, 0xBD, 0xCD, 0xDD, 0xDB, 0xB4, 0x85, 0xCE, 0x89, 0x89, 0x1A, 0x40,
+		0x28, 0x30, 0x34, 0x40, 0xBE, 0xCF, 0x4B, 0xDA, 0xBD, 0xB5, 0xC5, 0xD9, 0xCE, 0xB7, 0xD6, 0xC2,
+		0x84, 0xDD, 0xCF, 0x92, 0x8E, 0x35, 0x3B, 0x47, 0x1E, 0x47, 0x4E, 0x43, 0xBE, 0x4C, 0x35, 0xBD,
+		0xCD, 0x4B, 0xD6, 0xDD, 0xB7, 0xDC, 0xD4, 0xEF, 0xCF, 0xDE, 0xE6, 0x7F, 0x44, 0x3B, 0x4A, 0x58,
+		0x4B, 0x1E, 0x36, 0x37, 0x49, 0x55, 0x40, 0x4E, 0xC5, 0xD5, 0xB3, 0xC9, 0x56, 0x44, 0x9D, 0xE8,
+		0x88, 0x8A, 0x9E, 0x3E, 0x52, 0x3D, 0x4D, 0x2C, 0x48, 0x38, 0x3E, 0x60, 0x5F, 0x3A, 0x59, 0x32,
+		0xCC, 0xD7, 0xD9, 0x48, 0x16, 0x5D, 0x1A, 0xA0, 0x8C, 0xA5, 0x43, 0x76, 0x47, 0x5E, 0x52, 0x4A,
+		0x54, 0x35, 0x61, 0x5A, 0x5C, 0x45, 0x50, 0x4F, 0xD0, 0xC8, 0x56, 0x59, 0x24, 0x12, 0x96, 0xA0,
+		0x94, 0x64, 0x51, 0x58, 0x55, 0x49, 0x5D, 0x48, 0x54, 0x66, 0x63, 0x56, 0x52, 0x57, 0x47, 0x51,
+		0xE5, 0x5C, 0x64, 0x61, 0x20, 0x1C, 0xB8, 0x98, 0x68, 0x74, 0x7E, 0x73, 0x81, 0x6F, 0x7A, 0x76,
+		0x51, 0x52, 0x4C, 0x49, 0x4B, 0x48, 0x43, 0x44, 0x36, 0x77, 0x33, 0x7D, 0x38, 0x37, 0x3D, 0x78,
+		0x82, 0x82, 0x79, 0x90, 0x82, 0x86, 0x82, 0x5C, 0x59, 0x4F, 0x4F, 0x58, 0x57, 0x4D, 0x4A, 0x59,
+		0x80, 0x8A, 0x71, 0x50, 0x39, 0x4D, 0x84, 0x8B, 0x82, 0x7F, 0x98, 0x8F, 0x8D, 0x89, 0x6B, 0x66,
+		0x59, 0x59, 0x67, 0x67, 0x5A, 0x55, 0x99, 0x50, 0x4D, 0x46, 0x5D, 0x68, 0x50, 0x91, 0x97, 0x91,
+		0x92, 0x9D, 0x97, 0x96, 0x92, 0x76, 0x75, 0x6A, 0x66, 0x71, 0x6D, 0x62, 0x61, 0x96, 0x67, 0x95,
+		0x47, 0x68, 0x55, 0x63, 0x9F, 0xA7, 0xAB, 0xB2, 0xA3, 0x9D, 0xA3, 0xA0, 0x7A, 0x83, 0x7B, 0x72,
+		0x73, 0x69, 0x62, 0x6B, 0xBE, 0xAE, 0x74, 0x70, 0x4A, 0x72, 0x51
+	}, {
+		0xB2, 0xB2, 0xA9, 0xA9, 0xA8, 0xA8, 0x98, 0x98, 0x78, 0x78, 0x70, 0x70, 0x6F, 0x6F, 0x5D, 0x5D,
+		0x55, 0x55, 0x68, 0x68, 0x8A, 0x8A, 0xAC, 0xB2, 0xB2, 0xA9, 0xA9, 0xA8, 0xA8, 0x98, 0x98, 0x78,
+		0x78, 0x70, 0x70, 0x6F, 0x6F, 0x5D, 0x5D, 0x55, 0x55, 0x68, 0x68, 0x8A, 0x8A, 0xAC, 0xB1, 0xB1,
+		0xC7, 0xC7, 0xB3, 0xB3, 0x98, 0x98, 0x92, 0x92, 0x6F, 0x6F, 0x45, 0x45, 0x44, 0x44, 0x45, 0x45,
+		0x54, 0x54, 0x72, 0x72, 0x92, 0xB1, 0xB1, 0xC7, 0xC7, 0xB3, 0xB3, 0x98, 0x98, 0x92, 0x92, 0x6F,
+		0x6F, 0x45, 0x45, 0x44, 0x44, 0x45, 0x45, 0x54, 0x54, 0x72, 0x72, 0x92, 0xA6, 0xA6, 0xAA, 0xAA,
+		0xB0, 0xB0, 0xAA, 0xAA, 0x8F, 0x8F, 0x6E, 0x6E, 0x49, 0x49, 0x29, 0x29, 0x78, 0x78, 0x79, 0x79,
+		0x7D, 0x7D, 0x82, 0xA6, 0xA6, 0xAA, 0xAA, 0xB0, 0xB0, 0xAA, 0xAA, 0x8F, 0x8F, 0x6E, 0x6E, 0x49,
+		0x49, 0x29, 0x29, 0x78, 0x78, 0x79, 0x79, 0x7D, 0x7D, 0x82, 0x84, 0x84, 0x7F, 0x7F, 0x99, 0x99,
+		0xA7, 0xA7, 0x8D, 0x8D, 0x79, 0x79, 0x62, 0x62, 0x38, 0x38, 0x63, 0x63, 0x67, 0x67, 0x6C, 0x6C,
+		0x6E, 0x84, 0x84, 0x7F, 0x7F, 0x99, 0x99, 0xA7, 0xA7, 0x8D, 0x8D, 0x79, 0x79, 0x62, 0x62, 0x38,
+		0x38, 0x63, 0x63, 0x67, 0x67, 0x6C, 0x6C, 0x6E, 0x76, 0x76, 0x8D, 0x8D, 0x8E, 0x8E, 0x93, 0x93,
+		0xA3, 0xA3, 0x8B, 0x8B, 0x67, 0x67, 0x65, 0x65, 0x76, 0x76, 0x89, 0x89, 0xA0, 0xA0, 0xAD, 0x76,
+		0x76, 0x8D, 0x8D, 0x8E, 0x8E, 0x93, 0x93, 0xA3, 0xA3, 0x8B, 0x8B, 0x67, 0x67, 0x65, 0x65, 0x76,
+		0x76, 0x89, 0x89, 0xA0, 0xA0, 0xAD, 0x98, 0x98, 0x9D, 0x9D, 0xA0, 0xA0, 0xA3, 0xA3, 0xA2, 0xA2,
+		0x90, 0x90, 0x7B, 0x7B, 0x75, 0x75, 0x7D, 0x7D, 0x9B, 0x9B, 0xBB, 0xBB, 0xC3, 0x98, 0x98, 0x9D,
+		0x9D, 0xA0, 0xA0, 0xA3, 0xA3, 0xA2, 0xA2, 0x90, 0x90, 0x7B, 0x7B, 0x75, 0x75, 0x7D, 0x7D, 0x9B,
+		0x9B, 0xBB, 0xBB, 0xC3, 0xA9, 0xA9, 0x98, 0x98, 0xAA, 0xAA, 0xB4, 0xB4, 0x97, 0x97, 0x8D, 0x8D,
+		0x8E, 0x8E, 0x78, 0x78, 0x76, 0x76, 0x9F, 0x9F, 0xC9, 0xC9, 0xD4
+	}, {
+		0x4B, 0x4B, 0x2F, 0x2F, 0x3F, 0x3F, 0x40, 0x40, 0x2A, 0x2A, 0x59, 0x59, 0x7B, 0x7B, 0x7B, 0x7B,
+		0x96, 0x96, 0x72, 0x72, 0x81, 0x81, 0x4F, 0x4B, 0x4B, 0x2F, 0x2F, 0x3F, 0x3F, 0x40, 0x40, 0x2A,
+		0x2A, 0x59, 0x59, 0x7B, 0x7B, 0x7B, 0x7B, 0x96, 0x96, 0x72, 0x72, 0x81, 0x81, 0x4F, 0x72, 0x72,
+		0x8D, 0x8D, 0x8C, 0x8C, 0x50, 0x50, 0xB1, 0xB1, 0x61, 0x61, 0x8D, 0x8D, 0x85, 0x85, 0x90, 0x90,
+		0x7B, 0x7B, 0x58, 0x58, 0x17, 0x72, 0x72, 0x8D, 0x8D, 0x8C, 0x8C, 0x50, 0x50, 0xB1, 0xB1, 0x61,
+		0x61, 0x8D, 0x8D, 0x85, 0x85, 0x90, 0x90, 0x7B, 0x7B, 0x58, 0x58, 0x17, 0x82, 0x82, 0x8C, 0x8C,
+		0xA1, 0xA1, 0xA1, 0xA1, 0xA5, 0xA5, 0xB3, 0xB3, 0x82, 0x82, 0x91, 0x91, 0xCE, 0xCE, 0x8A, 0x8A,
+		0x1F, 0x1F, 0x22, 0x82, 0x82, 0x8C, 0x8C, 0xA1, 0xA1, 0xA1, 0xA1, 0xA5, 0xA5, 0xB3, 0xB3, 0x82,
+		0x82, 0x91, 0x91, 0xCE, 0xCE, 0x8A, 0x8A, 0x1F, 0x1F, 0x22, 0x66, 0x66, 0x5C, 0x5C, 0x86, 0x86,
+		0xAD, 0xAD, 0xA9, 0xA9, 0xB1, 0xB1, 0xCF, 0xCF, 0xA2, 0xA2, 0xD9, 0xD9, 0x97, 0x97, 0x0F, 0x0F,
+		0x2D, 0x66, 0x66, 0x5C, 0x5C, 0x86, 0x86, 0xAD, 0xAD, 0xA9, 0xA9, 0xB1, 0xB1, 0xCF, 0xCF, 0xA2,
+		0xA2, 0xD9, 0xD9, 0x97, 0x97, 0x0F, 0x0F, 0x2D, 0x53, 0x53, 0x53, 0x53, 0x7F, 0x7F, 0x79, 0x79,
+		0xCB, 0xCB, 0xB4, 0xB4, 0xEB, 0xEB, 0xDD, 0xDD, 0xAB, 0xAB, 0xBF, 0xBF, 0x6B, 0x6B, 0x67, 0x53,
+		0x53, 0x53, 0x53, 0x7F, 0x7F, 0x79, 0x79, 0xCB, 0xCB, 0xB4, 0xB4, 0xEB, 0xEB, 0xDD, 0xDD, 0xAB,
+		0xAB, 0xBF, 0xBF, 0x6B, 0x6B, 0x67, 0x4D, 0x4D, 0x52, 0x52, 0x67, 0x67, 0x6B, 0x6B, 0x9D, 0x9D,
+		0xC4, 0xC4, 0xBD, 0xBD, 0xEF, 0xEF, 0x82, 0x82, 0x7D, 0x7D, 0x64, 0x64, 0x6F, 0x4D, 0x4D, 0x52,
+		0x52, 0x67, 0x67, 0x6B, 0x6B, 0x9D, 0x9D, 0xC4, 0xC4, 0xBD, 0xBD, 0xEF, 0xEF, 0x82, 0x82, 0x7D,
+		0x7D, 0x64, 0x64, 0x6F, 0x43, 0x43, 0x4B, 0x4B, 0x54, 0x54, 0x6F, 0x6F, 0x93, 0x93, 0x92, 0x92,
+		0xD0, 0xD0, 0xCA, 0xCA, 0xB4, 0xB4, 0x4E, 0x4E, 0x4E, 0x4E, 0x6B
+	}
+};
+
+class JPEGDecoderTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_components() {
+		Common::MemoryReadStream stream(jpegTestImage, sizeof(jpegTestImage));
+		Graphics::JPEGDecoder jpeg;
+
+		TS_ASSERT_EQUALS(jpeg.loadStream(stream), true);
+		TS_ASSERT_EQUALS(jpeg.getWidth(), 23);
+		TS_ASSERT_EQUALS(jpeg.getHeight(), 13);
+
+		// The IDCT may round differently than the original one, but must
+		// not be off by more than that
+		for (int c = 0; c < 3; c++) {
+			const Graphics::Surface *component = jpeg.getComponent(c + 1);
+			int maxDiff = 0;
+
+			for (int y = 0; y < 13; y++)
+				for (int x = 0; x < 23; x++)
+					maxDiff = MAX<int>(maxDiff, ABS(*(const byte *)component->getBasePtr(x, y) - jpegTestComponents[c][y * 23 + x]));
+
+			TS_ASSERT_LESS_THAN_EQUALS(maxDiff, 2);
+		}
+	}
+
+	void test_output_format() {
+		Common::MemoryReadStream stream(jpegTestImage, sizeof(jpegTestImage));
+		Graphics::JPEGDecoder jpeg;
+		Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		jpeg.setOutputPixelFormat(format);
+		TS_ASSERT_EQUALS(jpeg.loadStream(stream), true);
+
+		const Graphics::Surface *surface = jpeg.getSurface();
+		TS_ASSERT(surface->format == format);
+
+		// The surface must match a conversion of the components
+		const Graphics::Surface *y = jpeg.getComponent(1);
+		const Graphics::Surface *u = jpeg.getComponent(2);
+		const Graphics::Surface *v = jpeg.getComponent(3);
+
+		Graphics::Surface expected;
+		expected.create(23, 13, format);
+		Graphics::convertYUV444ToRGB(&expected, (const byte *)y->pixels, (const byte *)u->pixels, (const byte *)v->pixels, y->w, y->h, y->pitch, u->pitch);
+
+		for (int i = 0; i < 13; i++)
+			TS_ASSERT_EQUALS(memcmp(surface->getBasePtr(0, i), expected.getBasePtr(0, i), 23 * 2), 0);
+
+		expected.free();
+	}
+};
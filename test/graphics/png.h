@@ -0,0 +1,118 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/decoders/png.h"
+
+#include "common/memstream.h"
+
+// An interlaced 11x7 image with a 4 bit palette
+static const byte pngTestPaletted[] = {
+	0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0B, 0x00, 0x00, 0x00, 0x07, 0x04, 0x03, 0x00, 0x00, 0x01, 0x5B, 0x47, 0x9A,
+	0xF8, 0x00, 0x00, 0x00, 0x30, 0x50, 0x4C, 0x54, 0x45, 0x00, 0xFF, 0x00, 0x10, 0xF2, 0x28, 0x20,
+	0xE5, 0x50, 0x30, 0xD8, 0x78, 0x40, 0xCB, 0xA0, 0x50, 0xBE, 0xC8, 0x60, 0xB1, 0xF0, 0x70, 0xA4,
+	0x18, 0x80, 0x97, 0x40, 0x90, 0x8A, 0x68, 0xA0, 0x7D, 0x90, 0xB0, 0x70, 0xB8, 0xC0, 0x63, 0xE0,
+	0xD0, 0x56, 0x08, 0xE0, 0x49, 0x30, 0xF0, 0x3C, 0x58, 0x83, 0xFD, 0x16, 0xDF, 0x00, 0x00, 0x00,
+	0x43, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9C, 0x63, 0xE0, 0x60, 0x38, 0xC0, 0xE0, 0x70, 0x80, 0x21,
+	0xE9, 0x01, 0xC3, 0x32, 0x05, 0x06, 0x8D, 0x27, 0x0B, 0x18, 0x72, 0x34, 0x9E, 0x30, 0x58, 0x7E,
+	0xDD, 0xC0, 0x10, 0x2D, 0x7E, 0x81, 0xA1, 0xD6, 0xF2, 0x03, 0xC3, 0xFC, 0x68, 0x01, 0x06, 0x91,
+	0xAA, 0x0B, 0x66, 0x73, 0x3E, 0x30, 0x98, 0xCD, 0xF9, 0x14, 0xB1, 0x4F, 0x80, 0x21, 0x62, 0x1F,
+	0x90, 0x6F, 0x00, 0x00, 0x4B, 0x14, 0x15, 0x73, 0xE5, 0x6B, 0x84, 0xE6, 0x00, 0x00, 0x00, 0x00,
+	0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82
+};
+
+// A non-interlaced 11x7 RGBA image
+static const byte pngTestRGBA[] = {
+	0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x0B, 0x00, 0x00, 0x00, 0x07, 0x08, 0x06, 0x00, 0x00, 0x00, 0xDE, 0x6E, 0xB7,
+	0x5D, 0x00, 0x00, 0x01, 0x2F, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9C, 0x0D, 0xC1, 0xB9, 0x4E, 0xC3,
+	0x30, 0x00, 0x06, 0xE0, 0x9F, 0xA3, 0x0C, 0x1D, 0xE8, 0x12, 0x30, 0x65, 0xC8, 0x82, 0x2C, 0x05,
+	0x68, 0x3D, 0x74, 0x0E, 0xA7, 0x14, 0x06, 0x77, 0x29, 0xE7, 0x50, 0x65, 0x0C, 0x47, 0x59, 0x3C,
+	0x64, 0x09, 0x47, 0x59, 0x91, 0xA2, 0x72, 0xCA, 0xEA, 0xDC, 0x70, 0xAD, 0x2C, 0x05, 0x6C, 0x9E,
+	0xA0, 0x9C, 0x91, 0x78, 0x00, 0x4B, 0x2C, 0x99, 0x99, 0x99, 0xE0, 0xFB, 0x80, 0x7F, 0x04, 0xB0,
+	0x18, 0xE0, 0x78, 0x80, 0xEB, 0x03, 0xB5, 0x10, 0x08, 0x62, 0x20, 0x4A, 0x80, 0x96, 0x02, 0x3A,
+	0x29, 0xD0, 0xCD, 0x80, 0x1E, 0x40, 0xD1, 0x47, 0x68, 0x6E, 0x84, 0xD1, 0xFC, 0xA4, 0x47, 0x0B,
+	0x33, 0x3E, 0xB5, 0x96, 0x43, 0x5A, 0xDC, 0x8C, 0xA9, 0xBD, 0x97, 0xD0, 0x89, 0x13, 0x45, 0x9D,
+	0x24, 0xA5, 0xE5, 0x87, 0x8C, 0x56, 0x5E, 0x00, 0x8E, 0x7E, 0xC2, 0xF3, 0xA3, 0x8C, 0x5B, 0x53,
+	0x1E, 0xB7, 0x67, 0x7D, 0xEE, 0xAC, 0x84, 0xBC, 0xB2, 0x15, 0x73, 0x77, 0x3F, 0xE1, 0x4B, 0xA7,
+	0x8A, 0xD7, 0xAE, 0x52, 0x5E, 0x7F, 0xCC, 0x78, 0xF0, 0x0A, 0x08, 0x0C, 0x10, 0x51, 0x20, 0x4C,
+	0xD8, 0xD3, 0x9E, 0x28, 0xCF, 0xF9, 0xC2, 0x5D, 0x0D, 0x45, 0x75, 0x3B, 0x16, 0xF5, 0x83, 0x44,
+	0x34, 0xCE, 0x94, 0x88, 0xAE, 0x53, 0x71, 0xFC, 0x94, 0x89, 0xF6, 0x1B, 0x20, 0x31, 0x48, 0xA4,
+	0x35, 0xC6, 0xA4, 0x53, 0xF2, 0xA4, 0x3B, 0xEF, 0xCB, 0xDA, 0x5A, 0x28, 0x83, 0x9D, 0x58, 0x46,
+	0x87, 0x89, 0x6C, 0x9D, 0x2B, 0xD9, 0xB9, 0x49, 0x65, 0x57, 0x65, 0xB2, 0xF7, 0x0E, 0x68, 0xE4,
+	0x88, 0x2E, 0x16, 0x99, 0xAE, 0x94, 0x3D, 0x5D, 0x5D, 0xF0, 0x75, 0xB0, 0x1E, 0xEA, 0x66, 0x23,
+	0xD6, 0xED, 0x66, 0xA2, 0xEF, 0x2F, 0x94, 0xEE, 0xDD, 0xA6, 0xFA, 0x5B, 0x67, 0xFA, 0xF7, 0x03,
+	0x30, 0x18, 0x22, 0xC6, 0x1E, 0x67, 0xC6, 0x65, 0x9E, 0xA9, 0x2F, 0xFA, 0x26, 0xDA, 0x08, 0x4D,
+	0x7B, 0x37, 0x36, 0xDD, 0xA3, 0xC4, 0x7C, 0x5D, 0x2A, 0xF3, 0x73, 0x97, 0x9A, 0xE1, 0xE7, 0xCC,
+	0x94, 0x3E, 0xFF, 0x00, 0xBD, 0x7F, 0x77, 0x85, 0x86, 0x4A, 0xCE, 0xBD, 0x00, 0x00, 0x00, 0x00,
+	0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82
+};
+
+class PNGDecoderTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Decoding the rows in pieces into a surface of the given format must
+	// give the same result as converting the fully decoded image.
+	void decodeRowsTestTemplate(const byte *data, uint32 size, const Graphics::PixelFormat &format) {
+		Common::MemoryReadStream stream(data, size);
+		Graphics::PNGDecoder png;
+		TS_ASSERT_EQUALS(png.loadStream(stream), true);
+
+		const Graphics::Surface *surface = png.getSurface();
+		Graphics::Surface *expected = surface->convertTo(format, png.getPalette());
+
+		Common::MemoryReadStream rowStream(data, size);
+		Graphics::PNGDecoder rowPNG;
+		TS_ASSERT_EQUALS(rowPNG.loadHeader(rowStream), true);
+		TS_ASSERT_EQUALS(rowPNG.getWidth(), 11);
+		TS_ASSERT_EQUALS(rowPNG.getHeight(), 7);
+
+		Graphics::Surface dst;
+		dst.create(rowPNG.getWidth(), rowPNG.getHeight(), format);
+
+		TS_ASSERT_EQUALS(rowPNG.decodeRows(dst, 3), 3u);
+		TS_ASSERT_EQUALS(rowPNG.decodeRows(dst, 3), 3u);
+		TS_ASSERT_EQUALS(rowPNG.decodeRows(dst, 3), 1u);
+		TS_ASSERT_EQUALS(rowPNG.decodeRows(dst, 3), 0u);
+
+		for (int y = 0; y < dst.h; y++)
+			TS_ASSERT_EQUALS(memcmp(dst.getBasePtr(0, y), expected->getBasePtr(0, y), dst.w * format.bytesPerPixel), 0);
+
+		dst.free();
+		expected->free();
+		delete expected;
+	}
+
+public:
+	void test_paletted_rows() {
+		decodeRowsTestTemplate(pngTestPaletted, sizeof(pngTestPaletted), Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+		decodeRowsTestTemplate(pngTestPaletted, sizeof(pngTestPaletted), Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+
+	void test_paletted_clut8_rows() {
+		Common::MemoryReadStream stream(pngTestPaletted, sizeof(pngTestPaletted));
+		Graphics::PNGDecoder png;
+		TS_ASSERT_EQUALS(png.loadStream(stream), true);
+
+		Common::MemoryReadStream rowStream(pngTestPaletted, sizeof(pngTestPaletted));
+		Graphics::PNGDecoder rowPNG;
+		TS_ASSERT_EQUALS(rowPNG.loadHeader(rowStream), true);
+		TS_ASSERT(rowPNG.getNativeFormat() == Graphics::PixelFormat::createFormatCLUT8());
+		TS_ASSERT_EQUALS(rowPNG.getPaletteColorCount(), 16);
+
+		Graphics::Surface dst;
+		dst.create(rowPNG.getWidth(), rowPNG.getHeight(), Graphics::PixelFormat::createFormatCLUT8());
+		TS_ASSERT_EQUALS(rowPNG.decodeRows(dst), 7u);
+
+		for (int y = 0; y < dst.h; y++)
+			TS_ASSERT_EQUALS(memcmp(dst.getBasePtr(0, y), png.getSurface()->getBasePtr(0, y), dst.w), 0);
+
+		dst.free();
+	}
+
+	void test_rgba_rows() {
+		decodeRowsTestTemplate(pngTestRGBA, sizeof(pngTestRGBA), Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+		decodeRowsTestTemplate(pngTestRGBA, sizeof(pngTestRGBA), Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		decodeRowsTestTemplate(pngTestRGBA, sizeof(pngTestRGBA), Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+	}
+};
@@ -31,6 +31,7 @@ class SeekableReadStream;
 }
 
 namespace Graphics {
+class JPEGDecoder;
 struct Surface;
 }
 
@@ -50,7 +51,7 @@ public:
 
 private:
 	Graphics::PixelFormat _pixelFormat;
-	Graphics::Surface *_surface;
+	Graphics::JPEGDecoder *_jpeg;
 };
 
 } // End of namespace Video